@@ -0,0 +1,51 @@
+//
+//  BenchSupport.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_BenchSupport_h
+#define CameraCore_BenchSupport_h
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+/// Benchmarks run a short smoke pass with --quick, it is what ctest runs
+inline bool isQuickRun(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Keep the optimizer from removing the measured work
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ Run fn iterations times and print the time per iteration
+
+ @return Nanoseconds per iteration
+ */
+template <typename Fn>
+double measure(const char *name, long iterations, Fn &&fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) {
+        fn(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / double(iterations);
+    std::printf("%-40s %10.2f ns/op\n", name, ns);
+    return ns;
+}
+
+#endif /* CameraCore_BenchSupport_h */
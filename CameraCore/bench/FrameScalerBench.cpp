@@ -0,0 +1,52 @@
+//
+//  FrameScalerBench.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Cost of turning a decoded 1080p NV12 frame into the RGBA picture of a grid tile: full size conversion
+//  followed by downscaleBox, against the fused FrameScaler pass.
+//
+
+#include <vector>
+
+#include "BenchSupport.h"
+#include "CameraCore/FrameScaler.h"
+
+using namespace cam;
+
+int main(int argc, char **argv)
+{
+    long iterations = isQuickRun(argc, argv) ? 5 : 500;
+
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> y(size_t(width) * height, 0x80);
+    std::vector<uint8_t> uv(size_t(width) * height / 2, 0x60);
+    for (size_t i = 0; i < y.size(); i++) {
+        y[i] = uint8_t(i * 7);
+    }
+    Nv12Picture picture{width, height, y.data(), size_t(width), uv.data(), size_t(width), false};
+
+    FrameScaler scaler;
+    Image full;
+    Image tile;
+    double fullSize = measure("1080p NV12 to RGBA", iterations, [&](long) {
+        scaler.convertTo(picture, width, height, full);
+        doNotOptimize(full.rgba.data());
+    });
+    double separate = measure("1080p to RGBA, downscaleBox 480x270", iterations, [&](long) {
+        scaler.convertTo(picture, width, height, full);
+        downscaleBox(full, 480, 270, tile);
+        doNotOptimize(tile.rgba.data());
+    });
+    double fused = measure("1080p to 480x270 fused", iterations, [&](long) {
+        scaler.convertTo(picture, 480, 270, tile);
+        doNotOptimize(tile.rgba.data());
+    });
+    // 16 tiles at 30 fps
+    std::printf("16 camera wall at 30 fps: full size %.2f cores, separate %.2f cores, fused %.2f cores\n", fullSize * 16 * 30 / 1e9,
+                separate * 16 * 30 / 1e9, fused * 16 * 30 / 1e9);
+    return 0;
+}
@@ -0,0 +1,78 @@
+//
+//  IoctrlCodecBench.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <vector>
+
+#include "BenchSupport.h"
+#include "CameraCore/IoctrlMessages.h"
+#include "CameraCore/IoctrlReassembler.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+int main(int argc, char **argv)
+{
+    long iterations = isQuickRun(argc, argv) ? 10000 : 10000000;
+
+    SMsgAVIoctrlPlayRecord request{0, AVIOCTRL_RECORD_PLAY_SEEKTIME, 0, STimeDay{2026, 10, 19, 1, 12, 30, 5}};
+    measure("PlayRecord encode", iterations, [&](long i) {
+        request.param = uint32_t(i);
+        auto bytes = PlayRecord::encodeRequest(request);
+        doNotOptimize(bytes);
+    });
+
+    auto encoded = PlayRecord::encodeRequest(request);
+    measure("PlayRecord decode", iterations, [&](long i) {
+        encoded[8] = uint8_t(i);
+        SMsgAVIoctrlPlayRecord decoded;
+        SMsgAVIoctrlPlayRecordCodec::decode(ConstByteSpan{encoded.data(), encoded.size()}, decoded);
+        doNotOptimize(decoded);
+    });
+
+    SMsgAVIoctrlTimeZone timeZone{268, 1, 480, "%2B08%3A00"};
+    measure("TimeZone encode (268 bytes)", iterations / 10, [&](long i) {
+        timeZone.gmtDiff = int32_t(i);
+        auto bytes = SetTimeZone::encodeRequest(timeZone);
+        doNotOptimize(bytes);
+    });
+
+    // A full event list reply: 12 byte header and 80 events
+    std::vector<uint8_t> list(SMsgAVIoctrlListEventRespCodec::size + 80 * SAvEventCodec::size);
+    SMsgAVIoctrlListEventRespCodec::store(list.data(), SMsgAVIoctrlListEventResp{0, 1, 0, 1, 80});
+    for (size_t i = 0; i < 80; i++) {
+        SAvEventCodec::store(list.data() + 12 + i * SAvEventCodec::size, SAvEvent{STimeDay{2026, 1, 2, 5, 3, 4, 5}, 1, 0});
+    }
+    measure("ListEvent decode (80 events)", iterations / 10, [&](long) {
+        SMsgAVIoctrlListEventResp header;
+        ListEvent::decodeResponse(ConstByteSpan{list.data(), list.size()}, header);
+        unsigned sum = 0;
+        decodeElements<SAvEventCodec>(ConstByteSpan{list.data(), list.size()}, 12, header.count,
+                                      [&](size_t, const SAvEvent &e) { sum += e.event; });
+        doNotOptimize(sum);
+    });
+
+    // A 4 KB Json reply in 1016 byte packages
+    std::vector<std::vector<uint8_t>> packages;
+    const uint32_t total = 4096;
+    for (uint32_t offset = 0, index = 0; offset < total; index++) {
+        uint16_t count = uint16_t(std::min<uint32_t>(1016, total - offset));
+        std::vector<uint8_t> p(8 + count, 'x');
+        DataPackageHeaderCodec::store(p.data(), DataPackageHeader{total, uint8_t(index), uint8_t(offset + count == total), count});
+        packages.push_back(p);
+        offset += count;
+    }
+    IoctrlReassembler reassembler;
+    measure("Reassemble 4 KB reply", iterations / 10, [&](long) {
+        int result = 0;
+        for (auto &p : packages) {
+            result = reassembler.add(ConstByteSpan{p.data(), p.size()});
+        }
+        doNotOptimize(result);
+    });
+    return 0;
+}
@@ -0,0 +1,224 @@
+//
+//  RecordWriterBench.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Many cameras recorded at once: RecordWriter against one FILE* and fwrite per frame per stream.
+//  Each stream is fed by a producer thread at its frame rate, the bench reports throughput, drops,
+//  write and system call counts and CPU time of each writer.
+//  Usage: RecordWriterBench [--quick] [--streams N] [--seconds S] [--kbps K] [--dir D]
+//
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchSupport.h"
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/FrameFile.h"
+#include "CameraCore/KeyframeIndex.h"
+#include "CameraCore/RecordWriter.h"
+
+using namespace cam;
+
+namespace {
+
+struct Load
+{
+    int streams = 128;
+    double seconds = 10;
+    int fps = 30;
+    int gop = 30;
+    int kbps = 4000;
+    std::string dir = "/tmp";
+};
+
+struct Result
+{
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t dropped = 0;
+    uint64_t writes = 0;
+    uint64_t syscalls = 0;
+    double wall = 0;
+    double cpu = 0;
+};
+
+std::string streamPath(const Load &load, const char *writer, int stream)
+{
+    return load.dir + "/camcore-bench-" + std::to_string(getpid()) + "-" + writer + "-" + std::to_string(stream) + ".camf";
+}
+
+/// Keyframes are 8x the size of P frames, the average matches kbps
+uint32_t frameSize(const Load &load, uint32_t frameNumber)
+{
+    double average = double(load.kbps) * 1000 / 8 / load.fps;
+    double pFrame = average * load.gop / (load.gop + 7);
+    return uint32_t(frameNumber % uint32_t(load.gop) == 0 ? pFrame * 8 : pFrame);
+}
+
+/// Produce the frames of every stream at the frame rate, write(stream, info, data) stores one
+template <typename Write>
+Result produce(const Load &load, Write &&write)
+{
+    std::atomic<uint64_t> frames{0}, bytes{0};
+    std::vector<uint8_t> data(frameSize(load, 0), 0x5A);
+    uint64_t interval = 1000000 / uint64_t(load.fps);
+    uint32_t count = uint32_t(load.seconds * load.fps);
+
+    std::clock_t cpuStart = std::clock();
+    uint64_t start = monotonicMicros();
+    std::vector<std::thread> threads;
+    for (int stream = 0; stream < load.streams; stream++) {
+        threads.emplace_back([&, stream] {
+            // Spread the streams over one frame interval like unsynchronized cameras
+            uint64_t due = start + interval * uint64_t(stream) / uint64_t(load.streams);
+            for (uint32_t i = 0; i < count; i++, due += interval) {
+                uint64_t now = monotonicMicros();
+                if (due > now) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+                }
+                FrameInfo info;
+                info.codecId = 78;
+                info.flags = i % uint32_t(load.gop) == 0 ? kFrameFlagKeyframe : 0;
+                info.timestamp = i * 1000 / uint32_t(load.fps);
+                info.frameNumber = i;
+                uint32_t size = frameSize(load, i);
+                if (write(stream, info, ConstByteSpan{data.data(), size})) {
+                    frames.fetch_add(1, std::memory_order_relaxed);
+                    bytes.fetch_add(size, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    Result result;
+    result.frames = frames;
+    result.bytes = bytes;
+    result.wall = double(monotonicMicros() - start) / 1e6;
+    result.cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    return result;
+}
+
+Result runRecordWriter(const Load &load, bool *ioUring)
+{
+    RecordWriter writer;
+    std::vector<int> ids;
+    for (int stream = 0; stream < load.streams; stream++) {
+        ids.push_back(writer.open(streamPath(load, "writer", stream)));
+        if (ids.back() < 0) {
+            std::printf("Can not create %s\n", streamPath(load, "writer", stream).c_str());
+            return Result();
+        }
+    }
+    Result result = produce(load, [&](int stream, const FrameInfo &info, ConstByteSpan data) {
+        return writer.write(ids[size_t(stream)], info, data) == kNoError;
+    });
+    // Closing writes the last blocks and the indexes, it is part of the cost
+    std::clock_t cpuStart = std::clock();
+    uint64_t start = monotonicMicros();
+    for (int id : ids) {
+        writer.close(id);
+    }
+    result.wall += double(monotonicMicros() - start) / 1e6;
+    result.cpu += double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    RecordWriterStats stats = writer.stats();
+    result.dropped = stats.framesDropped;
+    result.writes = stats.writes;
+    result.syscalls = stats.syscalls;
+    *ioUring = stats.ioUring;
+    return result;
+}
+
+/// What a recorder without a shared writer does: a FILE* per stream, a header and a frame fwrite per frame
+Result runFileBaseline(const Load &load)
+{
+    std::vector<FILE *> files;
+    for (int stream = 0; stream < load.streams; stream++) {
+        files.push_back(std::fopen(streamPath(load, "stdio", stream).c_str(), "wb"));
+        if (!files.back()) {
+            std::printf("Can not create %s\n", streamPath(load, "stdio", stream).c_str());
+            return Result();
+        }
+        std::setvbuf(files.back(), nullptr, _IOFBF, BUFSIZ);
+    }
+    Result result = produce(load, [&](int stream, const FrameInfo &info, ConstByteSpan data) {
+        uint8_t header[FrameRecordHeaderCodec::size];
+        FrameRecordHeaderCodec::store(header, makeFrameRecordHeader(info, uint32_t(data.size)));
+        FILE *file = files[size_t(stream)];
+        return std::fwrite(header, sizeof(header), 1, file) == 1 && std::fwrite(data.data, data.size, 1, file) == 1;
+    });
+    std::clock_t cpuStart = std::clock();
+    uint64_t start = monotonicMicros();
+    for (FILE *file : files) {
+        std::fclose(file);
+    }
+    result.wall += double(monotonicMicros() - start) / 1e6;
+    result.cpu += double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    // Estimate, stdio writes its BUFSIZ buffer whenever it fills and the rest on close
+    result.writes = result.syscalls = (result.bytes + uint64_t(result.frames) * FrameRecordHeaderCodec::size) / BUFSIZ + files.size();
+    return result;
+}
+
+void printResult(const char *name, const Result &result)
+{
+    std::printf("%-28s %8.1f MB/s  %8llu frames  %6llu dropped  %8llu writes  %8llu syscalls  %6.2f s CPU\n", name,
+                double(result.bytes) / 1e6 / result.wall, (unsigned long long)result.frames, (unsigned long long)result.dropped,
+                (unsigned long long)result.writes, (unsigned long long)result.syscalls, result.cpu);
+}
+
+void removeFiles(const Load &load)
+{
+    for (int stream = 0; stream < load.streams; stream++) {
+        std::string writer = streamPath(load, "writer", stream);
+        unlink(writer.c_str());
+        unlink(KeyframeIndex::indexPath(writer).c_str());
+        unlink(streamPath(load, "stdio", stream).c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Load load;
+    if (isQuickRun(argc, argv)) {
+        load.streams = 128;
+        load.seconds = 0.5;
+        load.kbps = 1000;
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--streams") == 0) {
+            load.streams = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--seconds") == 0) {
+            load.seconds = std::atof(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--kbps") == 0) {
+            load.kbps = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--dir") == 0) {
+            load.dir = argv[i + 1];
+        }
+    }
+
+    std::printf("%d streams, %.1f s, %d fps, %d kbit/s each, files in %s\n", load.streams, load.seconds, load.fps, load.kbps,
+                load.dir.c_str());
+    bool ioUring = false;
+    Result writer = runRecordWriter(load, &ioUring);
+    Result baseline = runFileBaseline(load);
+    printResult(ioUring ? "RecordWriter (io_uring)" : "RecordWriter (pwrite)", writer);
+    printResult("FILE* per stream", baseline);
+    removeFiles(load);
+
+    return writer.frames > 0 && writer.dropped == 0 && baseline.frames > 0 ? 0 : 1;
+}
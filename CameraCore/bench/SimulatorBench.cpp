@@ -0,0 +1,196 @@
+//
+//  SimulatorBench.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  End to end numbers against SimulatedDevice: connect time, time to first frame, IO control round trip,
+//  sustained fps (wall clock and per CPU second) and playback download throughput.
+//  Usage: SimulatorBench [--quick] [--streams N] [--seconds S]
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "BenchSupport.h"
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/Metrics.h"
+#include "CameraCore/PlaybackControl.h"
+#include "CameraCore/SimulatedDevice.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+const STimeDay kRecordTime{2026, 10, 19, 1, 8, 0, 0};
+
+void printHistogram(const char *name, const LatencyHistogram &histogram)
+{
+    HistogramSnapshot s = histogram.snapshot();
+    std::printf("%-24s count %6llu  p50 %7.1f ms  p95 %7.1f ms  max %7.1f ms\n", name, (unsigned long long)s.count,
+                s.valueAtPercentile(50), s.valueAtPercentile(95), s.max);
+}
+
+struct LiveResult
+{
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> failures{0};
+    LatencyHistogram connectTime;
+    LatencyHistogram timeToFirstFrame;
+    LatencyHistogram ioctrlRoundTrip;
+};
+
+void runStream(SimulatedDevice &device, uint64_t duration, LiveResult &result)
+{
+    const SimulatorConfig &config = device.config();
+    int error = 0;
+    uint64_t start = monotonicMicros();
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 5000, &error);
+    if (!transport) {
+        result.failures++;
+        return;
+    }
+    result.connectTime.recordMicros(monotonicMicros() - start);
+
+    int avIndex = transport->openChannel(0, config.account, config.password);
+    if (avIndex < 0) {
+        result.failures++;
+        return;
+    }
+    uint64_t opened = monotonicMicros();
+    auto startStream = StartStream::encodeRequest(SMsgAVIoctrlAVStream{0});
+    transport->sendIOCtrl(avIndex, StartStream::requestType, ConstByteSpan{startStream.data(), startStream.size()});
+
+    std::atomic<bool> stop{false};
+    std::thread ioctrl([&] {
+        auto request = DeviceInfo::encodeRequest(SMsgAVIoctrlDeviceInfoReq{});
+        uint8_t reply[kMaxIoctrlSize];
+        while (!stop.load()) {
+            uint64_t sent = monotonicMicros();
+            transport->sendIOCtrl(avIndex, DeviceInfo::requestType, ConstByteSpan{request.data(), request.size()});
+            uint32_t type = 0;
+            if (transport->recvIOCtrl(avIndex, &type, ByteSpan{reply, sizeof(reply)}, 1000) >= 0) {
+                result.ioctrlRoundTrip.recordMicros(monotonicMicros() - sent);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    });
+
+    std::vector<uint8_t> buffer(PlaybackControl::kMaxFrameSize);
+    bool first = true;
+    uint64_t end = opened + duration;
+    while (monotonicMicros() < end) {
+        FrameInfo info;
+        int size = transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 100);
+        if (size < 0) {
+            continue;
+        }
+        if (first) {
+            result.timeToFirstFrame.recordMicros(monotonicMicros() - opened);
+            first = false;
+        }
+        result.frames.fetch_add(1, std::memory_order_relaxed);
+        result.bytes.fetch_add(uint64_t(size), std::memory_order_relaxed);
+    }
+    stop.store(true);
+    ioctrl.join();
+    transport->closeChannel(avIndex);
+}
+
+/// Play a generated recording unpaced and measure the bytes per second
+double runDownload(SimulatedDevice &device, uint64_t *bytes)
+{
+    const SimulatorConfig &config = device.config();
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 5000, &error);
+    if (!transport) {
+        return 0;
+    }
+    int avIndex = transport->openChannel(0, config.account, config.password);
+    IoctrlChannel control(*transport, avIndex);
+    PlaybackControl playback(control, 0, config.account, config.password);
+    uint64_t start = monotonicMicros();
+    if (playback.start(kRecordTime, 5000) < 0) {
+        return 0;
+    }
+    std::vector<uint8_t> buffer(PlaybackControl::kMaxFrameSize);
+    *bytes = 0;
+    for (;;) {
+        FrameInfo info;
+        int size = playback.recvFrame(ByteSpan{buffer.data(), buffer.size()}, &info, 100);
+        if (size < 0) {
+            break;
+        }
+        *bytes += uint64_t(size);
+    }
+    // The receive that found the end waited 100 ms for nothing
+    double seconds = double(monotonicMicros() - start - 100000) / 1e6;
+    return seconds > 0 ? double(*bytes) / seconds : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool quick = isQuickRun(argc, argv);
+    int streams = quick ? 2 : 16;
+    double seconds = quick ? 0.3 : 5;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--streams") == 0) {
+            streams = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--seconds") == 0) {
+            seconds = std::atof(argv[i + 1]);
+        }
+    }
+
+    SimulatorConfig config;
+    config.fps = 30;
+    config.gop = 30;
+    config.connectTime = 20;
+    config.delay = 10;
+    config.jitter = 5;
+    config.lossRate = 0.001;
+    SimulatedRecording recording;
+    recording.time = kRecordTime;
+    recording.duration = quick ? 10000 : 120000;
+    config.recordings.push_back(recording);
+    config.pacedPlayback = false;
+    SimulatedDevice device(config);
+
+    LiveResult result;
+    std::clock_t cpuStart = std::clock();
+    uint64_t wallStart = monotonicMicros();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < streams; i++) {
+        threads.emplace_back(runStream, std::ref(device), uint64_t(seconds * 1e6), std::ref(result));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    double wall = double(monotonicMicros() - wallStart) / 1e6;
+    double cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    uint64_t downloaded = 0;
+    double download = runDownload(device, &downloaded);
+
+    std::printf("%d streams, %.1f s, %d fps, %d ms one way delay\n", streams, seconds, config.fps, config.delay);
+    printHistogram("Connect time", result.connectTime);
+    printHistogram("Time to first frame", result.timeToFirstFrame);
+    printHistogram("IO control round trip", result.ioctrlRoundTrip);
+    std::printf("%-24s %10.1f fps  %10.1f kbit/s\n", "Live view", double(result.frames) / wall,
+                double(result.bytes) * 8 / 1000 / wall);
+    std::printf("%-24s %10.1f fps per CPU second (%.3f s CPU)\n", "Live view cost", cpu > 0 ? double(result.frames) / cpu : 0, cpu);
+    std::printf("%-24s %10.1f MB/s  (%llu bytes)\n", "Playback download", download / 1e6, (unsigned long long)downloaded);
+    std::printf("%-24s %10llu lost  %llu failed streams\n", "Errors", (unsigned long long)device.framesLost(),
+                (unsigned long long)result.failures.load());
+
+    bool ok = result.failures == 0 && result.frames > 0 && downloaded > 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+//
+//  Bitstream.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  What the core needs to know about a video frame without decoding it. Frames are Annex B byte
+//  streams as received from avRecvFrameData2.
+//
+
+#ifndef CameraCore_Bitstream_h
+#define CameraCore_Bitstream_h
+
+#include <cstdint>
+
+#include "CameraCore/Span.h"
+
+namespace cam {
+
+/// MEDIA_CODEC_VIDEO_H264
+constexpr uint16_t kCodecH264 = 0x4E;
+/// MEDIA_CODEC_VIDEO_HEVC
+constexpr uint16_t kCodecHEVC = 0x50;
+
+/**
+ Whether no later frame can reference this one, so it can be dropped before decoding without
+ breaking the pictures that follow: H.264 slices with nal_ref_idc 0, HEVC sub-layer non-reference
+ slices (TRAIL_N, TSA_N, STSA_N, RADL_N, RASL_N) of the highest temporal sub-layer. A sub-layer
+ non-reference slice of a lower sub-layer can still be referenced by the sub-layers above it.
+
+ @param hevcMaxTemporalId Highest TemporalId of an HEVC stream (hevcMaxTemporalId()), -1 while it is
+        not known, then no HEVC frame is non-reference
+ @return true only if the frame has slices and all of them are non-reference, false for other codecs
+ */
+bool isNonReferenceFrame(uint16_t codecId, ConstByteSpan frame, int hevcMaxTemporalId);
+
+/**
+ Highest TemporalId of an HEVC stream, sps_max_sub_layers_minus1 of the SPS in a frame (keyframes carry it)
+
+ @return The TemporalId, -1 if the frame has no SPS
+ */
+int hevcMaxTemporalId(ConstByteSpan frame);
+
+} // namespace cam
+
+#endif /* CameraCore_Bitstream_h */
@@ -0,0 +1,25 @@
+//
+//  Clock.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_Clock_h
+#define CameraCore_Clock_h
+
+#include <chrono>
+#include <cstdint>
+
+namespace cam {
+
+/// Monotonic local time (us), the time base of metrics, traces and clock sync
+inline uint64_t monotonicMicros()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace cam
+
+#endif /* CameraCore_Clock_h */
@@ -0,0 +1,159 @@
+//
+//  ClockSync.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_ClockSync_h
+#define CameraCore_ClockSync_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace cam {
+
+/// The camera clock read by one time request
+struct CameraTime
+{
+    int64_t receiveUs = 0;          // Camera time the request was received (us)
+    int64_t sendUs = 0;             // Camera time the reply was sent, receiveUs if the camera reports one time
+    uint64_t resolutionUs = 1000;   // Step of the camera clock, 1000000 for whole seconds (time_stamp of getSystemTimeDetail)
+};
+
+/**
+ A time request to the camera. The public protocol has no time command, getSystemTimeDetail and the
+ firmware specific ones are vendor commands, so the platform implements it. The frame latency needs
+ the clock of the FrameInfo timestamps, in whole ms since the epoch or any other.
+ */
+class CameraClock
+{
+public:
+    virtual ~CameraClock() = default;
+
+    /// @return #kNoError if successful, error code if return value < 0
+    virtual int read(CameraTime &time, int timeoutMs) = 0;
+};
+
+/**
+ The estimated camera clock, camera time = local time + offset + drift * 1e-6 * (local time - reference).
+ Local time is monotonicMicros().
+ */
+struct ClockEstimate
+{
+    bool valid = false;             // At least one sample
+    double offsetMs = 0;            // Camera time - local time at referenceUs
+    double driftPpm = 0;            // 0 until the samples span long enough to tell it from the error, see ClockEstimator
+    double roundTripMs = 0;         // Smallest round trip of the samples used
+    double accuracyMs = 0;          // Error bound of offsetMs: half the round trip and half the camera clock step
+    int sampleCount = 0;
+    uint64_t referenceUs = 0;
+
+    int64_t toCameraMicros(uint64_t localUs) const;
+    uint64_t toLocalMicros(int64_t cameraUs) const;
+
+    /// Age at localUs of a frame with the FrameInfo timestamp, the 32 bit ms wrap is taken into account
+    int64_t frameAgeMicros(uint32_t timestamp, uint64_t localUs) const;
+};
+
+/**
+ NTP style estimate of the camera clock from time requests. A sample gives the offset at the middle
+ of its round trip within half the round trip (minus the camera processing time) and half the clock step.
+
+ Of the last window samples the ones with the smallest round trip are used: the offset is their weighted
+ least squares line over local time, the drift its slope. The drift is only applied when the samples
+ span at least 10000 times the accuracy, a drift error of 100 ppm at most; with a whole second camera
+ clock that takes hours, before that the drift is 0 and the offset is that of the most accurate sample.
+ */
+class ClockEstimator
+{
+public:
+    explicit ClockEstimator(size_t window = 32) : window_(window < 2 ? 2 : window) {}
+
+    /// @param localSendUs, localReceiveUs monotonicMicros() around the time request
+    void addSample(uint64_t localSendUs, uint64_t localReceiveUs, const CameraTime &time);
+
+    ClockEstimate estimate() const { return estimate_; }
+    void reset();
+
+private:
+    struct Sample
+    {
+        double localUs;             // Middle of the round trip
+        double offsetUs;
+        double errorUs;
+        double roundTripUs;
+    };
+
+    void update();
+
+    const size_t window_;
+    std::deque<Sample> samples_;
+    int sampleCount_ = 0;
+    ClockEstimate estimate_;
+};
+
+struct ClockSyncConfig
+{
+    int intervalMs = 60000;         // Between samples after the first ones
+    int initialSamples = 8;
+    int initialIntervalMs = 1000;   // Between the first samples
+    int timeoutMs = 2000;
+    size_t window = 32;
+    double latencyAccuracyMs = 20;  // Frame latencies are measured while accuracyMs is at most this
+};
+
+/**
+ Samples the camera clock on its own thread, initialSamples one initialIntervalMs apart and then every
+ intervalMs. A failed request is retried at the next interval.
+
+ The estimate is as good as the camera clock: a whole second clock (time_stamp of getSystemTimeDetail)
+ gives an accuracy of 500 ms and more, which is no base for the age of single frames. frameLatency()
+ only measures while the estimate is within latencyAccuracyMs, see MeteredTransport::setClockSync.
+ */
+class ClockSync
+{
+public:
+    ClockSync(CameraClock &clock, ClockSyncConfig config = ClockSyncConfig());
+    ~ClockSync();
+
+    ClockSync(const ClockSync &) = delete;
+    ClockSync &operator=(const ClockSync &) = delete;
+
+    ClockEstimate estimate() const;
+
+    /**
+     End-to-end latency of a frame: its arrival against its camera timestamp
+
+     @param timestamp FrameInfo timestamp, @param localUs monotonicMicros() of the arrival
+     @return false while the estimate is not valid or less accurate than latencyAccuracyMs
+     */
+    bool frameLatency(uint32_t timestamp, uint64_t localUs, uint64_t *latencyUs) const;
+
+    /// Time requests sent and failed
+    uint64_t requestCount() const { return requests_.load(std::memory_order_relaxed); }
+    uint64_t failureCount() const { return failures_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    CameraClock &clock_;
+    const ClockSyncConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable stopped_;
+    ClockEstimator estimator_;
+    bool stop_ = false;
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> failures_{0};
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_ClockSync_h */
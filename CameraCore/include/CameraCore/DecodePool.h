@@ -0,0 +1,156 @@
+//
+//  DecodePool.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_DecodePool_h
+#define CameraCore_DecodePool_h
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/FrameHub.h"
+#include "CameraCore/FrameScaler.h"
+#include "CameraCore/FrameTrace.h"
+#include "CameraCore/Metrics.h"
+#include "CameraCore/SessionMemory.h"
+
+namespace cam {
+
+/// Decoder of one video stream, the platform implements it with VideoToolbox
+class VideoDecoder
+{
+public:
+    virtual ~VideoDecoder() = default;
+
+    /**
+     Decode the next frame of the stream
+
+     @param picture [out] The decoded picture, valid until the next call
+     @return #kNoError if a picture was decoded, error code if return value < 0
+     */
+    virtual int decode(uint16_t codecId, ConstByteSpan frame, Nv12Picture &picture) = 0;
+};
+
+enum class StreamPriority { Background = 0, Visible = 1, Focused = 2 };
+
+constexpr size_t kStreamPriorityCount = 3;
+
+struct DecodePoolConfig
+{
+    unsigned threads = 0;               // 0 is the number of processor cores
+    size_t maxQueuedPerSession = 30;    // Frames of a session waiting for a decode thread
+};
+
+struct DecodeSessionStats
+{
+    uint64_t framesDecoded = 0;
+    uint64_t framesSkipped = 0;     // Non-reference frames of small tiles or of consumers that are behind
+    uint64_t framesFailed = 0;      // The decoder returned an error
+    uint64_t framesDropped = 0;     // The session queue was full, see DecodePool::submit
+    size_t queued = 0;
+    HistogramSnapshot decodeTime;   // Decode and conversion of one frame
+};
+
+/**
+ The decode threads shared by all sessions, this is the one place frames are decoded.
+
+ Each session is a strand: its frames are decoded one at a time in submit order, by whichever thread
+ is free, so a session needs no thread of its own and its decoder is never used concurrently.
+ A session with frames waiting is queued on the thread that ran it last, which keeps its decoder
+ state in that core's cache. A thread without work steals from the others, and every thread takes
+ Focused sessions before Visible and Visible before Background, its own first. A session gets one
+ frame per turn so a busy stream can not hold a thread while a higher priority one waits.
+
+ Per frame the pool skips non-reference frames the OutputSize of the session or a hub whose
+ consumers are behind (FrameHub::consumersBehind) does not need, decodes the rest, converts them
+ to an RGBA picture of the output size (FrameScaler) and publishes them to the FrameHub of the session.
+ Only decoded frames are published: consumers that need every encoded frame, like RecordWriter,
+ take them on the receive thread before submit.
+ */
+class DecodePool
+{
+public:
+    explicit DecodePool(DecodePoolConfig config = DecodePoolConfig());
+
+    /// Waits for the frames being decoded, queued frames are dropped
+    ~DecodePool();
+
+    DecodePool(const DecodePool &) = delete;
+    DecodePool &operator=(const DecodePool &) = delete;
+
+    /**
+     Add the stream of an AV channel
+
+     @param hub Receives the decoded frames, it must outlive removeSession
+     @param trace Trace buffer of the session, may be nullptr
+     @param memory Memory of the session the queued frames are allocated from, nullptr for the heap
+     @return Session ID
+     */
+    int addSession(int avIndex, FrameHub &hub, std::unique_ptr<VideoDecoder> decoder,
+                   StreamPriority priority = StreamPriority::Visible, FrameTrace *trace = nullptr,
+                   std::shared_ptr<SessionMemory> memory = nullptr);
+
+    /// Drop the queued frames and wait until the frame being decoded is published, the decoder is destroyed
+    void removeSession(int session);
+
+    /**
+     Queue a received frame for decoding
+
+     @return #kNoError if queued, #kErrNotFound for an unknown session, #kErrMemoryBudget if the session
+             queue is full, its memory budget is reached, or the session waits for a keyframe after that.
+             Either drops the queued frames, decoding resumes at the next keyframe.
+     */
+    int submit(int session, const FrameInfo &info, ConstByteSpan data);
+
+    void setPriority(int session, StreamPriority priority);
+    void setOutputSize(int session, OutputSize output);
+
+    unsigned threadCount() const { return unsigned(workers_.size()); }
+
+    /// Frames waiting for a decode thread, all sessions
+    size_t queueDepth() const { return queued_.load(std::memory_order_relaxed); }
+
+    /// @return #kNoError if successful, #kErrNotFound for an unknown session
+    int sessionStats(int session, DecodeSessionStats &stats) const;
+
+private:
+    struct Session;
+    struct Worker;
+
+    std::shared_ptr<Session> find(int session) const;
+    void schedule(const std::shared_ptr<Session> &session);
+    std::shared_ptr<Session> take(size_t worker);
+    void run(size_t worker);
+    void decodeNext(Worker &worker, const std::shared_ptr<Session> &session);
+
+    const DecodePoolConfig config_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    mutable std::mutex mutex_;
+    std::map<int, std::shared_ptr<Session>> sessions_;
+    int nextId_ = 0;
+    unsigned nextWorker_ = 0;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> ready_{0};      // Sessions in the ready queues of the workers
+    bool stop_ = false;
+
+    std::atomic<size_t> queued_{0};
+};
+
+} // namespace cam
+
+#endif /* CameraCore_DecodePool_h */
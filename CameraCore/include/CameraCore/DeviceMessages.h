@@ -0,0 +1,128 @@
+//
+//  DeviceMessages.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_DeviceMessages_h
+#define CameraCore_DeviceMessages_h
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "CameraCore/IoctrlChannel.h"
+#include "CameraCore/IoctrlMessages.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+enum class DeviceMessage { Fota = 0, PlaybackEnd = 1, Sensor = 2 };
+constexpr size_t kDeviceMessageCount = 3;
+
+/// Called on the listener thread
+struct DeviceMessageHandlers
+{
+    std::function<void(const ioctrl::SMsgFOTAResult &)> fota;               // Pushed or polled FOTA progress
+    std::function<void()> playbackEnd;                                      // Pushed or polled
+    std::function<void(const ioctrl::SMsgAVIoctrlEvent &)> event;           // Pushed motion, PIR and sound events
+    std::function<void(const ioctrl::SMsgSensorDetail &)> sensorDetail;     // Polled sensor state
+    std::function<void(uint32_t type, ConstByteSpan data)> other;           // Any other IO control, e.g. replies
+};
+
+/**
+ The polled commands are vendor commands, their types are given by the caller (see IoctrlMessages.h).
+ A message whose request type is 0 is not polled. Requests carry the camera channel (SMsgAVIoctrlAVStream).
+ */
+struct DeviceMessageConfig
+{
+    int channel = 0;
+
+    uint32_t fotaRequestType = 0;           // getFOTAResult
+    uint32_t fotaResponseType = 0;          // SMsgFOTAResult, also the type of pushed progress
+    uint32_t playbackEndRequestType = 0;    // checkPlaybackEnd
+    uint32_t playbackEndResponseType = 0;   // SMsgAVIoctrlResult, 1 if the playback ended
+    uint32_t sensorRequestType = 0;         // getSensorDetail
+    uint32_t sensorResponseType = 0;        // SMsgSensorDetail
+
+    int activeIntervalMs = 1000;            // While a firmware update or a playback is in progress
+    int idleIntervalMs = 30000;
+};
+
+/**
+ Listens for the messages the camera sends without a request on the IO controls of an AV channel and
+ calls the typed handlers: IOTYPE_USER_IPCAM_EVENT_REPORT, AVIOCTRL_RECORD_PLAY_END and FOTA progress.
+
+ Firmware that does not push a message is polled for it instead, every activeIntervalMs while a firmware
+ update or a playback is in progress and every idleIntervalMs otherwise. The poll replies are received
+ by the listener like the pushes, so one thread does both. A message that arrives while no poll of it
+ is waiting for its reply shows that the firmware pushes it, and polling for it stops. Event reports do not
+ carry the sensor state, the sensor detail is polled whether or not they arrive.
+
+ A FOTA update is in progress while the last result is checking, downloading or upgrading (-1, 2, 3, 4),
+ a playback until it ends. setActive marks them from the commands the application sends.
+
+ The listener gets every IO control of the AV channel from its IoctrlChannel, which PlaybackControl and
+ JsonSettings read their replies from too. The IO controls it does not handle are passed to the other handler.
+ It stops when the transport fails, see error().
+ */
+class DeviceMessages
+{
+public:
+    /// @param control Reader of the AV channel, the polls are sent on it
+    DeviceMessages(IoctrlChannel &control, DeviceMessageConfig config, DeviceMessageHandlers handlers);
+    ~DeviceMessages();
+
+    DeviceMessages(const DeviceMessages &) = delete;
+    DeviceMessages &operator=(const DeviceMessages &) = delete;
+
+    /// Poll at the active interval (a firmware update or a playback was started) or at the idle interval
+    void setActive(DeviceMessage message, bool active);
+
+    /// The firmware was seen to push the message, it is not polled any more
+    bool pushSupported(DeviceMessage message) const;
+
+    /// Poll requests sent
+    uint64_t pollCount(DeviceMessage message) const;
+
+    /// #kNoError while the listener runs, the error of the transport once it stopped
+    int error() const { return error_.load(std::memory_order_relaxed); }
+
+private:
+    struct Poll
+    {
+        uint32_t requestType = 0;
+        bool active = false;
+        bool pushed = false;
+        bool awaitingReply = false;
+        uint64_t nextPoll = 0;          // monotonicMicros()
+        uint64_t count = 0;
+    };
+
+    void run();
+    void sendPolls(uint64_t now, uint64_t &nextDue);
+    void dispatch(uint32_t type, ConstByteSpan data);
+    /// A message arrived, @param pushed false if it may be the reply of a poll
+    void received(DeviceMessage message, bool pushed);
+
+    Transport &transport_;
+    const int avIndex_;
+    const DeviceMessageConfig config_;
+    const DeviceMessageHandlers handlers_;
+    IoctrlQueue messages_;
+
+    mutable std::mutex mutex_;
+    std::array<Poll, kDeviceMessageCount> polls_;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> error_{0};
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_DeviceMessages_h */
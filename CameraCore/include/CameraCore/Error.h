@@ -0,0 +1,36 @@
+//
+//  Error.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_Error_h
+#define CameraCore_Error_h
+
+namespace cam {
+
+/**
+ Return values >= 0 are success.
+ Errors of the IOTC/AV transport (IOTC_ER_* between -1 and -99, AV_ER_* between -20000 and -20099)
+ are passed through unchanged, errors of the core itself are between -30000 and -30099.
+ */
+enum : int {
+    kNoError = 0,
+
+    kErrInvalidArg = -30000,            // Argument out of range or object in the wrong state
+    kErrBufferTooSmall = -30001,        // Caller provided buffer is smaller than the data
+    kErrTimeout = -30002,               // No answer within the timeout
+    kErrBadPackage = -30003,            // IO control reply is malformed, or its packages are out of order
+    kErrMemoryBudget = -30004,          // Allocation would exceed the memory budget of the session
+    kErrClosed = -30005,                // The object was stopped or closed
+    kErrNotFound = -30006,              // Requested item does not exist
+    kErrIO = -30007,                    // File system error, errno is kept by the caller
+    kErrUnsupported = -30008,           // The camera or the platform does not support the operation
+    kErrRejected = -30009,              // The camera answered the command with a failure result
+};
+
+} // namespace cam
+
+#endif /* CameraCore_Error_h */
@@ -0,0 +1,73 @@
+//
+//  FastStart.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_FastStart_h
+#define CameraCore_FastStart_h
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "CameraCore/FrameHub.h"
+#include "CameraCore/Metrics.h"
+#include "CameraCore/SessionMemory.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+struct FastStartConfig
+{
+    int channel = 0;                    // Camera channel of the stream
+    bool withAudio = false;             // Send IOTYPE_USER_IPCAM_AUDIOSTART as well
+
+    /// Vendor IO control that makes the encoder send a keyframe now, sent right after IOTYPE_USER_IPCAM_START.
+    /// The public protocol has none, with 0 the first keyframe is the one at the next GOP boundary.
+    uint32_t keyframeRequestType = 0;
+    std::vector<uint8_t> keyframeRequest;
+
+    /// Runs on its own thread while the first keyframe is awaited, e.g. the resolution query. Its return value is setupError
+    std::function<int()> setup;
+
+    int timeoutMs = 5000;               // Call to first keyframe
+    size_t maxFrameSize = 512 * 1024;   // Receive buffer, larger frames are skipped
+
+    FrameHub *hub = nullptr;            // Gets the keyframe as soon as it is received, nullptr to only return it
+    std::shared_ptr<SessionMemory> memory;  // Memory of the keyframe, nullptr for the heap
+    ChannelMetrics *metrics = nullptr;  // Records the time to first frame in firstKeyframeLatency
+};
+
+struct FastStartResult
+{
+    FramePtr keyframe;                  // The first keyframe, nullptr if none was received
+    uint64_t timeToFirstFrameUs = 0;    // Call to the first keyframe received
+    uint32_t skippedFrames = 0;         // Frames received before it, not decodable without it
+    int audioError = 0;                 // Return value of the AUDIOSTART send
+    int setupError = 0;                 // Return value of setup
+};
+
+/**
+ Start the live view of an AV channel with the shortest time to the first picture.
+
+ IOTYPE_USER_IPCAM_START and the keyframe request are sent first, AUDIOSTART and setup run on a second
+ thread at the same time, so neither waits for the other's acknowledgment. The frames received before the
+ first keyframe are skipped, the keyframe is published to the hub directly, without waiting for a decode
+ or a steady state queue. The caller's receive loop takes over from the next frame.
+
+ Call it before the frames of avIndex are received anywhere else, e.g. before the receive thread of the
+ channel starts. The stream is not stopped on failure, setup is joined before returning.
+
+ @param result [out] The keyframe and the timings, filled as far as the start got on failure
+ @return #kNoError if the keyframe is received, #kErrTimeout if it did not arrive within timeoutMs,
+         #kErrMemoryBudget if memory has no room for it, error code of sendIOCtrl or recvFrame
+ */
+int fastStart(Transport &transport, int avIndex, const FastStartConfig &config, FastStartResult *result);
+
+} // namespace cam
+
+#endif /* CameraCore_FastStart_h */
@@ -0,0 +1,174 @@
+//
+//  FotaRollout.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_FotaRollout_h
+#define CameraCore_FotaRollout_h
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/IoctrlMessages.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/**
+ The FOTA commands of a camera (checkVersion, downloadVersion, installVersion, getFOTAResult).
+ They are vendor commands, the platform implements them with their IO control types.
+ */
+class FotaCommands
+{
+public:
+    virtual ~FotaCommands() = default;
+
+    /// @return #kNoError if sending successfully, error code if return value < 0
+    virtual int checkVersion(Transport &transport, int avIndex) = 0;
+    virtual int download(Transport &transport, int avIndex) = 0;
+    virtual int install(Transport &transport, int avIndex) = 0;
+
+    /**
+     Get the current FOTA result, see CAMFOTAResultInfo for the values
+
+     @return #kNoError if successful, error code if return value < 0
+     */
+    virtual int result(Transport &transport, int avIndex, ioctrl::SMsgFOTAResult &result, int timeoutMs) = 0;
+};
+
+struct DeviceCredentials
+{
+    std::string account = "admin";
+    std::string password = "admin";
+};
+
+enum class RolloutState {
+    Pending,
+    Connecting,
+    Checking,           // checkVersion sent, waiting for result 1 or 0
+    Downloading,        // download sent, result 2 and 3 until 3 / 2 (check done)
+    Installing,         // install sent, result 4
+    Rebooting,          // Waiting to reconnect and result 5
+    Succeeded,
+    UpToDate,           // result 0, no newer firmware
+    Failed,
+    Cancelled,
+};
+
+struct RolloutConfig
+{
+    std::vector<size_t> waveSizes{10, 100, 1000};   // Cameras per wave, the last value repeats
+    size_t maxConcurrent = 64;                      // Cameras updating at the same time
+    int connectTimeoutMs = 30000;
+    int stepTimeoutMs = 120000;                     // Longest time without a change of the FOTA result
+    int rebootTimeoutMs = 600000;                   // Time to reconnect after the install
+    int pollIntervalMs = 1000;                      // getFOTAResult while a step is in progress
+    double maxFailureRate = 0.1;                    // Halt before the next wave when failed / finished of a wave exceeds it
+};
+
+/// The firmware update of one camera
+struct RolloutDevice
+{
+    std::string uid;
+    RolloutState state = RolloutState::Pending;
+    int wave = -1;
+    int32_t result = 0;             // Last FOTA result
+    int32_t reserved = 0;
+    int error = 0;                  // Error code when failed, 0 otherwise
+
+    bool isFinished() const { return state >= RolloutState::Succeeded; }
+};
+
+struct RolloutProgress
+{
+    size_t total = 0;
+    size_t pending = 0;
+    size_t running = 0;
+    size_t succeeded = 0;
+    size_t upToDate = 0;
+    size_t failed = 0;
+    size_t cancelled = 0;
+    int wave = 0;                   // Current wave, starts from 0
+    bool halted = false;            // The failure rate of a wave exceeded maxFailureRate
+    bool finished = false;          // Every camera finished or the rollout was cancelled
+    double percent = 0;             // 0 ~ 100, download and upgrade progress included
+};
+
+/**
+ Updates the firmware of many cameras. Each camera is connected with its own credentials and runs
+ checkVersion >> download >> install >> reconnect, following the FOTA result codes of CAMFOTAResultInfo.
+ A step fails on result -3 or -2, or when the result does not change within stepTimeoutMs.
+
+ The cameras are updated in waves of waveSizes, at most maxConcurrent at the same time, a wave starts
+ when the previous one finished. When more than maxFailureRate of the finished cameras of a wave failed,
+ the rollout halts until resume(). Every camera runs on a thread of the rollout, callbacks are called
+ on them and on the control thread.
+ */
+class FotaRollout
+{
+public:
+    /// Called when the state or the FOTA result of a camera changes
+    using DeviceCallback = std::function<void(const RolloutProgress &, const RolloutDevice &)>;
+    /// Called when the rollout finished, halted or was cancelled
+    using FinishCallback = std::function<void(const RolloutProgress &)>;
+
+    /// @param devices Credentials of the cameras by UID, the cameras are updated in UID order
+    FotaRollout(Connector &connector, FotaCommands &commands, std::map<std::string, DeviceCredentials> devices,
+                RolloutConfig config);
+
+    /// Cancels the rollout and waits for the running cameras
+    ~FotaRollout();
+
+    FotaRollout(const FotaRollout &) = delete;
+    FotaRollout &operator=(const FotaRollout &) = delete;
+
+    /// @return #kNoError if successful, #kErrInvalidArg if already started
+    int start(DeviceCallback deviceCallback, FinishCallback finishCallback);
+
+    /// Continue a halted rollout with the next wave, @return #kNoError if successful, #kErrInvalidArg if not halted
+    int resume();
+
+    /// Stop starting cameras, the cameras already started are finished
+    void cancel();
+
+    RolloutProgress progress() const;
+    std::vector<RolloutDevice> devices() const;
+
+private:
+    void run();
+    void runWave(size_t begin, size_t end);
+    void runDevice(size_t index);
+    int awaitResult(size_t index, Transport &transport, int avIndex, const std::function<bool(int32_t, int32_t)> &done);
+    int reconnect(size_t index, std::unique_ptr<Transport> &transport, int &avIndex);
+    void update(size_t index, const std::function<void(RolloutDevice &)> &change);
+    RolloutProgress progressLocked() const;
+
+    Connector &connector_;
+    FotaCommands &commands_;
+    const RolloutConfig config_;
+    std::vector<DeviceCredentials> credentials_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<RolloutDevice> devices_;
+    DeviceCallback deviceCallback_;
+    FinishCallback finishCallback_;
+    int wave_ = 0;
+    bool started_ = false;
+    bool halted_ = false;
+    bool finished_ = false;
+    bool cancelled_ = false;
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_FotaRollout_h */
@@ -0,0 +1,50 @@
+//
+//  FrameFile.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Layout of the video files written by the core: a sequence of frame records, each a 16 byte
+//  little endian header followed by the frame as received from avRecvFrameData2.
+//  The header keeps the FRAMEINFO_t fields needed to index and decode the file without the camera.
+//
+
+#ifndef CameraCore_FrameFile_h
+#define CameraCore_FrameFile_h
+
+#include "CameraCore/IoctrlCodec.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/// "CAMF"
+constexpr uint32_t kFrameRecordMagic = 0x464D4143;
+
+struct FrameRecordHeader
+{
+    uint32_t magic;
+    uint16_t codecId;
+    uint8_t flags;              // kFrameFlagKeyframe
+    uint32_t timestamp;         // Camera time (ms)
+    uint32_t size;              // Size of the frame that follows
+};
+
+using FrameRecordHeaderCodec = ioctrl::Codec<FrameRecordHeader,
+                                             ioctrl::Member<&FrameRecordHeader::magic>,
+                                             ioctrl::Member<&FrameRecordHeader::codecId>,
+                                             ioctrl::Member<&FrameRecordHeader::flags>,
+                                             ioctrl::Reserved<FrameRecordHeader, 1>,
+                                             ioctrl::Member<&FrameRecordHeader::timestamp>,
+                                             ioctrl::Member<&FrameRecordHeader::size>>;
+
+static_assert(FrameRecordHeaderCodec::size == 16, "Frame record header is 16 bytes");
+
+inline FrameRecordHeader makeFrameRecordHeader(const FrameInfo &info, uint32_t size)
+{
+    return FrameRecordHeader{kFrameRecordMagic, info.codecId, info.flags, info.timestamp, size};
+}
+
+} // namespace cam
+
+#endif /* CameraCore_FrameFile_h */
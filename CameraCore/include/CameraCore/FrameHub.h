@@ -0,0 +1,140 @@
+//
+//  FrameHub.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_FrameHub_h
+#define CameraCore_FrameHub_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CameraCore/Image.h"
+#include "CameraCore/SessionMemory.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/**
+ A received video frame shared by all consumers of an AV channel. It is never modified after
+ FrameHub::publish, consumers hold a reference and the frame is released with the last one.
+
+ The picture is decoded once, by DecodePool before the frame is published, never by a consumer.
+ The pool publishes decoded frames only, picture is nullptr only in hubs fed without decoding.
+ */
+struct Frame
+{
+    int avIndex = -1;
+    FrameInfo info;
+    SessionBytes data;                          // Encoded frame, from the memory of the session
+    std::shared_ptr<const Image> picture;
+};
+
+using FramePtr = std::shared_ptr<const Frame>;
+
+/**
+ A copy of a received frame, the Frame and its data allocated from the memory of the session
+
+ @param memory nullptr for the heap
+ @return The frame, nullptr if the budget of memory has no room for it
+ */
+std::shared_ptr<Frame> makeFrame(const std::shared_ptr<SessionMemory> &memory, int avIndex, const FrameInfo &info,
+                                 ConstByteSpan data);
+
+/// The frame a full subscription queue drops
+enum class DropPolicy {
+    Oldest,             // The oldest queued frame
+    Newest,             // The new frame
+    UntilKeyframe,      // All queued frames, the new frame and the following frames up to the next keyframe
+    Latest,             // Single slot mailbox, the new frame replaces the pending one. queueDepth is ignored
+};
+
+struct SubscriptionConfig
+{
+    size_t queueDepth = 8;      // Frames waiting for the consumer, minimum 1
+    DropPolicy dropPolicy = DropPolicy::Oldest;
+};
+
+/// A consumer of a FrameHub with its own queue, taken with next() by the consumer thread
+class FrameSubscription
+{
+public:
+    explicit FrameSubscription(SubscriptionConfig config);
+
+    FrameSubscription(const FrameSubscription &) = delete;
+    FrameSubscription &operator=(const FrameSubscription &) = delete;
+
+    /**
+     Wait for the next frame
+
+     @return The oldest queued frame, nullptr on timeout or after cancel
+     */
+    FramePtr next(int timeoutMs);
+
+    /// Release the queued frames and make next() return nullptr, called by FrameHub::unsubscribe
+    void cancel();
+
+    const SubscriptionConfig &config() const { return config_; }
+    size_t queued() const;
+    uint64_t framesDelivered() const;
+    uint64_t framesDropped() const;
+
+private:
+    friend class FrameHub;
+
+    void push(const FramePtr &frame);
+    bool latestPending() const;
+
+    const SubscriptionConfig config_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<FramePtr> queue_;
+    bool awaitKeyframe_ = false;
+    bool cancelled_ = false;
+    uint64_t delivered_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+/**
+ Fan-out of the frames of one AV channel to any number of consumers, e.g. live view, recording,
+ snapshot and analytics. Every consumer gets the same FramePtr, nothing is copied per consumer.
+
+ publish never waits for a consumer: it takes each subscription lock only to queue the frame, and a
+ full queue drops by the policy of that subscription. A slow consumer loses its own frames and
+ nobody else's.
+
+ All functions can be called from any thread.
+ */
+class FrameHub
+{
+public:
+    std::shared_ptr<FrameSubscription> subscribe(SubscriptionConfig config = SubscriptionConfig());
+    void unsubscribe(const std::shared_ptr<FrameSubscription> &subscription);
+
+    void publish(const FramePtr &frame);
+
+    /**
+     Whether every consumer still has a frame pending and takes only the latest one, i.e. all
+     subscriptions are DropPolicy::Latest with their slot full. A frame published now would only
+     replace a frame nobody has seen, so DecodePool skips non-reference frames
+     (isNonReferenceFrame) without decoding them. false without subscriptions.
+     */
+    bool consumersBehind() const;
+
+    size_t subscriberCount() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<FrameSubscription>> subscriptions_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_FrameHub_h */
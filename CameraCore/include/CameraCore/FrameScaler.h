@@ -0,0 +1,76 @@
+//
+//  FrameScaler.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_FrameScaler_h
+#define CameraCore_FrameScaler_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CameraCore/Image.h"
+#include "CameraCore/Span.h"
+
+namespace cam {
+
+/// A decoder output picture in NV12: a Y plane and an interleaved CbCr plane of half width and height (BT.601)
+struct Nv12Picture
+{
+    int width = 0;
+    int height = 0;
+    const uint8_t *y = nullptr;
+    size_t yStride = 0;
+    const uint8_t *uv = nullptr;
+    size_t uvStride = 0;
+    bool fullRange = false;     // Y and CbCr use 0..255, otherwise 16..235 / 16..240
+};
+
+/// The size a stream is shown at, e.g. its tile in a grid view
+struct OutputSize
+{
+    int maxWidth = 0;                   // 0 is the full resolution
+    int maxHeight = 0;
+    int skipNonReferenceBelowWidth = 0; // Tiles narrower than this do not decode non-reference frames, 0 never skips
+
+    bool isFullResolution() const { return maxWidth <= 0 || maxHeight <= 0; }
+
+    /// Whether DecodePool skips the frame: a non-reference frame (isNonReferenceFrame) of a small tile
+    bool skipsFrame(uint16_t codecId, ConstByteSpan frame, int hevcMaxTemporalId) const;
+};
+
+/**
+ Color conversion and downscale in one pass, from the NV12 output of the decoder straight to an RGBA
+ picture of the output size, so a small tile never costs a full size RGBA picture.
+
+ Each destination pixel is the box filter average of the source pixels it covers (like downscaleBox),
+ Y and CbCr are averaged on their own planes before the conversion. Rows are accumulated 8 bytes and
+ converted 4 pixels at a time with compiler vector extensions, SSE2 / NEON code on the targets.
+
+ The scratch rows are kept between calls and the destination buffer is reused when large enough,
+ so converting a stream allocates only when its size grows. One scaler per decode thread.
+ */
+class FrameScaler
+{
+public:
+    /// Convert to the largest size with the aspect ratio of src that fits in maxWidth x maxHeight (fitSize)
+    void convert(const Nv12Picture &src, int maxWidth, int maxHeight, Image &dst);
+
+    /// Convert to exactly width x height, at most the size of src
+    void convertTo(const Nv12Picture &src, int width, int height, Image &dst);
+
+private:
+    void sumRows(const uint8_t *plane, size_t stride, int y0, int y1, size_t bytes);
+
+    std::vector<uint32_t> columnSums_;
+    std::vector<int32_t> y_, u_, v_;
+    std::vector<uint32_t> columns_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_FrameScaler_h */
@@ -0,0 +1,111 @@
+//
+//  FrameTrace.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Per frame trace points of the receive pipeline, recorded into a per-session ring buffer and
+//  exported in Chrome trace event format.
+//
+//  The trace points are written with CAM_FRAME_TRACE and exist only in builds with the CMake option
+//  CAMCORE_FRAME_TRACE, otherwise they compile to nothing. The value is in the generated Config.h,
+//  FrameTrace::enabled tells code built against a prebuilt library whether its trace points exist.
+//
+
+#ifndef CameraCore_FrameTrace_h
+#define CameraCore_FrameTrace_h
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Config.h"
+
+namespace cam {
+
+/// The point a frame reached, in pipeline order
+enum class TraceStage : uint8_t {
+    Received = 0,       // The transport returned the frame
+    DecodeStart = 1,    // A decode thread took the frame
+    Decoded = 2,        // The picture is decoded
+    Converted = 3,      // The platform image is created
+    Delivered = 4,      // The frame was published to the FrameHub of the channel
+};
+
+constexpr size_t kTraceStageCount = 5;
+
+/// Name of the trace event that ends at stage
+const char *traceStageName(TraceStage stage);
+
+/// Whether the library binary was built with CAMCORE_FRAME_TRACE, differs from FrameTrace::enabled only if Config.h does not belong to the binary
+bool frameTraceBuiltIn();
+
+struct TraceEvent
+{
+    int avIndex;
+    uint32_t frameNumber;
+    TraceStage stage;
+    uint64_t time;          // monotonicMicros()
+};
+
+/**
+ Fixed size ring buffer of trace events, the oldest events are overwritten.
+ record takes no lock and can be called from every thread of the pipeline at once, it only waits when the
+ buffer wraps around while another thread is writing the same slot.
+ */
+class FrameTrace
+{
+public:
+    static constexpr bool enabled = CAMCORE_FRAME_TRACE != 0;
+
+    /// @param capacity Number of events kept, rounded up to a power of two
+    explicit FrameTrace(size_t capacity);
+
+    void record(int avIndex, uint32_t frameNumber, TraceStage stage, uint64_t time);
+
+    /// The events in the buffer, oldest first. Events being written during the call are skipped.
+    std::vector<TraceEvent> events() const;
+
+    /**
+     Export as Chrome trace event JSON (chrome://tracing, Perfetto).
+     Each AV channel is a thread ("tid": avIndex). Received is an instant event, every later stage is a
+     complete event ("ph": "X") from the previous stage of the same frame, named after the stage,
+     so its duration is the time that stage took. The frame number is in "args".
+     */
+    std::string exportChromeJson() const;
+
+    void clear();
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};      // Odd while the slot is written
+        std::atomic<uint64_t> key{0};           // avIndex << 40 | stage << 32 | frame number
+        std::atomic<uint64_t> time{0};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    std::atomic<uint64_t> head_{0};
+};
+
+} // namespace cam
+
+#if CAMCORE_FRAME_TRACE
+#define CAM_FRAME_TRACE(trace, avIndex, frameNumber, stage)                                  \
+    do {                                                                                     \
+        if (trace) {                                                                         \
+            (trace)->record((avIndex), (frameNumber), (stage), ::cam::monotonicMicros());    \
+        }                                                                                    \
+    } while (0)
+#else
+#define CAM_FRAME_TRACE(trace, avIndex, frameNumber, stage) \
+    do {                                                    \
+    } while (0)
+#endif
+
+#endif /* CameraCore_FrameTrace_h */
@@ -0,0 +1,47 @@
+//
+//  Image.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_Image_h
+#define CameraCore_Image_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cam {
+
+/// A decoded picture, 4 bytes per pixel in RGBA order without row padding
+struct Image
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgba;
+
+    void resize(int w, int h)
+    {
+        width = w;
+        height = h;
+        rgba.resize(size_t(w) * size_t(h) * 4);
+    }
+};
+
+/**
+ The largest size with the aspect ratio of width x height that fits in maxWidth x maxHeight,
+ never larger than the source and at least 1 x 1
+ */
+void fitSize(int width, int height, int maxWidth, int maxHeight, int *outWidth, int *outHeight);
+
+/**
+ Scale down with a box filter, every destination pixel is the average of the source pixels it covers.
+ dst is resized to width x height, its buffer is reused when large enough.
+ */
+void downscaleBox(const Image &src, int width, int height, Image &dst);
+
+} // namespace cam
+
+#endif /* CameraCore_Image_h */
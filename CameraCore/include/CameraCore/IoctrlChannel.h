@@ -0,0 +1,133 @@
+//
+//  IoctrlChannel.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_IoctrlChannel_h
+#define CameraCore_IoctrlChannel_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/**
+ The one reader of the IO controls of an AV channel. avRecvIOCtrl gives each IO control to one caller only,
+ so the users of a channel (DeviceMessages, PlaybackControl, JsonSettings) do not receive themselves:
+ the reader thread receives every IO control and gives it to every subscription of its type, in order.
+ A reply is seen by the command waiting for it and by a listener of all IO controls alike.
+
+ Sending needs no coordination, the users send on transport() directly. One IoctrlChannel per AV channel,
+ see Session::ioctrl. It stops reading when the transport fails, see error().
+ */
+class IoctrlChannel
+{
+public:
+    using Handler = std::function<void(uint32_t type, ConstByteSpan data)>;
+    using StoppedHandler = std::function<void(int error)>;
+
+    /// Starts the reader
+    IoctrlChannel(Transport &transport, int avIndex);
+
+    /// Stops the reader, the subscriptions are removed before
+    ~IoctrlChannel();
+
+    IoctrlChannel(const IoctrlChannel &) = delete;
+    IoctrlChannel &operator=(const IoctrlChannel &) = delete;
+
+    Transport &transport() const { return transport_; }
+    int avIndex() const { return avIndex_; }
+
+    /**
+     Call handler on the reader thread with every IO control of the types, of every type if types is empty.
+     The handlers must not wait for IO controls of the channel, subscribe or unsubscribe.
+
+     @param stopped Called on the reader thread with the error of the transport when the reader stops
+     @return Subscription ID
+     */
+    int subscribe(std::vector<uint32_t> types, Handler handler, StoppedHandler stopped = nullptr);
+
+    /// The handlers are not called any more once this returns
+    void unsubscribe(int id);
+
+    /// #kNoError while the reader runs, the error of the transport once it stopped
+    int error() const { return error_.load(std::memory_order_acquire); }
+
+private:
+    struct Subscription
+    {
+        int id;
+        std::vector<uint32_t> types;
+        Handler handler;
+        StoppedHandler stopped;
+    };
+
+    void run();
+
+    Transport &transport_;
+    const int avIndex_;
+
+    std::mutex mutex_;                  // Held while the handlers are called
+    std::vector<Subscription> subscriptions_;
+    int nextId_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> error_{0};
+    std::thread thread_;
+};
+
+/**
+ The IO controls of some types of an IoctrlChannel, queued for a thread that waits for them like it would
+ with Transport::recvIOCtrl. The oldest IO control is dropped when maxQueued are waiting.
+ */
+class IoctrlQueue
+{
+public:
+    static constexpr size_t kDefaultMaxQueued = 64;
+
+    /// @param types IO control types to queue, all if empty
+    IoctrlQueue(IoctrlChannel &channel, std::vector<uint32_t> types, size_t maxQueued = kDefaultMaxQueued);
+    ~IoctrlQueue();
+
+    IoctrlQueue(const IoctrlQueue &) = delete;
+    IoctrlQueue &operator=(const IoctrlQueue &) = delete;
+
+    IoctrlChannel &channel() const { return channel_; }
+
+    /**
+     Wait for the next IO control
+
+     @return Size of the IO control if return value >= 0, error code if return value < 0: #kErrTimeout,
+             #kErrBufferTooSmall for an IO control larger than buffer (it is dropped), the error of the
+             transport once the reader stopped and the queued IO controls are taken
+     */
+    int recv(uint32_t *type, ByteSpan buffer, int timeoutMs);
+
+    /// Drop the queued IO controls, e.g. replies of an earlier request
+    void clear();
+
+private:
+    IoctrlChannel &channel_;
+    const size_t maxQueued_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::pair<uint32_t, std::vector<uint8_t>>> queue_;
+    int error_ = 0;
+    int id_ = -1;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_IoctrlChannel_h */
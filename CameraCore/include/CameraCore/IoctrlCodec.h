@@ -0,0 +1,344 @@
+//
+//  IoctrlCodec.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Compile time IO control message codecs.
+//  The wire layout of a message is declared once as a list of struct members, the size is a constant
+//  and encoding/decoding is done in place on caller provided buffers without allocation.
+//
+//  struct SMsgExample { uint32_t channel; uint8_t enable; char name[16]; };
+//  using ExampleCodec = cam::ioctrl::Codec<SMsgExample,
+//                                          cam::ioctrl::Member<&SMsgExample::channel>,
+//                                          cam::ioctrl::Member<&SMsgExample::enable>,
+//                                          cam::ioctrl::Member<&SMsgExample::name>>;
+//  std::array<uint8_t, ExampleCodec::size> buffer = ExampleCodec::encode(msg);
+//
+//  The layouts of the IO control commands are in IoctrlMessages.h.
+//
+
+#ifndef CameraCore_IoctrlCodec_h
+#define CameraCore_IoctrlCodec_h
+
+#if __cplusplus < 201703L
+#error "IoctrlCodec.h requires C++17"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "CameraCore/Span.h"
+
+namespace cam {
+namespace ioctrl {
+
+using cam::ByteSpan;
+using cam::ConstByteSpan;
+
+enum class Endian { Little, Big };
+
+/// IO control data is little endian
+constexpr Endian kWireEndian = Endian::Little;
+
+namespace detail {
+
+template <typename T, bool = std::is_enum<T>::value>
+struct Underlying { using type = std::underlying_type_t<T>; };
+
+template <typename T>
+struct Underlying<T, false> { using type = T; };
+
+template <typename T, Endian E, typename Enable = void>
+struct Scalar;
+
+// Integers and enums, stored byte by byte so the order is fixed at compile time and independent of the host
+template <typename T, Endian E>
+struct Scalar<T, E, std::enable_if_t<(std::is_integral<T>::value || std::is_enum<T>::value) && !std::is_same<T, bool>::value>>
+{
+    using Unsigned = std::make_unsigned_t<typename Underlying<T>::type>;
+
+    static constexpr size_t size = sizeof(T);
+
+    static void store(uint8_t *p, T value) noexcept
+    {
+        Unsigned u = static_cast<Unsigned>(value);
+        for (size_t i = 0; i < size; i++) {
+            p[E == Endian::Little ? i : size - 1 - i] = static_cast<uint8_t>(u >> (8 * i));
+        }
+    }
+
+    static T load(const uint8_t *p) noexcept
+    {
+        Unsigned u = 0;
+        for (size_t i = 0; i < size; i++) {
+            u |= static_cast<Unsigned>(static_cast<Unsigned>(p[E == Endian::Little ? i : size - 1 - i]) << (8 * i));
+        }
+        return static_cast<T>(u);
+    }
+};
+
+template <Endian E>
+struct Scalar<bool, E, void>
+{
+    static constexpr size_t size = 1;
+
+    static void store(uint8_t *p, bool value) noexcept { p[0] = value ? 1 : 0; }
+    static bool load(const uint8_t *p) noexcept { return p[0] != 0; }
+};
+
+// Fixed size arrays, e.g. char ssid[32]
+template <typename T, size_t N, Endian E>
+struct Scalar<T[N], E, void>
+{
+    using Element = Scalar<T, E>;
+
+    static constexpr size_t size = Element::size * N;
+
+    static void store(uint8_t *p, const T (&value)[N]) noexcept
+    {
+        for (size_t i = 0; i < N; i++) {
+            Element::store(p + i * Element::size, value[i]);
+        }
+    }
+
+    static void load(const uint8_t *p, T (&value)[N]) noexcept
+    {
+        for (size_t i = 0; i < N; i++) {
+            value[i] = Element::load(p + i * Element::size);
+        }
+    }
+};
+
+template <typename M>
+struct MemberTraits;
+
+template <typename C, typename T>
+struct MemberTraits<T C::*>
+{
+    using Class = C;
+    using Type = T;
+};
+
+template <typename T>
+struct IsArray : std::false_type {};
+
+template <typename T, size_t N>
+struct IsArray<T[N]> : std::true_type {};
+
+} // namespace detail
+
+/**
+ A struct member in the wire layout, members are written in the order they are listed in Codec
+ */
+template <auto M, Endian E = kWireEndian>
+struct Member
+{
+    using Class = typename detail::MemberTraits<decltype(M)>::Class;
+    using Type = typename detail::MemberTraits<decltype(M)>::Type;
+    using Value = detail::Scalar<Type, E>;
+
+    static constexpr size_t size = Value::size;
+
+    static void store(uint8_t *p, const Class &s) noexcept { Value::store(p, s.*M); }
+
+    static void load(const uint8_t *p, Class &s) noexcept
+    {
+        if constexpr (detail::IsArray<Type>::value) {
+            Value::load(p, s.*M);
+        } else {
+            s.*M = Value::load(p);
+        }
+    }
+};
+
+/**
+ A struct member that is itself a message struct, e.g. STimeDay in SMsgAVIoctrlListEventReq
+ */
+template <auto M, typename NestedCodec>
+struct Nested
+{
+    using Class = typename detail::MemberTraits<decltype(M)>::Class;
+
+    static_assert(std::is_same<typename detail::MemberTraits<decltype(M)>::Type, typename NestedCodec::Struct>::value,
+                  "The codec must belong to the member type");
+
+    static constexpr size_t size = NestedCodec::size;
+
+    static void store(uint8_t *p, const Class &s) noexcept { NestedCodec::store(p, s.*M); }
+    static void load(const uint8_t *p, Class &s) noexcept { NestedCodec::load(p, s.*M); }
+};
+
+/**
+ Bytes in the wire layout that are not mapped to a member, written as 0 and skipped when decoding
+ */
+template <typename S, size_t N>
+struct Reserved
+{
+    using Class = S;
+
+    static constexpr size_t size = N;
+
+    static void store(uint8_t *p, const S &) noexcept
+    {
+        for (size_t i = 0; i < N; i++) {
+            p[i] = 0;
+        }
+    }
+
+    static void load(const uint8_t *, S &) noexcept {}
+};
+
+template <typename S, typename... Ms>
+struct Codec
+{
+    static_assert((std::is_same<typename Ms::Class, S>::value && ...), "All members must belong to the message struct");
+
+    using Struct = S;
+
+    /// Size of the message on the wire (bytes)
+    static constexpr size_t size = (Ms::size + ... + size_t(0));
+
+    /// Encode into a buffer known to hold size bytes
+    static void store(uint8_t *p, const S &s) noexcept
+    {
+        ((Ms::store(p, s), p += Ms::size), ...);
+        (void)p;
+    }
+
+    /// Decode from a buffer known to hold size bytes
+    static void load(const uint8_t *p, S &s) noexcept
+    {
+        ((Ms::load(p, s), p += Ms::size), ...);
+        (void)p;
+        (void)s;
+    }
+
+    /**
+     Encode a message
+
+     @return Number of bytes written, 0 if out is smaller than size
+     */
+    static size_t encode(const S &s, ByteSpan out) noexcept
+    {
+        if (out.size < size) {
+            return 0;
+        }
+        store(out.data, s);
+        return size;
+    }
+
+    static std::array<uint8_t, size> encode(const S &s) noexcept
+    {
+        std::array<uint8_t, size> out{};
+        store(out.data(), s);
+        return out;
+    }
+
+    /**
+     Decode a message, bytes after size are ignored
+
+     @return false if in is smaller than size
+     */
+    static bool decode(ConstByteSpan in, S &s) noexcept
+    {
+        if (in.size < size) {
+            return false;
+        }
+        load(in.data, s);
+        return true;
+    }
+};
+
+/**
+ Decode the array of elements that follows the fixed part of a reply, e.g. the SAvEvent list of SMsgAVIoctrlListEventResp
+
+ @param in The reply
+ @param offset Byte offset of the first element
+ @param count Number of elements the reply claims
+ @param handler Called with (index, element) for every complete element
+ @return Number of elements decoded, smaller than count if the reply is truncated
+ */
+template <typename ElementCodec, typename Handler>
+size_t decodeElements(ConstByteSpan in, size_t offset, size_t count, Handler &&handler)
+{
+    size_t decoded = 0;
+    typename ElementCodec::Struct element{};
+    while (decoded < count && offset <= in.size && in.size - offset >= ElementCodec::size) {
+        ElementCodec::load(in.data + offset, element);
+        handler(decoded, static_cast<const typename ElementCodec::Struct &>(element));
+        offset += ElementCodec::size;
+        decoded++;
+    }
+    return decoded;
+}
+
+/// The message has no payload, e.g. the reply of a command that is only acknowledged
+struct Empty {};
+
+using EmptyCodec = Codec<Empty>;
+
+/**
+ An IO control command, the request is sent with RequestType and the reply is received with ResponseType.
+ ResponseType is 0 when the command has no reply besides the acknowledgment of avSendIOCtrl.
+ */
+template <uint32_t RequestType, typename RequestCodec, uint32_t ResponseType = 0, typename ResponseCodec = EmptyCodec>
+struct Message
+{
+    static constexpr uint32_t requestType = RequestType;
+    static constexpr uint32_t responseType = ResponseType;
+
+    using Request = typename RequestCodec::Struct;
+    using Response = typename ResponseCodec::Struct;
+    using RequestBuffer = std::array<uint8_t, RequestCodec::size>;
+
+    static constexpr size_t requestSize = RequestCodec::size;
+    static constexpr size_t responseSize = ResponseCodec::size;
+
+    static size_t encodeRequest(const Request &request, ByteSpan out) noexcept { return RequestCodec::encode(request, out); }
+    static RequestBuffer encodeRequest(const Request &request) noexcept { return RequestCodec::encode(request); }
+    static bool decodeResponse(ConstByteSpan in, Response &response) noexcept { return ResponseCodec::decode(in, response); }
+};
+
+// MARK: Multi-package reply
+
+/// Header of each package of a multi-package reply, AMEGIA_SMsgAVIoctrlDataC in CAMClient.h
+struct DataPackageHeader
+{
+    uint32_t total;         // Total bytes
+    uint8_t index;          // package index, 0,1,2...
+    uint8_t endflag;        // endFlag = 1 means this package is the last one
+    uint16_t count;         // how much bytes in this package
+};
+
+using DataPackageHeaderCodec = Codec<DataPackageHeader,
+                                     Member<&DataPackageHeader::total>,
+                                     Member<&DataPackageHeader::index>,
+                                     Member<&DataPackageHeader::endflag>,
+                                     Member<&DataPackageHeader::count>>;
+
+static_assert(DataPackageHeaderCodec::size == 8, "AMEGIA_SMsgAVIoctrlDataC header is 8 bytes");
+
+/**
+ Get the payload of a package of a multi-package reply
+
+ @param package One received package
+ @param header [out] Decoded header
+ @return The payload, empty if the package is truncated
+ */
+inline ConstByteSpan packagePayload(ConstByteSpan package, DataPackageHeader &header) noexcept
+{
+    if (!DataPackageHeaderCodec::decode(package, header) ||
+        package.size - DataPackageHeaderCodec::size < header.count) {
+        return ConstByteSpan{nullptr, 0};
+    }
+    return ConstByteSpan{package.data + DataPackageHeaderCodec::size, header.count};
+}
+
+} // namespace ioctrl
+} // namespace cam
+
+#endif /* CameraCore_IoctrlCodec_h */
@@ -0,0 +1,406 @@
+//
+//  IoctrlMessages.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Request and response layouts of the IO control commands, declared once with IoctrlCodec.h.
+//  Types and layouts are those of the standard AVIOCTRLDEFs.h of the AV module.
+//  The FOTA and Json settings commands are vendor commands whose type values are not part of the
+//  public protocol, only their payload layouts are declared here and the type is given by the caller.
+//
+
+#ifndef CameraCore_IoctrlMessages_h
+#define CameraCore_IoctrlMessages_h
+
+#include "CameraCore/IoctrlCodec.h"
+
+namespace cam {
+namespace ioctrl {
+
+enum : uint32_t {
+    IOTYPE_USER_IPCAM_START = 0x01FF,
+    IOTYPE_USER_IPCAM_STOP = 0x02FF,
+    IOTYPE_USER_IPCAM_AUDIOSTART = 0x0300,
+    IOTYPE_USER_IPCAM_AUDIOSTOP = 0x0301,
+    IOTYPE_USER_IPCAM_LISTEVENT_REQ = 0x0318,
+    IOTYPE_USER_IPCAM_LISTEVENT_RESP = 0x0319,
+    IOTYPE_USER_IPCAM_RECORD_PLAYCONTROL = 0x031A,
+    IOTYPE_USER_IPCAM_RECORD_PLAYCONTROL_RESP = 0x031B,
+    IOTYPE_USER_IPCAM_SETSTREAMCTRL_REQ = 0x0320,
+    IOTYPE_USER_IPCAM_SETSTREAMCTRL_RESP = 0x0321,
+    IOTYPE_USER_IPCAM_GETSTREAMCTRL_REQ = 0x0322,
+    IOTYPE_USER_IPCAM_GETSTREAMCTRL_RESP = 0x0323,
+    IOTYPE_USER_IPCAM_DEVINFO_REQ = 0x0330,
+    IOTYPE_USER_IPCAM_DEVINFO_RESP = 0x0331,
+    IOTYPE_USER_IPCAM_SETPASSWORD_REQ = 0x0332,
+    IOTYPE_USER_IPCAM_SETPASSWORD_RESP = 0x0333,
+    IOTYPE_USER_IPCAM_LISTWIFIAP_REQ = 0x0340,
+    IOTYPE_USER_IPCAM_LISTWIFIAP_RESP = 0x0341,
+    IOTYPE_USER_IPCAM_SETWIFI_REQ = 0x0342,
+    IOTYPE_USER_IPCAM_SETWIFI_RESP = 0x0343,
+    IOTYPE_USER_IPCAM_FORMATEXTSTORAGE_REQ = 0x0380,
+    IOTYPE_USER_IPCAM_FORMATEXTSTORAGE_RESP = 0x0381,
+    IOTYPE_USER_IPCAM_GET_TIMEZONE_REQ = 0x03A0,
+    IOTYPE_USER_IPCAM_GET_TIMEZONE_RESP = 0x03A1,
+    IOTYPE_USER_IPCAM_SET_TIMEZONE_REQ = 0x03B0,
+    IOTYPE_USER_IPCAM_SET_TIMEZONE_RESP = 0x03B1,
+    IOTYPE_USER_IPCAM_EVENT_REPORT = 0x1FFF,
+};
+
+/// SMsgAVIoctrlPlayRecord command
+enum : uint32_t {
+    AVIOCTRL_RECORD_PLAY_PAUSE = 0x00,
+    AVIOCTRL_RECORD_PLAY_STOP = 0x01,
+    AVIOCTRL_RECORD_PLAY_STEPFORWARD = 0x02,
+    AVIOCTRL_RECORD_PLAY_STEPBACKWARD = 0x03,
+    AVIOCTRL_RECORD_PLAY_FORWARD = 0x04,        // Param is the speed multiple
+    AVIOCTRL_RECORD_PLAY_BACKWARD = 0x05,
+    AVIOCTRL_RECORD_PLAY_SEEKTIME = 0x06,       // Param is the offset from the beginning (ms)
+    AVIOCTRL_RECORD_PLAY_END = 0x07,            // Sent by the camera when the file ends
+    AVIOCTRL_RECORD_PLAY_START = 0x10,          // result of the reply is the AV channel of the playback
+};
+
+/// SMsgAVIoctrlSetStreamCtrlReq quality
+enum : uint8_t {
+    AVIOCTRL_QUALITY_UNKNOWN = 0x00,
+    AVIOCTRL_QUALITY_MAX = 0x01,
+    AVIOCTRL_QUALITY_HIGH = 0x02,
+    AVIOCTRL_QUALITY_MIDDLE = 0x03,
+    AVIOCTRL_QUALITY_LOW = 0x04,
+    AVIOCTRL_QUALITY_MIN = 0x05,
+};
+
+// MARK: Common
+
+struct STimeDay
+{
+    uint16_t year;
+    uint8_t month;          // 1 ~ 12
+    uint8_t day;            // 1 ~ 31
+    uint8_t wday;           // 0: Sunday ~ 6: Saturday
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+};
+
+using STimeDayCodec = Codec<STimeDay,
+                            Member<&STimeDay::year>,
+                            Member<&STimeDay::month>,
+                            Member<&STimeDay::day>,
+                            Member<&STimeDay::wday>,
+                            Member<&STimeDay::hour>,
+                            Member<&STimeDay::minute>,
+                            Member<&STimeDay::second>>;
+
+/// Reply of most set commands
+struct SMsgAVIoctrlResult
+{
+    int32_t result;         // 0: success, otherwise failed
+};
+
+using SMsgAVIoctrlResultCodec = Codec<SMsgAVIoctrlResult,
+                                      Member<&SMsgAVIoctrlResult::result>,
+                                      Reserved<SMsgAVIoctrlResult, 4>>;
+
+// MARK: Stream start / stop
+
+struct SMsgAVIoctrlAVStream
+{
+    uint32_t channel;
+};
+
+using SMsgAVIoctrlAVStreamCodec = Codec<SMsgAVIoctrlAVStream,
+                                        Member<&SMsgAVIoctrlAVStream::channel>,
+                                        Reserved<SMsgAVIoctrlAVStream, 4>>;
+
+using StartStream = Message<IOTYPE_USER_IPCAM_START, SMsgAVIoctrlAVStreamCodec>;
+using StopStream = Message<IOTYPE_USER_IPCAM_STOP, SMsgAVIoctrlAVStreamCodec>;
+using StartAudio = Message<IOTYPE_USER_IPCAM_AUDIOSTART, SMsgAVIoctrlAVStreamCodec>;
+using StopAudio = Message<IOTYPE_USER_IPCAM_AUDIOSTOP, SMsgAVIoctrlAVStreamCodec>;
+
+// MARK: Event list
+
+struct SMsgAVIoctrlListEventReq
+{
+    uint32_t channel;
+    STimeDay startTime;
+    STimeDay endTime;
+    uint8_t event;          // CAMEventType
+    uint8_t status;
+};
+
+using SMsgAVIoctrlListEventReqCodec = Codec<SMsgAVIoctrlListEventReq,
+                                            Member<&SMsgAVIoctrlListEventReq::channel>,
+                                            Nested<&SMsgAVIoctrlListEventReq::startTime, STimeDayCodec>,
+                                            Nested<&SMsgAVIoctrlListEventReq::endTime, STimeDayCodec>,
+                                            Member<&SMsgAVIoctrlListEventReq::event>,
+                                            Member<&SMsgAVIoctrlListEventReq::status>,
+                                            Reserved<SMsgAVIoctrlListEventReq, 2>>;
+
+/// Fixed part of the reply, followed by count SAvEvent
+struct SMsgAVIoctrlListEventResp
+{
+    uint32_t channel;
+    uint32_t total;         // Number of replies for this request
+    uint8_t index;          // Index of this reply, 0,1,2...
+    uint8_t endflag;        // 1 means this reply is the last one
+    uint8_t count;          // Number of SAvEvent in this reply
+};
+
+using SMsgAVIoctrlListEventRespCodec = Codec<SMsgAVIoctrlListEventResp,
+                                             Member<&SMsgAVIoctrlListEventResp::channel>,
+                                             Member<&SMsgAVIoctrlListEventResp::total>,
+                                             Member<&SMsgAVIoctrlListEventResp::index>,
+                                             Member<&SMsgAVIoctrlListEventResp::endflag>,
+                                             Member<&SMsgAVIoctrlListEventResp::count>,
+                                             Reserved<SMsgAVIoctrlListEventResp, 1>>;
+
+struct SAvEvent
+{
+    STimeDay time;
+    uint8_t event;
+    uint8_t status;
+};
+
+using SAvEventCodec = Codec<SAvEvent,
+                            Nested<&SAvEvent::time, STimeDayCodec>,
+                            Member<&SAvEvent::event>,
+                            Member<&SAvEvent::status>,
+                            Reserved<SAvEvent, 2>>;
+
+using ListEvent = Message<IOTYPE_USER_IPCAM_LISTEVENT_REQ, SMsgAVIoctrlListEventReqCodec,
+                          IOTYPE_USER_IPCAM_LISTEVENT_RESP, SMsgAVIoctrlListEventRespCodec>;
+
+// MARK: Playback
+
+struct SMsgAVIoctrlPlayRecord
+{
+    uint32_t channel;
+    uint32_t command;       // AVIOCTRL_RECORD_PLAY_*
+    uint32_t param;
+    STimeDay time;          // Event time of the video
+};
+
+using SMsgAVIoctrlPlayRecordCodec = Codec<SMsgAVIoctrlPlayRecord,
+                                          Member<&SMsgAVIoctrlPlayRecord::channel>,
+                                          Member<&SMsgAVIoctrlPlayRecord::command>,
+                                          Member<&SMsgAVIoctrlPlayRecord::param>,
+                                          Nested<&SMsgAVIoctrlPlayRecord::time, STimeDayCodec>,
+                                          Reserved<SMsgAVIoctrlPlayRecord, 4>>;
+
+struct SMsgAVIoctrlPlayRecordResp
+{
+    uint32_t command;
+    int32_t result;         // AVIOCTRL_RECORD_PLAY_START: AV channel of the playback if >= 0
+};
+
+using SMsgAVIoctrlPlayRecordRespCodec = Codec<SMsgAVIoctrlPlayRecordResp,
+                                              Member<&SMsgAVIoctrlPlayRecordResp::command>,
+                                              Member<&SMsgAVIoctrlPlayRecordResp::result>,
+                                              Reserved<SMsgAVIoctrlPlayRecordResp, 4>>;
+
+using PlayRecord = Message<IOTYPE_USER_IPCAM_RECORD_PLAYCONTROL, SMsgAVIoctrlPlayRecordCodec,
+                           IOTYPE_USER_IPCAM_RECORD_PLAYCONTROL_RESP, SMsgAVIoctrlPlayRecordRespCodec>;
+
+// MARK: Stream quality
+
+struct SMsgAVIoctrlStreamCtrl
+{
+    uint32_t channel;
+    uint8_t quality;        // AVIOCTRL_QUALITY_*
+};
+
+using SMsgAVIoctrlStreamCtrlCodec = Codec<SMsgAVIoctrlStreamCtrl,
+                                          Member<&SMsgAVIoctrlStreamCtrl::channel>,
+                                          Member<&SMsgAVIoctrlStreamCtrl::quality>,
+                                          Reserved<SMsgAVIoctrlStreamCtrl, 3>>;
+
+using SetStreamCtrl = Message<IOTYPE_USER_IPCAM_SETSTREAMCTRL_REQ, SMsgAVIoctrlStreamCtrlCodec,
+                              IOTYPE_USER_IPCAM_SETSTREAMCTRL_RESP, SMsgAVIoctrlResultCodec>;
+using GetStreamCtrl = Message<IOTYPE_USER_IPCAM_GETSTREAMCTRL_REQ, SMsgAVIoctrlAVStreamCodec,
+                              IOTYPE_USER_IPCAM_GETSTREAMCTRL_RESP, SMsgAVIoctrlStreamCtrlCodec>;
+
+// MARK: Device
+
+struct SMsgAVIoctrlDeviceInfoResp
+{
+    char model[16];
+    char vendor[16];
+    uint32_t version;
+    uint32_t channel;
+    uint32_t total;         // SD card size (MB)
+    uint32_t free;          // SD card free size (MB)
+};
+
+using SMsgAVIoctrlDeviceInfoRespCodec = Codec<SMsgAVIoctrlDeviceInfoResp,
+                                              Member<&SMsgAVIoctrlDeviceInfoResp::model>,
+                                              Member<&SMsgAVIoctrlDeviceInfoResp::vendor>,
+                                              Member<&SMsgAVIoctrlDeviceInfoResp::version>,
+                                              Member<&SMsgAVIoctrlDeviceInfoResp::channel>,
+                                              Member<&SMsgAVIoctrlDeviceInfoResp::total>,
+                                              Member<&SMsgAVIoctrlDeviceInfoResp::free>,
+                                              Reserved<SMsgAVIoctrlDeviceInfoResp, 8>>;
+
+struct SMsgAVIoctrlDeviceInfoReq {};
+
+using SMsgAVIoctrlDeviceInfoReqCodec = Codec<SMsgAVIoctrlDeviceInfoReq, Reserved<SMsgAVIoctrlDeviceInfoReq, 4>>;
+
+using DeviceInfo = Message<IOTYPE_USER_IPCAM_DEVINFO_REQ, SMsgAVIoctrlDeviceInfoReqCodec,
+                           IOTYPE_USER_IPCAM_DEVINFO_RESP, SMsgAVIoctrlDeviceInfoRespCodec>;
+
+struct SMsgAVIoctrlSetPasswdReq
+{
+    char oldPassword[32];
+    char newPassword[32];
+};
+
+using SMsgAVIoctrlSetPasswdReqCodec = Codec<SMsgAVIoctrlSetPasswdReq,
+                                            Member<&SMsgAVIoctrlSetPasswdReq::oldPassword>,
+                                            Member<&SMsgAVIoctrlSetPasswdReq::newPassword>>;
+
+using SetPassword = Message<IOTYPE_USER_IPCAM_SETPASSWORD_REQ, SMsgAVIoctrlSetPasswdReqCodec,
+                            IOTYPE_USER_IPCAM_SETPASSWORD_RESP, SMsgAVIoctrlResultCodec>;
+
+struct SMsgAVIoctrlFormatExtStorageReq
+{
+    uint32_t storage;       // 0: SD card
+};
+
+using SMsgAVIoctrlFormatExtStorageReqCodec = Codec<SMsgAVIoctrlFormatExtStorageReq,
+                                                   Member<&SMsgAVIoctrlFormatExtStorageReq::storage>,
+                                                   Reserved<SMsgAVIoctrlFormatExtStorageReq, 4>>;
+
+using FormatExtStorage = Message<IOTYPE_USER_IPCAM_FORMATEXTSTORAGE_REQ, SMsgAVIoctrlFormatExtStorageReqCodec,
+                                 IOTYPE_USER_IPCAM_FORMATEXTSTORAGE_RESP, SMsgAVIoctrlResultCodec>;
+
+// MARK: Time zone
+
+struct SMsgAVIoctrlTimeZone
+{
+    uint32_t cbSize;                // Size of this struct (268)
+    int32_t isSupportTimeZone;
+    int32_t gmtDiff;                // Difference to GMT (minutes)
+    char timeZoneString[256];       // URL encoded, e.g. %2B04%3A00
+};
+
+using SMsgAVIoctrlTimeZoneCodec = Codec<SMsgAVIoctrlTimeZone,
+                                        Member<&SMsgAVIoctrlTimeZone::cbSize>,
+                                        Member<&SMsgAVIoctrlTimeZone::isSupportTimeZone>,
+                                        Member<&SMsgAVIoctrlTimeZone::gmtDiff>,
+                                        Member<&SMsgAVIoctrlTimeZone::timeZoneString>>;
+
+static_assert(SMsgAVIoctrlTimeZoneCodec::size == 268, "SMsgAVIoctrlTimeZone is 268 bytes");
+
+using GetTimeZone = Message<IOTYPE_USER_IPCAM_GET_TIMEZONE_REQ, SMsgAVIoctrlTimeZoneCodec,
+                            IOTYPE_USER_IPCAM_GET_TIMEZONE_RESP, SMsgAVIoctrlTimeZoneCodec>;
+using SetTimeZone = Message<IOTYPE_USER_IPCAM_SET_TIMEZONE_REQ, SMsgAVIoctrlTimeZoneCodec,
+                            IOTYPE_USER_IPCAM_SET_TIMEZONE_RESP, SMsgAVIoctrlTimeZoneCodec>;
+
+// MARK: Wi-Fi
+
+struct SMsgAVIoctrlListWifiApReq {};
+
+using SMsgAVIoctrlListWifiApReqCodec = Codec<SMsgAVIoctrlListWifiApReq, Reserved<SMsgAVIoctrlListWifiApReq, 4>>;
+
+/// Fixed part of the reply, followed by number SWifiAp
+struct SMsgAVIoctrlListWifiApResp
+{
+    uint32_t number;
+};
+
+using SMsgAVIoctrlListWifiApRespCodec = Codec<SMsgAVIoctrlListWifiApResp,
+                                              Member<&SMsgAVIoctrlListWifiApResp::number>>;
+
+struct SWifiAp
+{
+    char ssid[32];
+    uint8_t mode;
+    uint8_t enctype;
+    uint8_t signal;         // 0 ~ 100
+    uint8_t status;         // 1: connected
+};
+
+using SWifiApCodec = Codec<SWifiAp,
+                           Member<&SWifiAp::ssid>,
+                           Member<&SWifiAp::mode>,
+                           Member<&SWifiAp::enctype>,
+                           Member<&SWifiAp::signal>,
+                           Member<&SWifiAp::status>>;
+
+using ListWifiAp = Message<IOTYPE_USER_IPCAM_LISTWIFIAP_REQ, SMsgAVIoctrlListWifiApReqCodec,
+                           IOTYPE_USER_IPCAM_LISTWIFIAP_RESP, SMsgAVIoctrlListWifiApRespCodec>;
+
+struct SMsgAVIoctrlSetWifiReq
+{
+    char ssid[32];
+    char password[32];
+    uint8_t mode;
+    uint8_t enctype;
+};
+
+using SMsgAVIoctrlSetWifiReqCodec = Codec<SMsgAVIoctrlSetWifiReq,
+                                          Member<&SMsgAVIoctrlSetWifiReq::ssid>,
+                                          Member<&SMsgAVIoctrlSetWifiReq::password>,
+                                          Member<&SMsgAVIoctrlSetWifiReq::mode>,
+                                          Member<&SMsgAVIoctrlSetWifiReq::enctype>,
+                                          Reserved<SMsgAVIoctrlSetWifiReq, 10>>;
+
+using SetWifi = Message<IOTYPE_USER_IPCAM_SETWIFI_REQ, SMsgAVIoctrlSetWifiReqCodec,
+                        IOTYPE_USER_IPCAM_SETWIFI_RESP, SMsgAVIoctrlResultCodec>;
+
+// MARK: Event report
+
+/// Sent by the camera without a request
+struct SMsgAVIoctrlEvent
+{
+    STimeDay time;
+    uint32_t utcTime;       // Seconds since 1970
+    uint32_t channel;
+    uint32_t event;         // CAMEventType
+};
+
+using SMsgAVIoctrlEventCodec = Codec<SMsgAVIoctrlEvent,
+                                     Nested<&SMsgAVIoctrlEvent::time, STimeDayCodec>,
+                                     Member<&SMsgAVIoctrlEvent::utcTime>,
+                                     Member<&SMsgAVIoctrlEvent::channel>,
+                                     Member<&SMsgAVIoctrlEvent::event>,
+                                     Reserved<SMsgAVIoctrlEvent, 4>>;
+
+// MARK: Vendor
+
+/// Reply of the FOTA result command, see CAMFOTAResultInfo for the values
+struct SMsgFOTAResult
+{
+    int32_t result;
+    int32_t reserved;
+};
+
+using SMsgFOTAResultCodec = Codec<SMsgFOTAResult,
+                                  Member<&SMsgFOTAResult::result>,
+                                  Member<&SMsgFOTAResult::reserved>>;
+
+/// Reply of the sensor detail command, see CAMSensorDetailInfo
+struct SMsgSensorDetail
+{
+    int32_t event1;
+    int32_t event2;
+    int32_t event3;
+    int32_t motionValue;
+    int32_t pirValue;
+    int32_t soundValue;
+};
+
+using SMsgSensorDetailCodec = Codec<SMsgSensorDetail,
+                                    Member<&SMsgSensorDetail::event1>,
+                                    Member<&SMsgSensorDetail::event2>,
+                                    Member<&SMsgSensorDetail::event3>,
+                                    Member<&SMsgSensorDetail::motionValue>,
+                                    Member<&SMsgSensorDetail::pirValue>,
+                                    Member<&SMsgSensorDetail::soundValue>>;
+
+} // namespace ioctrl
+} // namespace cam
+
+#endif /* CameraCore_IoctrlMessages_h */
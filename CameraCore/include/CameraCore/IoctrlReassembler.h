@@ -0,0 +1,76 @@
+//
+//  IoctrlReassembler.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_IoctrlReassembler_h
+#define CameraCore_IoctrlReassembler_h
+
+#include <cstdint>
+#include <memory>
+
+#include "CameraCore/SessionMemory.h"
+#include "CameraCore/Span.h"
+
+namespace cam {
+
+class IoctrlQueue;
+class Transport;
+
+/**
+ Collect the packages of a multi-package IO control reply (AMEGIA_SMsgAVIoctrlDataC)
+ into one buffer. The buffer is kept between replies, so a reassembler reused for polling
+ does not allocate once it has seen the largest reply.
+ */
+class IoctrlReassembler
+{
+public:
+    /// Size of the package header, see ioctrl::DataPackageHeader
+    static constexpr size_t kHeaderSize = 8;
+
+    /// @param memory Memory of the session the buffer is allocated from, nullptr for the heap
+    explicit IoctrlReassembler(uint32_t maxTotal = 1024 * 1024, std::shared_ptr<SessionMemory> memory = nullptr);
+
+    /**
+     Add the next package
+
+     @return 1 if the reply is complete, 0 if more packages are expected,
+     #kErrBadPackage if the package does not continue the reply, #kErrMemoryBudget if the memory of the
+     session has no room for the reply (the reassembler is reset)
+     */
+    int add(ConstByteSpan package);
+
+    /// The reply, valid after add returned 1 and until the next add or reset
+    ConstByteSpan data() const { return ConstByteSpan{buffer_.data(), received_}; }
+
+    void reset();
+
+    /// Release the buffer kept for the next reply
+    void shrink();
+
+private:
+    SessionBytes buffer_;
+    uint32_t maxTotal_;
+    uint32_t total_ = 0;
+    uint32_t received_ = 0;
+    unsigned nextIndex_ = 0;
+    bool complete_ = false;
+};
+
+/**
+ Receive IO controls of an AV channel until a complete multi-package reply of the type arrives,
+ IO controls of other types are skipped.
+
+ @return Size of the reply if return value >= 0, error code if return value < 0
+ */
+int recvReassembled(Transport &transport, int avIndex, uint32_t type, IoctrlReassembler &reassembler, int timeoutMs);
+
+/// recvReassembled from the IO controls of an IoctrlChannel
+int recvReassembled(IoctrlQueue &queue, uint32_t type, IoctrlReassembler &reassembler, int timeoutMs);
+
+} // namespace cam
+
+#endif /* CameraCore_IoctrlReassembler_h */
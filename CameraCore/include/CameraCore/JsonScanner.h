@@ -0,0 +1,58 @@
+//
+//  JsonScanner.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_JsonScanner_h
+#define CameraCore_JsonScanner_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CameraCore/Span.h"
+
+namespace cam {
+
+/// Deepest object / array nesting scanJson follows
+constexpr int kMaxJsonDepth = 16;
+
+enum class JsonType { Int, Bool, Double, String };
+
+/**
+ A value to read from a Json document. The value member of the type is written, other members are
+ left unchanged.
+ */
+struct JsonField
+{
+    const char *path = nullptr;     // Key path, e.g. "video.bitrate" or "wifi.list.0.ssid"
+    JsonType type = JsonType::Int;
+
+    int64_t intValue = 0;           // JsonType::Int, a number without fraction or exponent
+    bool boolValue = false;         // JsonType::Bool
+    double doubleValue = 0;         // JsonType::Double, any number
+    char *string = nullptr;         // JsonType::String, caller provided storage of stringSize bytes,
+    size_t stringSize = 0;          //   unescaped, NUL terminated and truncated if too long
+
+    bool found = false;             // [out] The path exists and the value has the type
+};
+
+/**
+ Read fields from a Json document in one pass without building it in memory and without allocating.
+ Subtrees no field path leads into are skipped without being parsed, and scanning stops as soon as
+ every field is found, so the rest of the document is not looked at.
+
+ Keys are compared as they are written in the document, a key containing escapes only matches a
+ path with the same escapes. Array elements are addressed by their index as a path component.
+ The found member of every field is set, a field whose value has another type is not found.
+
+ @return Number of fields found if return value >= 0,
+ #kErrBadPackage if the document is malformed or nested deeper than #kMaxJsonDepth before every field was found
+ */
+int scanJson(ConstByteSpan json, JsonField *fields, size_t count);
+
+} // namespace cam
+
+#endif /* CameraCore_JsonScanner_h */
@@ -0,0 +1,92 @@
+//
+//  JsonSettings.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_JsonSettings_h
+#define CameraCore_JsonSettings_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CameraCore/IoctrlChannel.h"
+#include "CameraCore/IoctrlReassembler.h"
+#include "CameraCore/JsonScanner.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/// One Json settings command of an exchange
+struct JsonCommand
+{
+    const char *json = nullptr;         // Request, sent with its terminating NUL
+    JsonField *fields = nullptr;        // Fields read from the reply with scanJson
+    size_t fieldCount = 0;
+    int result = 0;                     // [out] Number of fields found if >= 0, error code if < 0
+};
+
+/**
+ Sends Json settings commands (cameraSetting) and reads typed fields from the replies.
+
+ The camera answers one command per IO control, so several commands are batched by pipelining:
+ up to pipelineDepth requests are sent before the first reply is awaited and the next one is sent
+ as soon as a reply arrives. This needs no firmware support, it relies on the camera answering
+ the commands of an AV channel in order, which it does as it handles them one at a time.
+
+ Each multi-package reply is reassembled into a buffer kept between exchanges and scanned in place,
+ a poll that repeats the same commands does not allocate.
+
+ The settings commands are vendor commands, their IO control types are given by the caller
+ (see IoctrlMessages.h). The replies are read from the IoctrlChannel of the AV channel, which other users
+ of the channel share. One JsonSettings per AV channel, used from one thread.
+ */
+class JsonSettings
+{
+public:
+    static constexpr size_t kDefaultPipelineDepth = 4;
+
+    /**
+     @param control Reader of the AV channel the commands are sent on
+     @param requestType IO control type of the request
+     @param responseType IO control type of the reply
+     @param pipelineDepth Most commands sent and not answered yet
+     */
+    JsonSettings(IoctrlChannel &control, uint32_t requestType, uint32_t responseType,
+                 size_t pipelineDepth = kDefaultPipelineDepth);
+
+    /**
+     Send the commands and read the fields of each reply, the result of every command is set.
+
+     After an error no more commands are sent and the commands not answered get the error. The replies
+     are told apart by their order only, so the replies of commands still in flight are awaited and
+     discarded by the next exchange before it sends anything: if they do not arrive within its timeout
+     it sends nothing and every command gets #kErrTimeout. Replies missing for 10 s without any reply
+     on the channel are taken as lost and no longer awaited.
+
+     @param timeoutMs Time for the whole exchange
+     @return #kNoError if every command was answered with a well-formed reply, the error of the first
+     failed command if return value < 0, #kErrInvalidArg if a request is longer than an IO control
+     (nothing is sent)
+     */
+    int exchange(JsonCommand *commands, size_t count, int timeoutMs);
+
+private:
+    int discardLateReplies(int timeoutMs);
+
+    Transport &transport_;
+    const int avIndex_;
+    const uint32_t requestType_;
+    const uint32_t responseType_;
+    const size_t pipelineDepth_;
+    IoctrlQueue replies_;
+    IoctrlReassembler reassembler_;
+    size_t lateReplies_ = 0;            // Commands of a failed exchange that were not answered
+    uint64_t lastActivity_ = 0;         // monotonicMicros() of the last request or reply
+};
+
+} // namespace cam
+
+#endif /* CameraCore_JsonSettings_h */
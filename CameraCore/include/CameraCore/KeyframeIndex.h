@@ -0,0 +1,111 @@
+//
+//  KeyframeIndex.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_KeyframeIndex_h
+#define CameraCore_KeyframeIndex_h
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CameraCore/FrameFile.h"
+
+namespace cam {
+
+struct KeyframeEntry
+{
+    uint64_t offset;            // Byte offset of the frame record (header) in the file
+    uint32_t timestamp;         // Time from the beginning of the video (ms)
+    uint32_t size;              // Size of the keyframe (bytes)
+};
+
+/**
+ Keyframes of a frame file sorted by offset and timestamp.
+ It is saved next to the video as "<file name>.kfi" together with the size and modification time of
+ the video, an index whose video changed since is stale and not loaded.
+ */
+class KeyframeIndex
+{
+public:
+    std::vector<KeyframeEntry> entries;
+    uint32_t duration = 0;      // Timestamp of the last frame (ms)
+
+    static std::string indexPath(const std::string &videoPath) { return videoPath + ".kfi"; }
+
+    /**
+     The last keyframe at or before a time, i.e. where decoding starts to show that time
+
+     @return nullptr if the index is empty
+     */
+    const KeyframeEntry *findAtOrBefore(uint32_t timestamp) const;
+
+    /**
+     Save to indexPath(videoPath), the file is replaced atomically
+
+     @return #kNoError if successful, #kErrIO if a file can not be read or written
+     */
+    int save(const std::string &videoPath) const;
+
+    /**
+     Load from indexPath(videoPath)
+
+     @return #kNoError if successful, #kErrNotFound if there is no index or it is stale, #kErrIO if the file is corrupted
+     */
+    int load(const std::string &videoPath);
+};
+
+/**
+ Build the index of a frame file while it is written or downloaded. The bytes of the file are fed in
+ order in chunks of any size, record headers split between chunks are handled.
+ */
+class KeyframeIndexBuilder
+{
+public:
+    /**
+     Feed the next bytes of the file
+
+     @return false once the bytes are not a frame file, later bytes are ignored
+     */
+    bool feed(ConstByteSpan data);
+
+    /// Add a frame whose record was written at offset, for writers that do not feed the bytes
+    void addFrame(uint64_t offset, const FrameInfo &info, uint32_t size);
+
+    bool valid() const { return valid_; }
+
+    /// Bytes fed so far
+    uint64_t offset() const { return offset_; }
+
+    const KeyframeIndex &index() const { return index_; }
+
+private:
+    void addRecord(uint64_t offset, const FrameRecordHeader &header);
+
+    KeyframeIndex index_;
+    uint8_t header_[FrameRecordHeaderCodec::size];
+    size_t headerFill_ = 0;
+    uint64_t offset_ = 0;
+    uint64_t skip_ = 0;             // Frame bytes left before the next record
+    uint64_t recordOffset_ = 0;
+    bool haveBase_ = false;
+    uint32_t base_ = 0;
+    bool valid_ = true;
+};
+
+/**
+ Get the index of a frame file: the saved index if it is up to date, otherwise the file is scanned
+ once and the index is saved for the next time.
+
+ @param scanned [out] Optional, set to true if the file was scanned
+ @return #kNoError if successful, #kErrIO if the file can not be read or is not a frame file
+ */
+int loadKeyframeIndex(const std::string &videoPath, KeyframeIndex &index, bool *scanned = nullptr);
+
+} // namespace cam
+
+#endif /* CameraCore_KeyframeIndex_h */
@@ -0,0 +1,78 @@
+//
+//  MeteredTransport.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_MeteredTransport_h
+#define CameraCore_MeteredTransport_h
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "CameraCore/ClockSync.h"
+#include "CameraCore/FrameTrace.h"
+#include "CameraCore/Metrics.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/**
+ A Transport that records the SessionMetrics of the transport it wraps: IO control acknowledgment time,
+ received frames and bytes, first frame after a channel is opened and the path type.
+ With a FrameTrace it records the Received trace point of every frame, with a ClockSync the frame latency.
+ The engines of the core use it like the transport itself, they do not know about metrics.
+ */
+class MeteredTransport : public Transport
+{
+public:
+    MeteredTransport(std::unique_ptr<Transport> transport, SessionMetrics &metrics);
+
+    int openChannel(int channel, const std::string &account, const std::string &password) override;
+    void closeChannel(int avIndex) override;
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) override;
+    int recvIOCtrl(int avIndex, uint32_t *type, ByteSpan buffer, int timeoutMs) override;
+    int recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs) override;
+    PathType pathType() const override { return transport_->pathType(); }
+
+    Transport &wrapped() { return *transport_; }
+
+    /// Record frame trace points into trace, set before frames are received. Has no effect without CAMCORE_FRAME_TRACE.
+    void setFrameTrace(FrameTrace *trace) { trace_ = trace; }
+
+    /// Record the latency of every received frame in the frameLatency of the metrics while clock is accurate
+    /// enough, nullptr to stop. The clock outlives the transport
+    void setClockSync(const ClockSync *clock) { clock_.store(clock, std::memory_order_release); }
+
+private:
+    std::unique_ptr<Transport> transport_;
+    SessionMetrics &metrics_;
+    FrameTrace *trace_ = nullptr;
+    std::atomic<const ClockSync *> clock_{nullptr};
+};
+
+/// A Connector that records connect time, reconnects and the path type into the metrics of each UID
+class MeteredConnector : public Connector
+{
+public:
+    /// @param metricsForUid Returns the metrics of a UID, called on every connect
+    MeteredConnector(Connector &connector, std::function<SessionMetrics &(const std::string &uid)> metricsForUid);
+
+    std::unique_ptr<Transport> connect(const std::string &uid, int timeoutMs, int *error) override;
+
+private:
+    Connector &connector_;
+    std::function<SessionMetrics &(const std::string &uid)> metricsForUid_;
+    std::mutex mutex_;
+    std::map<std::string, bool> connectedBefore_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_MeteredTransport_h */
@@ -0,0 +1,211 @@
+//
+//  Metrics.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  Performance counters of a session and its AV channels.
+//  Counters and histograms are plain atomics updated with relaxed operations, recording never takes a lock
+//  and taking a snapshot does not stall the receive threads. A snapshot is not one consistent cut across
+//  all counters, each value is exact on its own.
+//
+
+#ifndef CameraCore_Metrics_h
+#define CameraCore_Metrics_h
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Metrics need lock free 64 bit atomics");
+
+struct HistogramSnapshot
+{
+    /// Bucket upper bounds (ms), the last bucket counts everything above the last bound
+    static constexpr std::array<double, 13> kBounds = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+    std::array<uint64_t, kBounds.size() + 1> counts{};
+    uint64_t count = 0;
+    double min = 0;         // ms
+    double max = 0;         // ms
+    double mean = 0;        // ms
+
+    /**
+     Estimate a percentile from the buckets
+
+     @param percentile Between 0 and 100
+     @return The upper bound of the bucket holding the percentile (max for the last bucket), 0 if empty
+     */
+    double valueAtPercentile(double percentile) const;
+};
+
+/// Latency distribution with the fixed buckets of HistogramSnapshot
+class LatencyHistogram
+{
+public:
+    void recordMicros(uint64_t us);
+    void record(double ms) { recordMicros(ms <= 0 ? 0 : uint64_t(ms * 1000)); }
+
+    HistogramSnapshot snapshot() const;
+    void reset();
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::kBounds.size() + 1> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+struct ChannelSnapshot
+{
+    int avIndex = -1;
+    uint64_t time = 0;                  // monotonicMicros() of the snapshot
+    uint64_t framesReceived = 0;
+    uint64_t framesDropped = 0;
+    uint64_t bytesReceived = 0;
+    double fps = 0;                     // Since the previous snapshot of a MetricsReporter, 0 for pull snapshots
+    double bitrate = 0;                 // kbit per second, like fps
+    uint64_t qualitySwitches = 0;       // QualityController switches
+    int qualityLevel = -1;              // Level of the last switch, -1 before the first
+    HistogramSnapshot firstFrameLatency;
+    HistogramSnapshot firstKeyframeLatency;
+    HistogramSnapshot frameInterval;
+};
+
+/// Counters of one AV channel
+class ChannelMetrics
+{
+public:
+    explicit ChannelMetrics(int avIndex) : avIndex_(avIndex) {}
+
+    int avIndex() const { return avIndex_; }
+
+    /// The stream was (re)started, the next frame is recorded in firstFrameLatency
+    void streamStarted(uint64_t now);
+    void frameReceived(uint32_t bytes, uint64_t now);
+    void frameDropped(uint64_t count = 1) { framesDropped_.fetch_add(count, std::memory_order_relaxed); }
+    void qualitySwitched(int level);
+
+    LatencyHistogram firstFrameLatency;     // Stream start to first video frame
+    LatencyHistogram firstKeyframeLatency;  // fastStart call to first keyframe, one record per start
+    LatencyHistogram frameInterval;         // Time between received video frames
+
+    ChannelSnapshot snapshot() const;
+    void reset();
+
+private:
+    int avIndex_;
+    std::atomic<uint64_t> framesReceived_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> bytesReceived_{0};
+    std::atomic<uint64_t> lastFrame_{0};
+    std::atomic<uint64_t> streamStart_{0};
+    std::atomic<uint64_t> qualitySwitches_{0};
+    std::atomic<int> qualityLevel_{-1};
+};
+
+struct SessionSnapshot
+{
+    uint64_t time = 0;
+    PathType pathType = PathType::Unknown;
+    uint32_t reconnectCount = 0;
+    uint64_t ioctrlCount = 0;
+    HistogramSnapshot connectLatency;
+    HistogramSnapshot ioctrlAckLatency;
+    HistogramSnapshot frameLatency;
+    std::vector<ChannelSnapshot> channels;
+};
+
+/**
+ Counters of one IOTC session, the AV channels have their own ChannelMetrics.
+ The ChannelMetrics of an avIndex is created once and kept until the session metrics are destroyed,
+ so the receive path finds it with two atomic loads and a closed channel never leaves a dangling reference.
+ */
+class SessionMetrics
+{
+public:
+    /// AV channel IDs are below AV_MAX_CHANNEL, larger IDs share one ChannelMetrics that is not reported
+    static constexpr int kMaxChannels = 64;
+
+    SessionMetrics() = default;
+    ~SessionMetrics();
+
+    SessionMetrics(const SessionMetrics &) = delete;
+    SessionMetrics &operator=(const SessionMetrics &) = delete;
+
+    void connected(PathType pathType, uint64_t micros, bool reconnect);
+    void ioctrlAcknowledged(uint64_t micros);
+    void setPathType(PathType pathType) { pathType_.store(int(pathType), std::memory_order_relaxed); }
+
+    LatencyHistogram connectLatency;        // Connect call to session established
+    LatencyHistogram ioctrlAckLatency;      // IO control send to acknowledgment
+    LatencyHistogram frameLatency;          // Camera timestamp to arrival of the frames of all channels, see ClockSync
+
+    /// The AV channel was opened, its counters are created on first use and reported until removeChannel.
+    /// Out of range IDs get counters that are not reported
+    ChannelMetrics &addChannel(int avIndex);
+
+    /// The counters of an open AV channel, nullptr for a channel not added or removed
+    ChannelMetrics *channel(int avIndex);
+
+    /// The AV channel was closed, its counters are reset and no longer reported or found until addChannel
+    void removeChannel(int avIndex);
+
+    SessionSnapshot snapshot() const;
+    void reset();
+
+private:
+    std::atomic<int> pathType_{int(PathType::Unknown)};
+    std::atomic<uint32_t> reconnectCount_{0};
+    std::atomic<uint64_t> ioctrlCount_{0};
+
+    std::array<std::atomic<ChannelMetrics *>, kMaxChannels> channels_{};
+    std::array<std::atomic<bool>, kMaxChannels> active_{};
+    ChannelMetrics overflow_{-1};
+};
+
+/**
+ Push snapshots of a session to a callback periodically on its own thread, fps and bitrate are computed
+ between consecutive snapshots. Stops when destroyed.
+ */
+class MetricsReporter
+{
+public:
+    using Callback = std::function<void(const SessionSnapshot &)>;
+
+    /// @param intervalMs Time between reports, minimum 100
+    MetricsReporter(const SessionMetrics &metrics, int intervalMs, Callback callback);
+    ~MetricsReporter();
+
+    MetricsReporter(const MetricsReporter &) = delete;
+    MetricsReporter &operator=(const MetricsReporter &) = delete;
+
+    /// Compute fps and bitrate of current from previous
+    static void computeRates(const SessionSnapshot &previous, SessionSnapshot &current);
+
+private:
+    void run();
+
+    const SessionMetrics &metrics_;
+    int intervalMs_;
+    Callback callback_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_Metrics_h */
@@ -0,0 +1,189 @@
+//
+//  PlaybackControl.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_PlaybackControl_h
+#define CameraCore_PlaybackControl_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/IoctrlChannel.h"
+#include "CameraCore/IoctrlMessages.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/// A received frame kept in memory
+struct BufferedFrame
+{
+    FrameInfo info;
+    std::vector<uint8_t> data;
+};
+
+/**
+ SD card playback of one recording with seek, fast-forward and prefetch of the next recording.
+
+ Commands are sent with IOTYPE_USER_IPCAM_RECORD_PLAYCONTROL on the AV channel of the live view
+ (the control channel) and their replies are read from its IoctrlChannel, the video is received on the AV
+ channel the camera opens for the playback.
+ Above 1x only keyframes are delivered, so fast-forward does not need the frames in between
+ and the decoder never sees a frame whose reference was dropped.
+
+ Prefetch starts the next recording on its own AV channel and buffers its first frames on a
+ background thread. playPrefetched() stops the current recording and hands the prefetched AV channel
+ over to this object: the new avIndex is returned and the buffered frames are delivered first.
+
+ Calls except recvFrame must come from one thread, recvFrame is called by the receive thread.
+ */
+class PlaybackControl
+{
+public:
+    static constexpr size_t kMaxFrameSize = 512 * 1024;
+
+    /**
+     @param control Reader of the AV channel of the live view, the commands are sent on it
+     @param channel Camera channel of the recordings
+     @param account View account used to start the playback AV channel
+     @param password View password used to start the playback AV channel
+     */
+    PlaybackControl(IoctrlChannel &control, int channel, std::string account, std::string password);
+
+    /// Stops the playback and the prefetch and closes their AV channels
+    ~PlaybackControl();
+
+    PlaybackControl(const PlaybackControl &) = delete;
+    PlaybackControl &operator=(const PlaybackControl &) = delete;
+
+    /**
+     Start the playback of a recording, a playback already running is stopped first
+
+     @param recordTime Event time of the recording
+     @return AV channel ID of the playback if return value >= 0, error code if return value < 0
+     */
+    int start(const ioctrl::STimeDay &recordTime, int timeoutMs);
+
+    /**
+     Pause or resume the playback, the camera toggles between the two
+
+     @return #kNoError if successful, error code if return value < 0
+     */
+    int pause(int timeoutMs);
+
+    /**
+     Stop the playback and close its AV channel, the prefetch is kept
+
+     @return #kNoError if successful, error code if return value < 0
+     */
+    int stop(int timeoutMs);
+
+    /**
+     Seek to a time offset. Frames still in flight from before the seek are dropped,
+     delivery continues with the first keyframe received after the command is sent.
+
+     @param offsetMs Offset from the beginning of the recording (ms)
+     @return #kNoError if successful, error code if return value < 0
+     */
+    int seek(uint32_t offsetMs, int timeoutMs);
+
+    /**
+     Set the playback speed
+
+     @param speed 1, 2, 4 or 8, above 1 only keyframes are delivered
+     @return #kNoError if successful, #kErrInvalidArg for other speeds, error code if return value < 0
+     */
+    int setSpeed(unsigned speed, int timeoutMs);
+
+    unsigned speed() const { return speed_.load(std::memory_order_relaxed); }
+
+    /// AV channel ID of the playback, -1 if not playing
+    int playbackAvIndex() const { return playbackAvIndex_.load(std::memory_order_acquire); }
+
+    /// The camera reported AVIOCTRL_RECORD_PLAY_END for the current recording, whether or not a command was waiting
+    bool ended() const { return ended_.load(std::memory_order_relaxed); }
+
+    /**
+     Receive the next frame of the playback, buffered frames of a prefetch come first
+
+     @return Size of the frame if return value >= 0, error code if return value < 0.
+             A frame too large for buffer is dropped like Transport::recvFrame drops it
+     */
+    int recvFrame(ByteSpan buffer, FrameInfo *info, int timeoutMs);
+
+    /**
+     Start the next recording on its own AV channel and buffer up to maxBytes of its frames.
+     A previous prefetch is stopped.
+
+     @return AV channel ID of the prefetch if return value >= 0, error code if return value < 0
+     */
+    int prefetch(const ioctrl::STimeDay &nextRecordTime, size_t maxBytes, int timeoutMs);
+
+    /**
+     Stop the current recording and continue with the prefetched one.
+     The AV channel of the current recording is closed, recvFrame continues on the returned one.
+
+     @return AV channel ID of the playback if return value >= 0, #kErrNotFound without prefetch
+     */
+    int playPrefetched(int timeoutMs);
+
+    /// Bytes buffered by the prefetch
+    size_t prefetchedBytes() const;
+
+private:
+    struct Prefetch
+    {
+        ioctrl::STimeDay recordTime{};
+        int avIndex = -1;
+        std::thread thread;
+        std::atomic<bool> stop{false};
+        mutable std::mutex mutex;
+        std::deque<BufferedFrame> frames;
+        size_t bytes = 0;
+    };
+
+    void replyReceived(ConstByteSpan data);
+    int command(uint32_t command, uint32_t param, const ioctrl::STimeDay &recordTime, int32_t *result, int timeoutMs);
+    int startRecording(const ioctrl::STimeDay &recordTime, int timeoutMs);
+    void stopRecording(int avIndex, const ioctrl::STimeDay &recordTime, int timeoutMs);
+    void stopPrefetch(bool stopRecording, int timeoutMs);
+    static void prefetchLoop(Transport &transport, Prefetch &prefetch, size_t maxBytes);
+    bool accept(const FrameInfo &info);
+
+    IoctrlChannel &control_;
+    Transport &transport_;
+    int avIndex_;
+    int channel_;
+    std::string account_;
+    std::string password_;
+
+    ioctrl::STimeDay recordTime_{};
+    std::atomic<int> playbackAvIndex_{-1};
+    std::atomic<unsigned> speed_{1};
+    std::atomic<bool> ended_{false};
+    std::atomic<bool> awaitKeyframe_{false};
+
+    int subscription_ = -1;
+    std::mutex replyMutex_;
+    std::condition_variable replied_;
+    std::deque<ioctrl::SMsgAVIoctrlPlayRecordResp> replies_;     // Replies except PLAY_END
+    int replyError_ = 0;                                        // The error of the transport once the reader stopped
+
+    std::mutex bufferedMutex_;
+    std::deque<BufferedFrame> buffered_;
+    std::unique_ptr<Prefetch> prefetch_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_PlaybackControl_h */
@@ -0,0 +1,169 @@
+//
+//  QualityControl.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_QualityControl_h
+#define CameraCore_QualityControl_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CameraCore/JsonSettings.h"
+#include "CameraCore/Metrics.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/// A stream quality the controller can switch to
+struct QualityLevel
+{
+    uint32_t bitrate = 0;           // Expected kbit per second of the stream
+    uint8_t quality = 0;            // AVIOCTRL_QUALITY_* sent with SETSTREAMCTRL
+    std::string setting;            // cameraSetting command sent instead of SETSTREAMCTRL if not empty
+};
+
+struct QualityControlConfig
+{
+    /// Lowest to highest bitrate, not empty. The stream is expected to run at the highest one when the controller starts
+    std::vector<QualityLevel> levels;
+
+    // Down: the queueing delay stays over downDelayMs for downHoldMs, the new level fits in downRatio of the goodput
+    double downRatio = 0.8;
+    int downDelayMs = 500;
+    int downHoldMs = 3000;
+    // Up one level: the queueing delay stays under upDelayMs for upHoldMs, doubled (up to 8 times) after
+    // every up switch that had to be undone within upHoldMs
+    int upDelayMs = 100;
+    int upHoldMs = 15000;
+    int holdOffMs = 10000;              // No switch after a switch
+
+    int intervalMs = 500;               // Evaluation period of QualityController, the goodput is averaged over it
+};
+
+/// A quality switch, see QualityController
+struct QualitySwitch
+{
+    uint64_t time = 0;                  // monotonicMicros()
+    int fromLevel = 0;
+    int toLevel = 0;
+    double goodput = 0;                 // Estimated kbit per second when switching
+    double queueDelayMs = 0;            // Estimated queueing delay when switching
+    int result = 0;                     // Error code of the command, the level is kept if < 0
+};
+
+/**
+ Estimates goodput and queueing delay of a stream from the frames on the receive path and decides the quality
+ level, with hysteresis. The decision only, QualityController sends the commands. Not thread safe.
+
+ The goodput is an EWMA of the received kbit per evaluation period. The queueing delay is how much later a
+ frame arrived than the earliest frame of the last 60 s, relative to their camera timestamps: frames that
+ wait in a queue somewhere arrive late for their timestamp. The window follows the drift of the camera clock,
+ which would otherwise add up to a queueing delay of hundreds of ms within hours.
+ */
+class QualityEstimator
+{
+public:
+    explicit QualityEstimator(const QualityControlConfig &config);
+
+    /// @param timestamp FrameInfo timestamp (ms), @param localUs monotonicMicros() of the arrival
+    void frameReceived(uint32_t bytes, uint32_t timestamp, uint64_t localUs);
+
+    /// Evaluate once per period, @return The level to switch to, level() to stay
+    int update(uint64_t now);
+
+    /// A switch to level was made at now (level() again if it failed), the hold times start over
+    void switched(int level, uint64_t now);
+
+    int level() const { return level_; }
+    double goodput() const { return goodput_; }
+    double queueDelayMs() const { return queueDelayMs_; }
+
+private:
+    const QualityControlConfig config_;
+    int level_;
+
+    uint64_t bytes_ = 0;                // Since the last update
+    uint64_t lastUpdate_ = 0;
+    double goodput_ = 0;
+    bool hasGoodput_ = false;
+
+    bool hasFrame_ = false;
+    uint64_t firstLocal_ = 0;
+    uint32_t firstTimestamp_ = 0;
+    int64_t lastTimestamp_ = 0;         // ms since firstTimestamp_
+    std::deque<std::pair<uint64_t, int64_t>> latenessMinima_;  // Second of the arrival, least lateness in it
+    int64_t minLateness_ = 0;           // ms, arrival minus timestamp of the earliest frame in the window
+    double queueDelayMs_ = 0;
+
+    uint64_t highSince_ = 0;            // Queueing delay over downDelayMs since, 0 if not
+    uint64_t lowSince_ = 0;             // Queueing delay under upDelayMs since, 0 if not
+    uint64_t holdUntil_ = 0;
+    uint64_t lastUp_ = 0;
+    int upBackoff_ = 1;
+};
+
+/**
+ Switches the quality of a live stream by the link throughput. The receive path calls frameReceived() for every
+ video frame; a thread evaluates every intervalMs and sends the switch on the AV channel of the stream:
+ IOTYPE_USER_IPCAM_SETSTREAMCTRL_REQ with the quality of the level, or the cameraSetting command of the level
+ through settings. The camera stays on the same AV channel and session, nothing is reopened.
+
+ Every switch is counted in the ChannelMetrics of the channel and given to onSwitch on the controller thread,
+ a switch whose command failed is given to onSwitch with result < 0 and not counted. Stops when destroyed.
+ */
+class QualityController
+{
+public:
+    using Callback = std::function<void(const QualitySwitch &)>;
+
+    /**
+     @param avIndex AV channel of the stream
+     @param channel Camera channel of SETSTREAMCTRL
+     @param settings Sends the levels with a setting, used from the controller thread only. nullptr if no level has one
+     @param metrics Counts the switches, nullptr for none
+     */
+    QualityController(Transport &transport, int avIndex, int channel, QualityControlConfig config,
+                      JsonSettings *settings = nullptr, ChannelMetrics *metrics = nullptr, Callback onSwitch = nullptr);
+    ~QualityController();
+
+    QualityController(const QualityController &) = delete;
+    QualityController &operator=(const QualityController &) = delete;
+
+    /// A video frame was received, from the receive thread
+    void frameReceived(uint32_t bytes, const FrameInfo &info);
+
+    int level() const;
+
+private:
+    int apply(const QualityLevel &level);
+    void run();
+
+    Transport &transport_;
+    const int avIndex_;
+    const int channel_;
+    const QualityControlConfig config_;
+    JsonSettings *settings_;
+    ChannelMetrics *metrics_;
+    Callback onSwitch_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable stopped_;
+    QualityEstimator estimator_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_QualityControl_h */
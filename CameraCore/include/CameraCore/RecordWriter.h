@@ -0,0 +1,150 @@
+//
+//  RecordWriter.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_RecordWriter_h
+#define CameraCore_RecordWriter_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Span.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+struct RecordWriterConfig
+{
+    size_t blockSize = 256 * 1024;              // Size and file alignment of the writes, rounded up to 4096
+    size_t maxBytesInFlight = 64 * 1024 * 1024; // Frame bytes accepted and not yet written, of all recordings
+    int flushInterval = 1000;                   // Partial blocks are written after this time (ms), 0 only on flush / close / a full budget
+    unsigned queueDepth = 64;                   // Writes submitted at once
+    bool useIoUring = true;                     // Use io_uring on Linux if the kernel allows it, pwrite otherwise
+};
+
+struct RecordWriterStats
+{
+    uint64_t framesQueued = 0;      // Accepted by write, on disk after the next full block, flush or close
+    uint64_t framesDropped = 0;     // Dropped because maxBytesInFlight was reached, and the frames up to the next keyframe
+    uint64_t bytesWritten = 0;
+    uint64_t writes = 0;            // Block writes
+    uint64_t syscalls = 0;          // pwrite or io_uring_enter calls
+    size_t bytesInFlight = 0;
+    size_t peakBytesInFlight = 0;
+    bool ioUring = false;
+};
+
+/**
+ One writer for many recordings at the same time, e.g. one per connected camera.
+
+ Each frame is appended as a FrameFile.h record to the block buffer of its recording. Full blocks are
+ written at block aligned file offsets by one I/O thread shared by all recordings, in batches of up to
+ queueDepth writes per system call with io_uring, one pwrite each otherwise. So a recording costs one
+ write per blockSize bytes instead of one per frame.
+
+ Memory is bounded by maxBytesInFlight: a frame that does not fit is dropped and counted, and its
+ recording drops the frames up to the next keyframe so the file never holds a frame whose reference
+ is missing. The partial blocks of all recordings count against it too, they are written when a frame
+ is dropped so the budget frees up even without a flush interval. The keyframe index of each recording is built while writing and saved as the .kfi
+ sidecar (KeyframeIndex.h) on close, so the recording is never scanned.
+
+ All functions can be called from any thread, frames of one recording must come from one thread at a time.
+ */
+class RecordWriter
+{
+public:
+    explicit RecordWriter(RecordWriterConfig config = RecordWriterConfig());
+
+    /// Closes the recordings still open
+    ~RecordWriter();
+
+    RecordWriter(const RecordWriter &) = delete;
+    RecordWriter &operator=(const RecordWriter &) = delete;
+
+    /**
+     Create or truncate a recording file
+
+     @return Recording ID if return value >= 0, #kErrIO if the file can not be created
+     */
+    int open(const std::string &path);
+
+    /**
+     Queue a frame, it does not wait for the disk
+
+     @return #kNoError if queued, #kErrMemoryBudget if dropped, #kErrNotFound for an unknown ID,
+             #kErrIO after a write of the recording failed
+     */
+    int write(int id, const FrameInfo &info, ConstByteSpan data);
+
+    /**
+     Write the buffered frames of a recording and wait until they are written
+
+     @return #kNoError if successful, #kErrNotFound for an unknown ID, #kErrIO if a write failed
+     */
+    int flush(int id);
+
+    /**
+     Write the buffered frames, close the file and save its keyframe index
+
+     @return #kNoError if successful, #kErrNotFound for an unknown ID, #kErrIO if a write failed
+     */
+    int close(int id);
+
+    RecordWriterStats stats() const;
+
+private:
+    struct Block;
+    struct Recording;
+    struct Operation;
+    class Uring;
+
+    std::shared_ptr<Recording> find(int id) const;
+    void append(const std::shared_ptr<Recording> &recording, const uint8_t *data, size_t size);
+    void submit(const std::shared_ptr<Recording> &recording, const std::shared_ptr<Block> &block, size_t end);
+    void flushLocked(const std::shared_ptr<Recording> &recording);
+    void flushAll();
+    int waitWritten(Recording &recording);
+    void run();
+    void writeBatch(std::vector<Operation> &batch);
+    void writeSync(Operation &operation, size_t done);
+    void complete(Operation &operation, bool ok);
+
+    const RecordWriterConfig config_;
+    std::unique_ptr<Uring> uring_;
+
+    mutable std::mutex mutex_;
+    std::map<int, std::shared_ptr<Recording>> recordings_;
+    int nextId_ = 0;
+
+    std::mutex queueMutex_;
+    std::condition_variable queueChanged_;
+    std::condition_variable written_;
+    std::vector<Operation> queue_;
+    bool flushRequested_ = false;       // The budget refused a frame, the I/O thread writes the partial blocks
+    bool stop_ = false;
+
+    std::atomic<size_t> bytesInFlight_{0};
+    std::atomic<size_t> peakBytesInFlight_{0};
+    std::atomic<uint64_t> framesQueued_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<uint64_t> writes_{0};
+    std::atomic<uint64_t> syscalls_{0};
+
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_RecordWriter_h */
@@ -0,0 +1,138 @@
+//
+//  Session.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_Session_h
+#define CameraCore_Session_h
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/DecodePool.h"
+#include "CameraCore/FrameHub.h"
+#include "CameraCore/FrameTrace.h"
+#include "CameraCore/IoctrlChannel.h"
+#include "CameraCore/MeteredTransport.h"
+#include "CameraCore/Metrics.h"
+#include "CameraCore/SessionMemory.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+struct SessionConfig
+{
+    std::string account = "admin";
+    std::string password = "admin";
+    size_t memoryBudget = 0;            // SessionMemory budget of all channels, 0 is no limit
+    FrameTrace *trace = nullptr;        // Trace points of all channels, nullptr for none. It outlives the session
+};
+
+struct ChannelConfig
+{
+    /// Decode the frames on the pool, the hub gets the decoded frames. Without a pool the hub gets the encoded frames.
+    DecodePool *pool = nullptr;
+    std::unique_ptr<VideoDecoder> decoder;
+    StreamPriority priority = StreamPriority::Visible;
+    size_t maxFrameSize = 512 * 1024;   // Receive buffer, larger frames are dropped
+};
+
+/**
+ One IOTC session and the AV channels received over it. A multi-channel device (CMADeviceInfo channel)
+ is connected once and any number of its camera channels are received at the same time: each gets its
+ own avIndex, receive thread, FrameHub and ChannelMetrics, and they all share the transport, the
+ SessionMetrics and the SessionMemory of the session.
+
+ The receive thread of a channel only receives frames, the stream is started with IO controls on
+ transport() like for a single channel session, e.g. with StreamDemand. Frames the memory budget
+ has no room for are dropped and counted in the ChannelMetrics. With a FrameTrace every frame is
+ traced from Received to Delivered, the publish to the hub of its channel.
+
+ All functions can be called from any thread.
+ */
+class Session
+{
+public:
+    /**
+     Connect to camera, one P2P handshake for all its channels
+
+     @param error [out] Error code if nullptr is returned
+     */
+    static std::unique_ptr<Session> connect(Connector &connector, const std::string &uid, SessionConfig config,
+                                            int timeoutMs, int *error);
+
+    Session(std::unique_ptr<Transport> transport, SessionConfig config);
+
+    /// Closes the channels
+    ~Session();
+
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    /**
+     Open a camera channel and start receiving its frames
+
+     @return AV channel ID if return value >= 0, error code if return value < 0,
+             #kErrInvalidArg if the channel is open already or config has a pool but no decoder
+     */
+    int openChannel(int channel, ChannelConfig config = ChannelConfig());
+
+    /// Stop receiving and close the AV channel, @return #kNoError if successful, #kErrNotFound for an unknown avIndex
+    int closeChannel(int avIndex);
+
+    /// The AV channel IDs of the open channels, in opening order
+    std::vector<int> openChannels() const;
+
+    /// The camera channel of an AV channel, #kErrNotFound for an unknown avIndex
+    int cameraChannel(int avIndex) const;
+
+    /// The frames of an AV channel, nullptr for an unknown avIndex
+    std::shared_ptr<FrameHub> hub(int avIndex) const;
+
+    /// #kNoError while the channel receives, the error of the transport once its receive thread stopped
+    int channelError(int avIndex) const;
+
+    /// The transport of the session, recording metrics, for the IO controls of all channels
+    Transport &transport() { return transport_; }
+
+    /**
+     The reader of the IO controls of an AV channel, started by the first call. The DeviceMessages, JsonSettings
+     and PlaybackControl of the channel share it, they must be destroyed before the channel is closed.
+
+     @return nullptr for an unknown avIndex
+     */
+    IoctrlChannel *ioctrl(int avIndex);
+
+    /// Measure the frame latency of all channels into metrics() with the camera clock, see MeteredTransport::setClockSync
+    void setClockSync(const ClockSync *clock) { transport_.setClockSync(clock); }
+
+    SessionMetrics &metrics() { return metrics_; }
+    const std::shared_ptr<SessionMemory> &memory() const { return memory_; }
+
+private:
+    struct Channel;
+
+    void receive(Channel &channel);
+    void stop(Channel &channel);
+
+    const SessionConfig config_;
+    SessionMetrics metrics_;
+    MeteredTransport transport_;
+    const std::shared_ptr<SessionMemory> memory_;
+
+    std::mutex openMutex_;              // Held by openChannel from the check for an open channel to the insert
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Channel>> channels_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_Session_h */
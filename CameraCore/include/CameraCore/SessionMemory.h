@@ -0,0 +1,169 @@
+//
+//  SessionMemory.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_SessionMemory_h
+#define CameraCore_SessionMemory_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace cam {
+
+struct SessionMemoryStats
+{
+    size_t budget = 0;              // 0 is no limit
+    size_t used = 0;                // Bytes of the blocks in use, headers and rounding included
+    size_t reserved = 0;            // Bytes taken from the heap, chunks and large blocks, counted against the budget
+    size_t peakReserved = 0;
+    uint64_t allocations = 0;
+    uint64_t refused = 0;           // Allocations refused by the budget
+    uint64_t trims = 0;             // Chunks returned to the heap by trim
+};
+
+/**
+ The memory of one session: frame data, frame queues and reassembly buffers of the session and its
+ AV channels are allocated here instead of the heap.
+
+ Small blocks are carved from chunks of chunkSize and kept in free lists by size class when released,
+ so a running stream reuses the same chunks and does not touch the heap. Blocks larger than a quarter
+ of a chunk are allocated on their own and returned to the heap when released.
+
+ The budget is checked whenever memory is taken from the heap. Chunks without blocks in use are
+ returned first (trim), when that is not enough the allocation fails and the caller drops frames,
+ see DecodePool::submit. All chunks are released at once with the last reference to the
+ SessionMemory, the blocks are never freed one by one.
+
+ All functions can be called from any thread.
+ */
+class SessionMemory
+{
+public:
+    static constexpr size_t kDefaultChunkSize = 1024 * 1024;
+
+    explicit SessionMemory(size_t budget = 0, size_t chunkSize = kDefaultChunkSize);
+
+    /// Releases all chunks
+    ~SessionMemory();
+
+    SessionMemory(const SessionMemory &) = delete;
+    SessionMemory &operator=(const SessionMemory &) = delete;
+
+    /// @return The block, 16 byte aligned, nullptr if the budget does not allow it
+    void *allocate(size_t size);
+
+    /// Return a block of allocate, size is the size it was allocated with
+    void deallocate(void *block, size_t size);
+
+    /// Return the chunks without blocks in use to the heap, @return Bytes returned
+    size_t trim();
+
+    /// 0 is no limit, a smaller budget than the memory in use refuses allocations until enough is released
+    void setBudget(size_t budget);
+
+    SessionMemoryStats stats() const;
+
+private:
+    struct Chunk;
+    struct Header;
+    struct FreeBlock;
+
+    static constexpr size_t kClassCount = 16;
+
+    size_t classOf(size_t size) const;
+    bool fits(size_t size);
+    void *allocateSmall(size_t size, size_t sizeClass);
+    void *allocateLarge(size_t size);
+    size_t trimLocked();
+
+    const size_t chunkSize_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    Chunk *current_ = nullptr;                      // The chunk new blocks are carved from
+    std::array<FreeBlock *, kClassCount> free_{};
+    SessionMemoryStats stats_;
+};
+
+/**
+ Allocator of SessionMemory for the standard containers. Without a SessionMemory it uses the heap.
+ A refused allocation throws std::bad_alloc like a failing heap, the users of SessionMemory catch it
+ and drop the data, see assignSessionBytes.
+ */
+template <typename T>
+class SessionAllocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    SessionAllocator() = default;
+    explicit SessionAllocator(std::shared_ptr<SessionMemory> memory) : memory_(std::move(memory)) {}
+
+    template <typename U>
+    SessionAllocator(const SessionAllocator<U> &other) : memory_(other.memory())
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        if (!memory_) {
+            return std::allocator<T>().allocate(count);
+        }
+        void *block = memory_->allocate(count * sizeof(T));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(block);
+    }
+
+    void deallocate(T *block, size_t count)
+    {
+        if (!memory_) {
+            std::allocator<T>().deallocate(block, count);
+            return;
+        }
+        memory_->deallocate(block, count * sizeof(T));
+    }
+
+    const std::shared_ptr<SessionMemory> &memory() const { return memory_; }
+
+    template <typename U>
+    bool operator==(const SessionAllocator<U> &other) const
+    {
+        return memory_ == other.memory();
+    }
+
+    template <typename U>
+    bool operator!=(const SessionAllocator<U> &other) const
+    {
+        return memory_ != other.memory();
+    }
+
+private:
+    // Blocks keep the memory of their session alive, frames may outlive the session
+    std::shared_ptr<SessionMemory> memory_;
+};
+
+using SessionBytes = std::vector<uint8_t, SessionAllocator<uint8_t>>;
+
+/**
+ Fill buffer with a copy of data, allocated from the memory of buffer
+
+ @return false if the budget refused the memory, buffer is empty then
+ */
+bool assignSessionBytes(SessionBytes &buffer, const uint8_t *data, size_t size);
+
+} // namespace cam
+
+#endif /* CameraCore_SessionMemory_h */
@@ -0,0 +1,134 @@
+//
+//  SimulatedDevice.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  A camera that runs in process behind Connector and Transport, for benchmarks and tests without
+//  cameras or the P2P service. It answers the IO controls of IoctrlMessages.h like the firmware does,
+//  streams generated H.264 frames on live view and plays recordings back, with simulated one way delay,
+//  jitter, frame loss and bandwidth.
+//
+
+#ifndef CameraCore_SimulatedDevice_h
+#define CameraCore_SimulatedDevice_h
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CameraCore/Bitstream.h"
+#include "CameraCore/IoctrlMessages.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+/// A recording on the simulated SD card
+struct SimulatedRecording
+{
+    ioctrl::STimeDay time{};        // Event time, the key of LISTEVENT and RECORD_PLAYCONTROL
+    uint8_t event = 0;              // CAMEventType
+    uint32_t duration = 10000;      // Length of a generated recording (ms)
+    std::string path;               // FrameFile.h recording to play, empty to generate frames like the live view
+};
+
+struct SimulatorConfig
+{
+    std::string uid = "SIMULATOR00000000001";
+    std::string account = "admin";
+    std::string password = "admin";
+    int channels = 1;               // Camera channels with live view
+
+    // Video
+    uint16_t codecId = kCodecH264;
+    int fps = 15;
+    int gop = 30;                   // Frames from one keyframe to the next
+    uint32_t keyframeSize = 120000; // bytes at AVIOCTRL_QUALITY_MAX, smaller qualities send smaller frames
+    uint32_t frameSize = 12000;
+    int firstKeyframe = 0;          // Live view frames before the first keyframe, like an encoder joined mid GOP
+    uint32_t keyframeRequestType = 0;   // Vendor IO control that makes the next live frame a keyframe, 0 for none
+
+    // Recordings
+    std::vector<SimulatedRecording> recordings;
+    bool pacedPlayback = true;      // false sends playback frames as fast as the bandwidth allows, like a download
+
+    // Network
+    PathType pathType = PathType::LAN;
+    int connectTime = 0;            // Time of a connect in addition to one round trip (ms)
+    int delay = 0;                  // One way delay (ms)
+    int jitter = 0;                 // Random extra delay of each frame and reply, 0 to jitter (ms)
+    double lossRate = 0;            // Frames lost, between 0 and 1
+    uint32_t bandwidth = 0;         // Frame download kbit per second, 0 is unlimited
+    uint32_t seed = 1;              // Random seed of loss and jitter
+};
+
+/**
+ The simulated camera, connect() opens a session to it. Sessions stay usable while the device exists.
+
+ Live view starts with IOTYPE_USER_IPCAM_START on the AV channel of a camera channel. The frames are
+ Annex B H.264 access units: a keyframe every gop frames (IDR, nal_ref_idc 3), the others are
+ reference P frames (nal_ref_idc 2), sized by keyframeSize / frameSize and the SETSTREAMCTRL quality.
+ The first keyframe is frame firstKeyframe, keyframeRequestType moves the GOP to start at the next frame.
+ A lost frame is skipped, the next frame number shows the gap.
+
+ Playback follows PlaybackControl: RECORD_PLAYCONTROL START answers with the camera channel of the
+ recording, which is then opened with openChannel. PAUSE, FORWARD (1 to 8), SEEKTIME and STOP work on it,
+ AVIOCTRL_RECORD_PLAY_END is sent on the control AV channel when the recording ends.
+ */
+class SimulatedDevice : public Connector
+{
+public:
+    /// Camera channel of the first playback, the following playbacks count up
+    static constexpr int kPlaybackChannelBase = 100;
+
+    explicit SimulatedDevice(SimulatorConfig config);
+    ~SimulatedDevice() override;
+
+    SimulatedDevice(const SimulatedDevice &) = delete;
+    SimulatedDevice &operator=(const SimulatedDevice &) = delete;
+
+    /**
+     Connect after connectTime plus one round trip
+
+     @param error [out] #kErrNotFound for another uid
+     */
+    std::unique_ptr<Transport> connect(const std::string &uid, int timeoutMs, int *error) override;
+
+    const SimulatorConfig &config() const { return config_; }
+
+    /// Send IOTYPE_USER_IPCAM_EVENT_REPORT on every open AV channel of a camera channel
+    void reportEvent(uint32_t channel, uint32_t event);
+
+    /// Frames delivered to receivers
+    uint64_t framesSent() const { return framesSent_.load(std::memory_order_relaxed); }
+
+    /// Frames dropped by lossRate
+    uint64_t framesLost() const { return framesLost_.load(std::memory_order_relaxed); }
+
+    uint64_t sessionCount() const { return sessionCount_.load(std::memory_order_relaxed); }
+
+    /// Quality last set with SETSTREAMCTRL on a camera channel
+    uint8_t quality(int channel) const;
+
+private:
+    class Session;
+    class SessionTransport;
+
+    const SimulatorConfig config_;
+    std::atomic<uint64_t> framesSent_{0};
+    std::atomic<uint64_t> framesLost_{0};
+    std::atomic<uint64_t> sessionCount_{0};
+    std::atomic<int> nextPlaybackChannel_{kPlaybackChannelBase};
+
+    mutable std::mutex mutex_;
+    std::vector<std::weak_ptr<Session>> sessions_;
+    std::vector<uint8_t> quality_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_SimulatedDevice_h */
@@ -0,0 +1,32 @@
+//
+//  Span.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_Span_h
+#define CameraCore_Span_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cam {
+
+/// A caller owned byte buffer, the core never keeps it after the call returns
+struct ByteSpan
+{
+    uint8_t *data;
+    size_t size;
+};
+
+struct ConstByteSpan
+{
+    const uint8_t *data;
+    size_t size;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_Span_h */
@@ -0,0 +1,114 @@
+//
+//  StreamDemand.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_StreamDemand_h
+#define CameraCore_StreamDemand_h
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+enum class StreamKind { Video = 0, Audio = 1 };
+
+/**
+ Starts the video and audio streams of an AV channel when the first consumer needs them and stops
+ them when the last one is gone.
+
+ Every consumer holds a Token. The first token of a kind sends IOTYPE_USER_IPCAM_START (AUDIOSTART
+ for audio), releasing the last one starts the grace period, and if no token is taken during it
+ IOTYPE_USER_IPCAM_STOP (AUDIOSTOP) is sent by the timer thread. A consumer that comes back within the
+ grace period, e.g. a screen that is pushed and popped, finds the stream running.
+
+ Commands are sent with the lock held, so a START and the STOP of the same kind never overtake each
+ other. All functions can be called from any thread, tokens must be released before the StreamDemand
+ is destroyed.
+ */
+class StreamDemand
+{
+public:
+    /// One consumer of a stream, released on destruction
+    class Token
+    {
+    public:
+        Token() = default;
+        ~Token() { release(); }
+
+        Token(Token &&other) noexcept : demand_(other.demand_), kind_(other.kind_) { other.demand_ = nullptr; }
+        Token &operator=(Token &&other) noexcept;
+
+        Token(const Token &) = delete;
+        Token &operator=(const Token &) = delete;
+
+        void release();
+        bool valid() const { return demand_ != nullptr; }
+
+    private:
+        friend class StreamDemand;
+        Token(StreamDemand *demand, StreamKind kind) : demand_(demand), kind_(kind) {}
+
+        StreamDemand *demand_ = nullptr;
+        StreamKind kind_ = StreamKind::Video;
+    };
+
+    /**
+     @param avIndex AV channel the commands are sent on
+     @param channel Camera channel of the streams
+     @param gracePeriodMs Time without consumers before a stream is stopped
+     */
+    StreamDemand(Transport &transport, int avIndex, int channel, int gracePeriodMs);
+
+    /// Stops the running streams without waiting for the grace period
+    ~StreamDemand();
+
+    StreamDemand(const StreamDemand &) = delete;
+    StreamDemand &operator=(const StreamDemand &) = delete;
+
+    /**
+     Add a consumer, the stream is started if it is not running
+
+     @param token [out] Valid if successful
+     @return #kNoError if successful, error code of sendIOCtrl if the stream could not be started
+     */
+    int acquire(StreamKind kind, Token &token);
+
+    int consumerCount(StreamKind kind) const;
+    bool isStreaming(StreamKind kind) const;
+
+private:
+    struct Stream
+    {
+        int consumers = 0;
+        bool streaming = false;
+        uint64_t stopAt = 0;        // monotonicMicros() the grace period ends, 0 if not stopping
+    };
+
+    void release(StreamKind kind);
+    int send(StreamKind kind, bool start);
+    void run();
+
+    Transport &transport_;
+    const int avIndex_;
+    const int channel_;
+    const uint64_t gracePeriod_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::array<Stream, 2> streams_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_StreamDemand_h */
@@ -0,0 +1,54 @@
+//
+//  Thumbnails.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_Thumbnails_h
+#define CameraCore_Thumbnails_h
+
+#include <string>
+#include <vector>
+
+#include "CameraCore/Image.h"
+#include "CameraCore/KeyframeIndex.h"
+
+namespace cam {
+
+/// Decodes a single keyframe, the platform implements it with its video decoder
+class KeyframeDecoder
+{
+public:
+    virtual ~KeyframeDecoder() = default;
+
+    /**
+     @param codecId FRAMEINFO_t codec ID of the frame
+     @return #kNoError if successful, error code if return value < 0
+     */
+    virtual int decode(uint16_t codecId, ConstByteSpan frame, Image &picture) = 0;
+};
+
+/**
+ Pick up to count keyframes evenly spaced by time over the video, the keyframe at or before each
+ point is used and a keyframe is picked once
+
+ @return Indexes into index.entries in time order
+ */
+std::vector<size_t> selectThumbnailKeyframes(const KeyframeIndex &index, size_t count);
+
+/**
+ Generate a thumbnail strip of a frame file. Only the selected keyframes are read from the file
+ and decoded, each picture is scaled down to fit maxWidth x maxHeight.
+
+ @param thumbnails [out] The thumbnails in time order
+ @return #kNoError if successful, #kErrNotFound if the index has no keyframe, #kErrIO if the file can not be read,
+ error code of the decoder if return value < 0
+ */
+int generateThumbnails(const std::string &videoPath, const KeyframeIndex &index, size_t count, int maxWidth, int maxHeight,
+                       KeyframeDecoder &decoder, std::vector<Image> &thumbnails);
+
+} // namespace cam
+
+#endif /* CameraCore_Thumbnails_h */
@@ -0,0 +1,105 @@
+//
+//  Transport.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+//  The IOTC/AV calls the core is built on. The platform implements Transport on top of the
+//  IOTC and AV modules (IOTC_Connect_ByUID, avClientStart, avSendIOCtrl, avRecvIOCtrl,
+//  avRecvFrameData2), SimulatedDevice implements it in process for tests and benchmarks.
+//  Receive calls that time out return #kErrTimeout (AV_ER_TIMEOUT is mapped by the platform),
+//  so the core can tell an idle channel from a broken one.
+//
+
+#ifndef CameraCore_Transport_h
+#define CameraCore_Transport_h
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "CameraCore/Span.h"
+
+namespace cam {
+
+/// Largest IO control payload of one avSendIOCtrl / avRecvIOCtrl (AV_MAX_IOCTRL_DATA_SIZE)
+constexpr size_t kMaxIoctrlSize = 1024;
+
+enum class PathType { Unknown, LAN, P2P, Relay };
+
+/// FRAMEINFO_t flags
+constexpr uint8_t kFrameFlagKeyframe = 0x01;
+
+struct FrameInfo
+{
+    uint16_t codecId = 0;
+    uint8_t flags = 0;
+    uint8_t channel = 0;
+    uint32_t timestamp = 0;         // Camera time (ms)
+    uint32_t frameNumber = 0;
+
+    bool isKeyframe() const { return (flags & kFrameFlagKeyframe) != 0; }
+};
+
+/**
+ One IOTC session. All functions can be called from any thread, each AV channel is used by one
+ receive thread and any number of IO control senders.
+ */
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+
+    /**
+     Start an AV client on a channel of the session
+
+     @return AV channel ID if return value >= 0, error code if return value < 0
+     */
+    virtual int openChannel(int channel, const std::string &account, const std::string &password) = 0;
+    virtual void closeChannel(int avIndex) = 0;
+
+    /**
+     Send an IO control and wait for the acknowledgment
+
+     @return #kNoError if sending successfully, error code if return value < 0
+     */
+    virtual int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) = 0;
+
+    /**
+     Receive the next IO control of an AV channel
+
+     @param type [out] IO control type
+     @return Size of the data if return value >= 0, error code if return value < 0
+     */
+    virtual int recvIOCtrl(int avIndex, uint32_t *type, ByteSpan buffer, int timeoutMs) = 0;
+
+    /**
+     Receive the next video frame of an AV channel
+
+     @param info [out] Set for a received frame and for a frame too large for buffer
+     @return Size of the frame if return value >= 0, error code if return value < 0.
+             #kErrBufferTooSmall if the frame is larger than buffer, the frame is consumed and dropped
+             like avRecvFrameData2 does, the next call receives the next frame
+     */
+    virtual int recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs) = 0;
+
+    virtual PathType pathType() const = 0;
+};
+
+class Connector
+{
+public:
+    virtual ~Connector() = default;
+
+    /**
+     Connect to camera
+
+     @param error [out] Error code if nullptr is returned
+     */
+    virtual std::unique_ptr<Transport> connect(const std::string &uid, int timeoutMs, int *error) = 0;
+};
+
+} // namespace cam
+
+#endif /* CameraCore_Transport_h */
@@ -0,0 +1,77 @@
+//
+//  Bitstream.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/Bitstream.h"
+
+namespace cam {
+
+namespace {
+
+/// Call fn with each NAL unit header and the bytes up to the end of the frame (at least 1), stop when it returns false
+template <typename Fn>
+void forEachNalUnit(ConstByteSpan frame, Fn &&fn)
+{
+    const uint8_t *p = frame.data;
+    const uint8_t *end = frame.data + frame.size;
+    // Start codes are 00 00 01, the 4 byte form ends the same way
+    while (end - p >= 4) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1) {
+            p += 3;
+            if (!fn(p, size_t(end - p))) {
+                return;
+            }
+        } else {
+            p++;
+        }
+    }
+}
+
+} // namespace
+
+bool isNonReferenceFrame(uint16_t codecId, ConstByteSpan frame, int hevcMaxTemporalId)
+{
+    bool slices = false;
+    bool reference = false;
+    if (codecId == kCodecH264) {
+        forEachNalUnit(frame, [&](const uint8_t *header, size_t) {
+            unsigned type = header[0] & 0x1F;
+            if (type >= 1 && type <= 5) {
+                slices = true;
+                reference = (header[0] & 0x60) != 0;
+            }
+            return !reference;
+        });
+    } else if (codecId == kCodecHEVC) {
+        forEachNalUnit(frame, [&](const uint8_t *header, size_t size) {
+            unsigned type = (header[0] >> 1) & 0x3F;
+            if (type <= 31) {
+                slices = true;
+                int temporalId = size >= 2 ? int(header[1] & 0x07) - 1 : -1;
+                // Even types below 16 are the sub-layer non-reference ones
+                reference = type >= 16 || (type & 1) != 0 || hevcMaxTemporalId < 0 || temporalId != hevcMaxTemporalId;
+            }
+            return !reference;
+        });
+    }
+    return slices && !reference;
+}
+
+int hevcMaxTemporalId(ConstByteSpan frame)
+{
+    int maxTemporalId = -1;
+    forEachNalUnit(frame, [&](const uint8_t *header, size_t size) {
+        // sps_video_parameter_set_id u(4), sps_max_sub_layers_minus1 u(3) right after the NAL unit header
+        if (((header[0] >> 1) & 0x3F) == 33 && size >= 3) {
+            maxTemporalId = (header[2] >> 1) & 0x07;
+        }
+        return maxTemporalId < 0;
+    });
+    return maxTemporalId;
+}
+
+} // namespace cam
@@ -0,0 +1,176 @@
+//
+//  ClockSync.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/ClockSync.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "CameraCore/Clock.h"
+
+namespace cam {
+
+namespace {
+
+/// The drift is applied once the samples span this many times the accuracy, 1 / 10000 is 100 ppm
+constexpr double kMinDriftSpan = 10000;
+
+} // namespace
+
+int64_t ClockEstimate::toCameraMicros(uint64_t localUs) const
+{
+    double elapsed = double(int64_t(localUs - referenceUs));
+    return int64_t(localUs) + std::llround(offsetMs * 1000 + driftPpm * 1e-6 * elapsed);
+}
+
+uint64_t ClockEstimate::toLocalMicros(int64_t cameraUs) const
+{
+    // Camera time elapsed since the reference, in local time
+    double elapsed = double(cameraUs - int64_t(referenceUs)) - offsetMs * 1000;
+    return referenceUs + uint64_t(std::llround(elapsed / (1 + driftPpm * 1e-6)));
+}
+
+int64_t ClockEstimate::frameAgeMicros(uint32_t timestamp, uint64_t localUs) const
+{
+    int64_t now = toCameraMicros(localUs);
+    int64_t nowMs = now / 1000 - (now % 1000 < 0 ? 1 : 0);
+    return int64_t(int32_t(uint32_t(nowMs) - timestamp)) * 1000 + (now - nowMs * 1000);
+}
+
+void ClockEstimator::addSample(uint64_t localSendUs, uint64_t localReceiveUs, const CameraTime &time)
+{
+    // A camera time of a coarse clock stands for the middle of its step
+    double half = double(time.resolutionUs) / 2;
+    double receive = double(time.receiveUs) + half;
+    double send = double(std::max(time.sendUs, time.receiveUs)) + half;
+    double localSend = double(localSendUs);
+    double localReceive = double(std::max(localReceiveUs, localSendUs));
+
+    Sample sample;
+    sample.localUs = (localSend + localReceive) / 2;
+    sample.offsetUs = ((receive - localSend) + (send - localReceive)) / 2;
+    sample.roundTripUs = std::max(0.0, (localReceive - localSend) - (send - receive));
+    sample.errorUs = sample.roundTripUs / 2 + half;
+    samples_.push_back(sample);
+    if (samples_.size() > window_) {
+        samples_.pop_front();
+    }
+    sampleCount_++;
+    update();
+}
+
+void ClockEstimator::reset()
+{
+    samples_.clear();
+    sampleCount_ = 0;
+    estimate_ = ClockEstimate();
+}
+
+void ClockEstimator::update()
+{
+    const Sample &best = *std::min_element(samples_.begin(), samples_.end(),
+                                           [](const Sample &a, const Sample &b) { return a.errorUs < b.errorUs; });
+    // The samples that waited in a queue somewhere are left out
+    double maxError = std::max(best.errorUs * 2, 1.0);
+    double sumW = 0, sumX = 0, sumY = 0;
+    double first = best.localUs, last = best.localUs;
+    for (const Sample &sample : samples_) {
+        if (sample.errorUs <= maxError) {
+            double w = 1 / std::max(sample.errorUs * sample.errorUs, 1.0);
+            sumW += w;
+            sumX += w * sample.localUs;
+            sumY += w * sample.offsetUs;
+            first = std::min(first, sample.localUs);
+            last = std::max(last, sample.localUs);
+        }
+    }
+
+    ClockEstimate estimate;
+    estimate.valid = true;
+    estimate.sampleCount = sampleCount_;
+    estimate.roundTripMs = best.roundTripUs / 1000;
+    estimate.accuracyMs = best.errorUs / 1000;
+    estimate.referenceUs = uint64_t(best.localUs);
+    estimate.offsetMs = best.offsetUs / 1000;
+
+    if (last - first >= kMinDriftSpan * best.errorUs) {
+        double meanX = sumX / sumW, meanY = sumY / sumW;
+        double sxx = 0, sxy = 0;
+        for (const Sample &sample : samples_) {
+            if (sample.errorUs <= maxError) {
+                double w = 1 / std::max(sample.errorUs * sample.errorUs, 1.0);
+                sxx += w * (sample.localUs - meanX) * (sample.localUs - meanX);
+                sxy += w * (sample.localUs - meanX) * (sample.offsetUs - meanY);
+            }
+        }
+        double slope = sxy / sxx;
+        // The line at the newest sample used
+        estimate.referenceUs = uint64_t(last);
+        estimate.offsetMs = (meanY + slope * (last - meanX)) / 1000;
+        estimate.driftPpm = slope * 1e6;
+    }
+    estimate_ = estimate;
+}
+
+ClockSync::ClockSync(CameraClock &clock, ClockSyncConfig config)
+    : clock_(clock), config_(config), estimator_(config.window)
+{
+    thread_ = std::thread(&ClockSync::run, this);
+}
+
+ClockSync::~ClockSync()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stopped_.notify_all();
+    thread_.join();
+}
+
+ClockEstimate ClockSync::estimate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimator_.estimate();
+}
+
+bool ClockSync::frameLatency(uint32_t timestamp, uint64_t localUs, uint64_t *latencyUs) const
+{
+    ClockEstimate current = estimate();
+    if (!current.valid || current.accuracyMs > config_.latencyAccuracyMs) {
+        return false;
+    }
+    int64_t age = current.frameAgeMicros(timestamp, localUs);
+    *latencyUs = age > 0 ? uint64_t(age) : 0;
+    return true;
+}
+
+void ClockSync::run()
+{
+    for (int sample = 0;; sample++) {
+        CameraTime time;
+        uint64_t send = monotonicMicros();
+        int ret = clock_.read(time, config_.timeoutMs);
+        uint64_t receive = monotonicMicros();
+        requests_.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (ret < 0) {
+            failures_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            estimator_.addSample(send, receive, time);
+        }
+        int intervalMs = sample + 1 < config_.initialSamples ? config_.initialIntervalMs : config_.intervalMs;
+        if (stopped_.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return stop_; })) {
+            return;
+        }
+    }
+}
+
+} // namespace cam
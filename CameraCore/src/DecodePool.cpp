@@ -0,0 +1,389 @@
+//
+//  DecodePool.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/DecodePool.h"
+
+#include <algorithm>
+
+#include "CameraCore/Bitstream.h"
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+namespace {
+
+/// Pictures of a session kept for reuse, a consumer holding more is given a new one
+constexpr size_t kPicturesPerSession = 4;
+
+/**
+ Pictures the consumers released. A picture comes back through the deleter of its shared_ptr, so the
+ mutex orders the last reads of the consumer before the worker writes the next picture into it.
+ */
+struct PictureRecycler
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Image>> released;
+};
+
+} // namespace
+
+struct DecodePool::Session
+{
+    Session(int avIndex, FrameHub &hub, std::unique_ptr<VideoDecoder> decoder, StreamPriority priority, FrameTrace *trace,
+            std::shared_ptr<SessionMemory> memory)
+        : avIndex(avIndex), hub(hub), decoder(std::move(decoder)), priority(int(priority)), trace(trace), memory(std::move(memory))
+    {
+    }
+
+    const int avIndex;
+    FrameHub &hub;
+    const std::unique_ptr<VideoDecoder> decoder;
+    std::atomic<int> priority;
+    FrameTrace *const trace;
+    const std::shared_ptr<SessionMemory> memory;
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::deque<std::shared_ptr<Frame>> queue;
+    OutputSize output;
+    bool scheduled = false;         // In a ready queue or being decoded
+    bool running = false;
+    bool awaitKeyframe = false;
+    bool removed = false;
+    int maxTemporalId = -1;         // Of the HEVC SPS of the last keyframe, used by the decoding worker only
+    size_t worker = SIZE_MAX;       // The worker that ran it last
+
+    const std::shared_ptr<PictureRecycler> recycler = std::make_shared<PictureRecycler>();
+
+    LatencyHistogram decodeTime;
+    std::atomic<uint64_t> decoded{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> dropped{0};
+
+    /// A picture no consumer holds any more, or a new one
+    std::shared_ptr<Image> reusablePicture()
+    {
+        std::unique_ptr<Image> picture;
+        {
+            std::lock_guard<std::mutex> lock(recycler->mutex);
+            if (!recycler->released.empty()) {
+                picture = std::move(recycler->released.back());
+                recycler->released.pop_back();
+            }
+        }
+        if (!picture) {
+            picture = std::make_unique<Image>();
+        }
+        std::shared_ptr<PictureRecycler> owner = recycler;
+        return std::shared_ptr<Image>(picture.release(), [owner](Image *image) {
+            std::unique_ptr<Image> released(image);
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            if (owner->released.size() < kPicturesPerSession) {
+                owner->released.push_back(std::move(released));
+            }
+        });
+    }
+};
+
+struct DecodePool::Worker
+{
+    std::mutex mutex;
+    std::array<std::deque<std::shared_ptr<Session>>, kStreamPriorityCount> ready;
+    FrameScaler scaler;
+    std::thread thread;
+};
+
+DecodePool::DecodePool(DecodePoolConfig config) : config_(config)
+{
+    unsigned threads = config_.threads > 0 ? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers_.size(); i++) {
+        workers_[i]->thread = std::thread(&DecodePool::run, this, i);
+    }
+}
+
+DecodePool::~DecodePool()
+{
+    std::vector<int> ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : sessions_) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (int id : ids) {
+        removeSession(id);
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+int DecodePool::addSession(int avIndex, FrameHub &hub, std::unique_ptr<VideoDecoder> decoder, StreamPriority priority,
+                           FrameTrace *trace, std::shared_ptr<SessionMemory> memory)
+{
+    auto session = std::make_shared<Session>(avIndex, hub, std::move(decoder), priority, trace, std::move(memory));
+    std::lock_guard<std::mutex> lock(mutex_);
+    session->worker = nextWorker_++ % workers_.size();
+    sessions_[nextId_] = session;
+    return nextId_++;
+}
+
+void DecodePool::removeSession(int id)
+{
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(id);
+        if (it == sessions_.end()) {
+            return;
+        }
+        session = it->second;
+        sessions_.erase(it);
+    }
+    std::deque<std::shared_ptr<Frame>> released;
+    std::unique_lock<std::mutex> lock(session->mutex);
+    session->removed = true;
+    queued_.fetch_sub(session->queue.size(), std::memory_order_relaxed);
+    released.swap(session->queue);
+    // A ready queue may still hold the session, the worker that takes it finds the queue empty
+    session->idle.wait(lock, [&] { return !session->running; });
+}
+
+std::shared_ptr<DecodePool::Session> DecodePool::find(int id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    return it == sessions_.end() ? nullptr : it->second;
+}
+
+int DecodePool::submit(int id, const FrameInfo &info, ConstByteSpan data)
+{
+    std::shared_ptr<Session> session = find(id);
+    if (!session) {
+        return kErrNotFound;
+    }
+    std::shared_ptr<Frame> frame = makeFrame(session->memory, session->avIndex, info, data);
+    if (!frame) {
+        // The budget of the session is reached, the queued frames give their memory back
+        std::deque<std::shared_ptr<Frame>> released;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->dropped += session->queue.size();
+            queued_.fetch_sub(session->queue.size(), std::memory_order_relaxed);
+            released.swap(session->queue);
+            session->awaitKeyframe = true;
+        }
+        released.clear();
+        if (!info.isKeyframe() || !(frame = makeFrame(session->memory, session->avIndex, info, data))) {
+            session->dropped++;
+            return kErrMemoryBudget;
+        }
+    }
+
+    std::deque<std::shared_ptr<Frame>> released;
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->removed) {
+            return kErrNotFound;
+        }
+        if (session->awaitKeyframe && !info.isKeyframe()) {
+            session->dropped++;
+            return kErrMemoryBudget;
+        }
+        session->awaitKeyframe = false;
+        if (session->queue.size() >= config_.maxQueuedPerSession) {
+            // Later frames reference the dropped ones, decoding resumes at a keyframe
+            session->dropped += session->queue.size();
+            queued_.fetch_sub(session->queue.size(), std::memory_order_relaxed);
+            released.swap(session->queue);
+            if (!info.isKeyframe()) {
+                session->dropped++;
+                session->awaitKeyframe = true;
+                return kErrMemoryBudget;
+            }
+        }
+        session->queue.push_back(std::move(frame));
+        queued_.fetch_add(1, std::memory_order_relaxed);
+        if (!session->scheduled) {
+            session->scheduled = true;
+            schedule = true;
+        }
+    }
+    if (schedule) {
+        this->schedule(session);
+    }
+    return kNoError;
+}
+
+void DecodePool::setPriority(int id, StreamPriority priority)
+{
+    if (std::shared_ptr<Session> session = find(id)) {
+        // Takes effect when the session is queued next
+        session->priority.store(int(priority), std::memory_order_relaxed);
+    }
+}
+
+void DecodePool::setOutputSize(int id, OutputSize output)
+{
+    if (std::shared_ptr<Session> session = find(id)) {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->output = output;
+    }
+}
+
+int DecodePool::sessionStats(int id, DecodeSessionStats &stats) const
+{
+    std::shared_ptr<Session> session = find(id);
+    if (!session) {
+        return kErrNotFound;
+    }
+    stats.framesDecoded = session->decoded.load(std::memory_order_relaxed);
+    stats.framesSkipped = session->skipped.load(std::memory_order_relaxed);
+    stats.framesFailed = session->failed.load(std::memory_order_relaxed);
+    stats.framesDropped = session->dropped.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        stats.queued = session->queue.size();
+    }
+    stats.decodeTime = session->decodeTime.snapshot();
+    return kNoError;
+}
+
+void DecodePool::schedule(const std::shared_ptr<Session> &session)
+{
+    Worker &worker = *workers_[session->worker];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.ready[size_t(session->priority.load(std::memory_order_relaxed))].push_back(session);
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        ready_++;
+    }
+    wake_.notify_one();
+}
+
+std::shared_ptr<DecodePool::Session> DecodePool::take(size_t index)
+{
+    for (size_t p = kStreamPriorityCount; p-- > 0;) {
+        // The own queue from the front, the others from the back
+        for (size_t i = 0; i < workers_.size(); i++) {
+            Worker &worker = *workers_[(index + i) % workers_.size()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            auto &ready = worker.ready[p];
+            if (!ready.empty()) {
+                std::shared_ptr<Session> session;
+                if (i == 0) {
+                    session = std::move(ready.front());
+                    ready.pop_front();
+                } else {
+                    session = std::move(ready.back());
+                    ready.pop_back();
+                }
+                ready_--;
+                return session;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void DecodePool::run(size_t index)
+{
+    Worker &worker = *workers_[index];
+    for (;;) {
+        std::shared_ptr<Session> session = take(index);
+        if (!session) {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wake_.wait(lock, [&] { return stop_ || ready_ > 0; });
+            if (stop_ && ready_ == 0) {
+                return;
+            }
+            continue;
+        }
+        session->worker = index;
+        decodeNext(worker, session);
+    }
+}
+
+void DecodePool::decodeNext(Worker &worker, const std::shared_ptr<Session> &session)
+{
+    std::shared_ptr<Frame> frame;
+    OutputSize output;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->queue.empty()) {
+            session->scheduled = false;
+            return;
+        }
+        frame = std::move(session->queue.front());
+        session->queue.pop_front();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        output = session->output;
+        session->running = true;
+    }
+
+    uint64_t start = monotonicMicros();
+    const FrameInfo &info = frame->info;
+    ConstByteSpan data{frame->data.data(), frame->data.size()};
+    CAM_FRAME_TRACE(session->trace, session->avIndex, info.frameNumber, TraceStage::DecodeStart);
+    if (info.codecId == kCodecHEVC && info.isKeyframe()) {
+        int maxTemporalId = hevcMaxTemporalId(data);
+        if (maxTemporalId >= 0) {
+            session->maxTemporalId = maxTemporalId;
+        }
+    }
+    int maxTemporalId = session->maxTemporalId;
+    if (output.skipsFrame(info.codecId, data, maxTemporalId) ||
+        (session->hub.consumersBehind() && isNonReferenceFrame(info.codecId, data, maxTemporalId))) {
+        session->skipped++;
+    } else {
+        Nv12Picture decoded;
+        if (session->decoder->decode(info.codecId, data, decoded) < 0) {
+            session->failed++;
+        } else {
+            CAM_FRAME_TRACE(session->trace, session->avIndex, info.frameNumber, TraceStage::Decoded);
+            std::shared_ptr<Image> picture = session->reusablePicture();
+            worker.scaler.convert(decoded, output.maxWidth, output.maxHeight, *picture);
+            frame->picture = std::move(picture);
+            CAM_FRAME_TRACE(session->trace, session->avIndex, info.frameNumber, TraceStage::Converted);
+            session->decodeTime.recordMicros(monotonicMicros() - start);
+            session->decoded++;
+            session->hub.publish(frame);
+            CAM_FRAME_TRACE(session->trace, session->avIndex, info.frameNumber, TraceStage::Delivered);
+        }
+    }
+
+    bool reschedule = false;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->running = false;
+        if (session->queue.empty()) {
+            session->scheduled = false;
+        } else {
+            reschedule = true;
+        }
+    }
+    session->idle.notify_all();
+    if (reschedule) {
+        schedule(session);
+    }
+}
+
+} // namespace cam
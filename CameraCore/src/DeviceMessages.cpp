@@ -0,0 +1,196 @@
+//
+//  DeviceMessages.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/DeviceMessages.h"
+
+#include <algorithm>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+namespace {
+
+/// Longest receive, the time it takes the listener to see a stop or a change of setActive
+constexpr int kListenSliceMs = 50;
+
+bool isFotaInProgress(int32_t result)
+{
+    return result == -1 || result == 2 || result == 3 || result == 4;
+}
+
+} // namespace
+
+DeviceMessages::DeviceMessages(IoctrlChannel &control, DeviceMessageConfig config, DeviceMessageHandlers handlers)
+    : transport_(control.transport())
+    , avIndex_(control.avIndex())
+    , config_(config)
+    , handlers_(std::move(handlers))
+    , messages_(control, {})
+{
+    polls_[size_t(DeviceMessage::Fota)].requestType = config_.fotaRequestType;
+    polls_[size_t(DeviceMessage::PlaybackEnd)].requestType = config_.playbackEndRequestType;
+    polls_[size_t(DeviceMessage::Sensor)].requestType = config_.sensorRequestType;
+    // The first poll tells the state at subscription
+    thread_ = std::thread(&DeviceMessages::run, this);
+}
+
+DeviceMessages::~DeviceMessages()
+{
+    stop_ = true;
+    thread_.join();
+}
+
+void DeviceMessages::setActive(DeviceMessage message, bool active)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Poll &poll = polls_[size_t(message)];
+    if (poll.active == active) {
+        return;
+    }
+    poll.active = active;
+    // The sooner of the next poll at the new interval and the poll already planned
+    uint64_t interval = uint64_t(active ? config_.activeIntervalMs : config_.idleIntervalMs) * 1000;
+    poll.nextPoll = std::min(poll.nextPoll, monotonicMicros() + interval);
+}
+
+bool DeviceMessages::pushSupported(DeviceMessage message) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return polls_[size_t(message)].pushed;
+}
+
+uint64_t DeviceMessages::pollCount(DeviceMessage message) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return polls_[size_t(message)].count;
+}
+
+void DeviceMessages::received(DeviceMessage message, bool pushed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Poll &poll = polls_[size_t(message)];
+    if (pushed || !poll.awaitingReply) {
+        poll.pushed = true;
+    }
+    poll.awaitingReply = false;
+}
+
+void DeviceMessages::sendPolls(uint64_t now, uint64_t &nextDue)
+{
+    SMsgAVIoctrlAVStream request{uint32_t(config_.channel)};
+    auto bytes = SMsgAVIoctrlAVStreamCodec::encode(request);
+    for (Poll &poll : polls_) {
+        uint32_t type;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (poll.requestType == 0 || poll.pushed) {
+                continue;
+            }
+            if (poll.nextPoll > now) {
+                nextDue = std::min(nextDue, poll.nextPoll);
+                continue;
+            }
+            uint64_t interval = uint64_t(poll.active ? config_.activeIntervalMs : config_.idleIntervalMs) * 1000;
+            poll.nextPoll = now + interval;
+            poll.awaitingReply = true;
+            poll.count++;
+            nextDue = std::min(nextDue, poll.nextPoll);
+            type = poll.requestType;
+        }
+        // A failed poll is retried at the next interval, a broken session fails the receive too
+        transport_.sendIOCtrl(avIndex_, type, ConstByteSpan{bytes.data(), bytes.size()});
+    }
+}
+
+void DeviceMessages::run()
+{
+    uint8_t data[kMaxIoctrlSize];
+    while (!stop_) {
+        uint64_t now = monotonicMicros();
+        uint64_t nextDue = UINT64_MAX;
+        sendPolls(now, nextDue);
+
+        int timeoutMs = kListenSliceMs;
+        if (nextDue != UINT64_MAX) {
+            timeoutMs = int(std::min<uint64_t>((nextDue - now + 999) / 1000, kListenSliceMs));
+        }
+        uint32_t type = 0;
+        int size = messages_.recv(&type, ByteSpan{data, sizeof(data)}, std::max(timeoutMs, 1));
+        if (size == kErrTimeout) {
+            continue;
+        }
+        if (size < 0) {
+            error_ = size;
+            return;
+        }
+        dispatch(type, ConstByteSpan{data, size_t(size)});
+    }
+}
+
+void DeviceMessages::dispatch(uint32_t type, ConstByteSpan data)
+{
+    if (type == IOTYPE_USER_IPCAM_EVENT_REPORT) {
+        SMsgAVIoctrlEvent event;
+        if (SMsgAVIoctrlEventCodec::decode(data, event)) {
+            if (handlers_.event) {
+                handlers_.event(event);
+            }
+            return;
+        }
+    } else if (type == PlayRecord::responseType) {
+        SMsgAVIoctrlPlayRecordResp response;
+        if (PlayRecord::decodeResponse(data, response) && response.command == AVIOCTRL_RECORD_PLAY_END) {
+            received(DeviceMessage::PlaybackEnd, true);
+            setActive(DeviceMessage::PlaybackEnd, false);
+            if (handlers_.playbackEnd) {
+                handlers_.playbackEnd();
+            }
+            return;
+        }
+    } else if (type != 0 && type == config_.fotaResponseType) {
+        SMsgFOTAResult result;
+        if (SMsgFOTAResultCodec::decode(data, result)) {
+            received(DeviceMessage::Fota, false);
+            setActive(DeviceMessage::Fota, isFotaInProgress(result.result));
+            if (handlers_.fota) {
+                handlers_.fota(result);
+            }
+            return;
+        }
+    } else if (type != 0 && type == config_.playbackEndResponseType) {
+        SMsgAVIoctrlResult result;
+        if (SMsgAVIoctrlResultCodec::decode(data, result)) {
+            received(DeviceMessage::PlaybackEnd, false);
+            if (result.result == 1) {
+                setActive(DeviceMessage::PlaybackEnd, false);
+                if (handlers_.playbackEnd) {
+                    handlers_.playbackEnd();
+                }
+            }
+            return;
+        }
+    } else if (type != 0 && type == config_.sensorResponseType) {
+        SMsgSensorDetail detail;
+        if (SMsgSensorDetailCodec::decode(data, detail)) {
+            received(DeviceMessage::Sensor, false);
+            if (handlers_.sensorDetail) {
+                handlers_.sensorDetail(detail);
+            }
+            return;
+        }
+    }
+    if (handlers_.other) {
+        handlers_.other(type, data);
+    }
+}
+
+} // namespace cam
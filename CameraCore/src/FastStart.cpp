@@ -0,0 +1,101 @@
+//
+//  FastStart.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/FastStart.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlMessages.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+namespace {
+
+int startVideo(Transport &transport, int avIndex, const FastStartConfig &config)
+{
+    auto request = StartStream::encodeRequest(SMsgAVIoctrlAVStream{uint32_t(config.channel)});
+    int ret = transport.sendIOCtrl(avIndex, StartStream::requestType, ConstByteSpan{request.data(), request.size()});
+    if (ret < 0 || config.keyframeRequestType == 0) {
+        return ret;
+    }
+    return transport.sendIOCtrl(avIndex, config.keyframeRequestType,
+                                ConstByteSpan{config.keyframeRequest.data(), config.keyframeRequest.size()});
+}
+
+int awaitKeyframe(Transport &transport, int avIndex, const FastStartConfig &config, uint64_t start, FastStartResult &result)
+{
+    std::vector<uint8_t> buffer(config.maxFrameSize);
+    uint64_t deadline = start + uint64_t(std::max(config.timeoutMs, 0)) * 1000;
+    for (;;) {
+        uint64_t now = monotonicMicros();
+        if (now >= deadline) {
+            return kErrTimeout;
+        }
+        FrameInfo info;
+        int size = transport.recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info,
+                                       int((deadline - now + 999) / 1000));
+        if (size == kErrTimeout) {
+            continue;
+        }
+        if (size == kErrBufferTooSmall || (size >= 0 && !info.isKeyframe())) {
+            result.skippedFrames++;
+            continue;
+        }
+        if (size < 0) {
+            return size;
+        }
+        result.timeToFirstFrameUs = monotonicMicros() - start;
+        std::shared_ptr<Frame> frame = makeFrame(config.memory, avIndex, info, ConstByteSpan{buffer.data(), size_t(size)});
+        if (!frame) {
+            return kErrMemoryBudget;
+        }
+        result.keyframe = frame;
+        if (config.hub) {
+            config.hub->publish(frame);
+        }
+        if (config.metrics) {
+            config.metrics->firstKeyframeLatency.recordMicros(result.timeToFirstFrameUs);
+        }
+        return kNoError;
+    }
+}
+
+} // namespace
+
+int fastStart(Transport &transport, int avIndex, const FastStartConfig &config, FastStartResult *result)
+{
+    uint64_t start = monotonicMicros();
+    FastStartResult local;
+    FastStartResult &out = result ? *result : local;
+    out = FastStartResult();
+
+    // The acknowledgments of the audio start and the setup overlap the wait for the keyframe
+    std::thread helper([&] {
+        if (config.withAudio) {
+            auto request = StartAudio::encodeRequest(SMsgAVIoctrlAVStream{uint32_t(config.channel)});
+            out.audioError = transport.sendIOCtrl(avIndex, StartAudio::requestType, ConstByteSpan{request.data(), request.size()});
+        }
+        if (config.setup) {
+            out.setupError = config.setup();
+        }
+    });
+
+    int ret = startVideo(transport, avIndex, config);
+    if (ret >= 0) {
+        ret = awaitKeyframe(transport, avIndex, config, start, out);
+    }
+    helper.join();
+    return ret < 0 ? ret : kNoError;
+}
+
+} // namespace cam
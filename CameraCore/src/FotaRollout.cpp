@@ -0,0 +1,382 @@
+//
+//  FotaRollout.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/FotaRollout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int remainingMs(Clock::time_point deadline)
+{
+    return int(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+}
+
+/// Progress of a camera from 0 to 100, the download is the first half and the upgrade the second
+double devicePercent(const RolloutDevice &device)
+{
+    switch (device.state) {
+    case RolloutState::Downloading:
+        return device.result == 2 ? std::clamp(device.reserved, 0, 100) * 0.5 : device.result == 3 ? 50 : 0;
+    case RolloutState::Installing:
+        return 50 + (device.result == 4 ? std::clamp(device.reserved, 0, 100) * 0.45 : 0);
+    case RolloutState::Rebooting:
+        return 95;
+    default:
+        return device.isFinished() ? 100 : 0;
+    }
+}
+
+} // namespace
+
+FotaRollout::FotaRollout(Connector &connector, FotaCommands &commands, std::map<std::string, DeviceCredentials> devices,
+                         RolloutConfig config)
+    : connector_(connector), commands_(commands), config_(std::move(config))
+{
+    for (auto &entry : devices) {
+        RolloutDevice device;
+        device.uid = entry.first;
+        devices_.push_back(std::move(device));
+        credentials_.push_back(std::move(entry.second));
+    }
+}
+
+FotaRollout::~FotaRollout()
+{
+    cancel();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+int FotaRollout::start(DeviceCallback deviceCallback, FinishCallback finishCallback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_) {
+        return kErrInvalidArg;
+    }
+    started_ = true;
+    deviceCallback_ = std::move(deviceCallback);
+    finishCallback_ = std::move(finishCallback);
+    thread_ = std::thread(&FotaRollout::run, this);
+    return kNoError;
+}
+
+int FotaRollout::resume()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!halted_) {
+            return kErrInvalidArg;
+        }
+        halted_ = false;
+    }
+    changed_.notify_all();
+    return kNoError;
+}
+
+void FotaRollout::cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    changed_.notify_all();
+}
+
+RolloutProgress FotaRollout::progress() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return progressLocked();
+}
+
+std::vector<RolloutDevice> FotaRollout::devices() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return devices_;
+}
+
+RolloutProgress FotaRollout::progressLocked() const
+{
+    RolloutProgress progress;
+    progress.total = devices_.size();
+    progress.wave = wave_;
+    progress.halted = halted_;
+    progress.finished = finished_;
+    double percent = 0;
+    for (const RolloutDevice &device : devices_) {
+        switch (device.state) {
+        case RolloutState::Pending: progress.pending++; break;
+        case RolloutState::Succeeded: progress.succeeded++; break;
+        case RolloutState::UpToDate: progress.upToDate++; break;
+        case RolloutState::Failed: progress.failed++; break;
+        case RolloutState::Cancelled: progress.cancelled++; break;
+        default: progress.running++; break;
+        }
+        percent += devicePercent(device);
+    }
+    progress.percent = devices_.empty() ? 100 : percent / double(devices_.size());
+    return progress;
+}
+
+void FotaRollout::update(size_t index, const std::function<void(RolloutDevice &)> &change)
+{
+    RolloutProgress progress;
+    RolloutDevice device;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        change(devices_[index]);
+        progress = progressLocked();
+        device = devices_[index];
+    }
+    if (deviceCallback_) {
+        deviceCallback_(progress, device);
+    }
+}
+
+void FotaRollout::run()
+{
+    size_t next = 0;
+    for (int wave = 0;; wave++) {
+        size_t begin = next;
+        size_t end;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (cancelled_ || begin == devices_.size()) {
+                break;
+            }
+            size_t size = config_.waveSizes.empty() ? devices_.size()
+                                                    : config_.waveSizes[std::min(size_t(wave), config_.waveSizes.size() - 1)];
+            end = std::min(begin + std::max<size_t>(size, 1), devices_.size());
+            wave_ = wave;
+            for (size_t i = begin; i < end; i++) {
+                devices_[i].wave = wave;
+            }
+        }
+        runWave(begin, end);
+        next = end;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        size_t failed = 0;
+        size_t finished = 0;
+        for (size_t i = begin; i < end; i++) {
+            failed += devices_[i].state == RolloutState::Failed;
+            finished += devices_[i].state != RolloutState::Cancelled;
+        }
+        if (end < devices_.size() && finished > 0 && double(failed) / double(finished) > config_.maxFailureRate) {
+            halted_ = true;
+            RolloutProgress progress = progressLocked();
+            lock.unlock();
+            if (finishCallback_) {
+                finishCallback_(progress);
+            }
+            lock.lock();
+            changed_.wait(lock, [&] { return !halted_ || cancelled_; });
+            halted_ = false;
+        }
+    }
+
+    RolloutProgress progress;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (RolloutDevice &device : devices_) {
+            if (device.state == RolloutState::Pending) {
+                device.state = RolloutState::Cancelled;
+            }
+        }
+        finished_ = true;
+        progress = progressLocked();
+    }
+    if (finishCallback_) {
+        finishCallback_(progress);
+    }
+}
+
+void FotaRollout::runWave(size_t begin, size_t end)
+{
+    std::atomic<size_t> cursor{begin};
+    auto worker = [&] {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (cancelled_) {
+                    return;
+                }
+            }
+            size_t index = cursor++;
+            if (index >= end) {
+                return;
+            }
+            runDevice(index);
+        }
+    };
+    std::vector<std::thread> threads;
+    size_t count = std::min(std::max<size_t>(config_.maxConcurrent, 1), end - begin);
+    for (size_t i = 0; i < count; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+int FotaRollout::awaitResult(size_t index, Transport &transport, int avIndex,
+                             const std::function<bool(int32_t, int32_t)> &done)
+{
+    auto deadline = Clock::now() + std::chrono::milliseconds(config_.stepTimeoutMs);
+    SMsgFOTAResult last{INT32_MIN, INT32_MIN};
+    for (;;) {
+        int remaining = remainingMs(deadline);
+        if (remaining <= 0) {
+            return kErrTimeout;
+        }
+        SMsgFOTAResult current;
+        int ret = commands_.result(transport, avIndex, current, remaining);
+        if (ret < 0) {
+            return ret;
+        }
+        if (current.result != last.result || current.reserved != last.reserved) {
+            // Every change of the result restarts the step timeout
+            last = current;
+            deadline = Clock::now() + std::chrono::milliseconds(config_.stepTimeoutMs);
+            update(index, [&](RolloutDevice &device) {
+                device.result = current.result;
+                device.reserved = current.reserved;
+            });
+        }
+        if (current.result == -3 || current.result == -2) {
+            return kErrRejected;
+        }
+        if (done(current.result, current.reserved)) {
+            return kNoError;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::min(config_.pollIntervalMs, std::max(remaining, 1))));
+    }
+}
+
+int FotaRollout::reconnect(size_t index, std::unique_ptr<Transport> &transport, int &avIndex)
+{
+    const DeviceCredentials &credentials = credentials_[index];
+    auto deadline = Clock::now() + std::chrono::milliseconds(config_.rebootTimeoutMs);
+    int error = kErrTimeout;
+    // The camera is gone while it installs, connecting fails until it is back
+    for (;;) {
+        int remaining = remainingMs(deadline);
+        if (remaining <= 0) {
+            return error;
+        }
+        transport = connector_.connect(devices_[index].uid, std::min(config_.connectTimeoutMs, remaining), &error);
+        if (transport) {
+            avIndex = transport->openChannel(0, credentials.account, credentials.password);
+            if (avIndex >= 0) {
+                return kNoError;
+            }
+            error = avIndex;
+            transport.reset();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::min(config_.pollIntervalMs, std::max(remaining, 1))));
+    }
+}
+
+void FotaRollout::runDevice(size_t index)
+{
+    auto setState = [&](RolloutState state, int error = 0) {
+        update(index, [&](RolloutDevice &device) {
+            device.state = state;
+            device.error = error;
+        });
+    };
+
+    const DeviceCredentials &credentials = credentials_[index];
+    setState(RolloutState::Connecting);
+    int error = 0;
+    // The UID is not changed after the constructor, it is read without the lock
+    std::unique_ptr<Transport> transport = connector_.connect(devices_[index].uid, config_.connectTimeoutMs, &error);
+    if (!transport) {
+        setState(RolloutState::Failed, error < 0 ? error : kErrTimeout);
+        return;
+    }
+    int avIndex = transport->openChannel(0, credentials.account, credentials.password);
+    if (avIndex < 0) {
+        setState(RolloutState::Failed, avIndex);
+        return;
+    }
+
+    setState(RolloutState::Checking);
+    int ret = commands_.checkVersion(*transport, avIndex);
+    int32_t found = -1;
+    if (ret >= 0) {
+        ret = awaitResult(index, *transport, avIndex, [&](int32_t result, int32_t) {
+            found = result;
+            return result != -1;
+        });
+    }
+    if (ret < 0) {
+        setState(RolloutState::Failed, ret);
+        return;
+    }
+    if (found == 0) {
+        setState(RolloutState::UpToDate);
+        return;
+    }
+    if (found != 1) {
+        setState(RolloutState::Failed, kErrRejected);
+        return;
+    }
+
+    setState(RolloutState::Downloading);
+    ret = commands_.download(*transport, avIndex);
+    if (ret >= 0) {
+        ret = awaitResult(index, *transport, avIndex, [](int32_t result, int32_t reserved) {
+            return result == 3 && reserved == 2;
+        });
+    }
+    if (ret < 0) {
+        setState(RolloutState::Failed, ret);
+        return;
+    }
+
+    setState(RolloutState::Installing);
+    ret = commands_.install(*transport, avIndex);
+    if (ret < 0) {
+        setState(RolloutState::Failed, ret);
+        return;
+    }
+    auto succeeded = [](int32_t result, int32_t) { return result == 5; };
+    ret = awaitResult(index, *transport, avIndex, succeeded);
+    if (ret == kErrRejected || ret == kErrTimeout) {
+        setState(RolloutState::Failed, ret);
+        return;
+    }
+    if (ret < 0) {
+        // The connection is lost when the camera reboots into the new firmware
+        setState(RolloutState::Rebooting);
+        transport.reset();
+        ret = reconnect(index, transport, avIndex);
+        if (ret >= 0) {
+            ret = awaitResult(index, *transport, avIndex, succeeded);
+        }
+        if (ret < 0) {
+            setState(RolloutState::Failed, ret);
+            return;
+        }
+    }
+    setState(RolloutState::Succeeded);
+}
+
+} // namespace cam
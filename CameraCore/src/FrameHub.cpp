@@ -0,0 +1,175 @@
+//
+//  FrameHub.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/FrameHub.h"
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+namespace cam {
+
+namespace {
+
+SubscriptionConfig normalized(SubscriptionConfig config)
+{
+    config.queueDepth = config.dropPolicy == DropPolicy::Latest ? 1 : std::max<size_t>(config.queueDepth, 1);
+    return config;
+}
+
+} // namespace
+
+std::shared_ptr<Frame> makeFrame(const std::shared_ptr<SessionMemory> &memory, int avIndex, const FrameInfo &info,
+                                 ConstByteSpan data)
+{
+    try {
+        auto frame = std::allocate_shared<Frame>(SessionAllocator<Frame>(memory));
+        frame->avIndex = avIndex;
+        frame->info = info;
+        frame->data = SessionBytes(data.data, data.data + data.size, SessionAllocator<uint8_t>(memory));
+        return frame;
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+FrameSubscription::FrameSubscription(SubscriptionConfig config) : config_(normalized(config))
+{
+}
+
+FramePtr FrameSubscription::next(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return cancelled_ || !queue_.empty(); });
+    if (cancelled_ || queue_.empty()) {
+        return nullptr;
+    }
+    FramePtr frame = std::move(queue_.front());
+    queue_.pop_front();
+    delivered_++;
+    return frame;
+}
+
+void FrameSubscription::cancel()
+{
+    std::deque<FramePtr> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        released.swap(queue_);
+    }
+    changed_.notify_all();
+}
+
+size_t FrameSubscription::queued() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+uint64_t FrameSubscription::framesDelivered() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return delivered_;
+}
+
+uint64_t FrameSubscription::framesDropped() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+void FrameSubscription::push(const FramePtr &frame)
+{
+    // A frame dropped here may be the last reference, it is released after the lock
+    FramePtr released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) {
+            return;
+        }
+        if (awaitKeyframe_) {
+            if (!frame->info.isKeyframe()) {
+                dropped_++;
+                return;
+            }
+            awaitKeyframe_ = false;
+        }
+        if (queue_.size() >= config_.queueDepth) {
+            switch (config_.dropPolicy) {
+            case DropPolicy::Oldest:
+            case DropPolicy::Latest:
+                released = std::move(queue_.front());
+                queue_.pop_front();
+                dropped_++;
+                break;
+            case DropPolicy::Newest:
+                dropped_++;
+                return;
+            case DropPolicy::UntilKeyframe:
+                dropped_ += queue_.size();
+                queue_.clear();
+                if (!frame->info.isKeyframe()) {
+                    dropped_++;
+                    awaitKeyframe_ = true;
+                    return;
+                }
+                break;
+            }
+        }
+        queue_.push_back(frame);
+    }
+    changed_.notify_one();
+}
+
+bool FrameSubscription::latestPending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_.dropPolicy == DropPolicy::Latest && !queue_.empty();
+}
+
+std::shared_ptr<FrameSubscription> FrameHub::subscribe(SubscriptionConfig config)
+{
+    auto subscription = std::make_shared<FrameSubscription>(config);
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.push_back(subscription);
+    return subscription;
+}
+
+void FrameHub::unsubscribe(const std::shared_ptr<FrameSubscription> &subscription)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscriptions_.erase(std::remove(subscriptions_.begin(), subscriptions_.end(), subscription), subscriptions_.end());
+    }
+    subscription->cancel();
+}
+
+void FrameHub::publish(const FramePtr &frame)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &subscription : subscriptions_) {
+        subscription->push(frame);
+    }
+}
+
+bool FrameHub::consumersBehind() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !subscriptions_.empty() && std::all_of(subscriptions_.begin(), subscriptions_.end(), [](const auto &subscription) {
+               return subscription->latestPending();
+           });
+}
+
+size_t FrameHub::subscriberCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscriptions_.size();
+}
+
+} // namespace cam
@@ -0,0 +1,212 @@
+//
+//  FrameScaler.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/FrameScaler.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "CameraCore/Bitstream.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CAMCORE_VECTOR_EXTENSIONS 1
+#else
+#define CAMCORE_VECTOR_EXTENSIONS 0
+#endif
+
+namespace cam {
+
+namespace {
+
+/// BT.601 in 16.16 fixed point
+struct Coefficients
+{
+    int32_t yOffset;
+    int32_t y;
+    int32_t vr;
+    int32_t ug;
+    int32_t vg;
+    int32_t ub;
+};
+
+constexpr Coefficients kVideoRange{16, 76309, 104597, 25675, 53279, 132201};
+constexpr Coefficients kFullRange{0, 65536, 91881, 22554, 46802, 116130};
+
+inline uint8_t clampPixel(int32_t value)
+{
+    value = (value + 32768) >> 16;
+    return uint8_t(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+inline void convertPixel(const Coefficients &k, int32_t y, int32_t u, int32_t v, uint8_t *out)
+{
+    int32_t c = (y - k.yOffset) * k.y;
+    u -= 128;
+    v -= 128;
+    out[0] = clampPixel(c + k.vr * v);
+    out[1] = clampPixel(c - k.ug * u - k.vg * v);
+    out[2] = clampPixel(c + k.ub * u);
+    out[3] = 255;
+}
+
+#if CAMCORE_VECTOR_EXTENSIONS
+typedef uint8_t U8x8 __attribute__((vector_size(8)));
+typedef uint32_t U32x8 __attribute__((vector_size(32)));
+typedef int32_t I32x4 __attribute__((vector_size(16)));
+
+inline I32x4 clampVector(I32x4 value)
+{
+    value = (value + 32768) >> 16;
+    value &= ~(value < 0);
+    I32x4 over = value > 255;
+    return (value & ~over) | (over & 255);
+}
+#endif
+
+/// Convert a row of averaged Y, Cb and Cr to RGBA
+void convertRow(const Coefficients &k, const int32_t *y, const int32_t *u, const int32_t *v, int width, uint8_t *out)
+{
+    int x = 0;
+#if CAMCORE_VECTOR_EXTENSIONS
+    for (; x + 4 <= width; x += 4, out += 16) {
+        I32x4 vy, vu, vv;
+        std::memcpy(&vy, y + x, sizeof(vy));
+        std::memcpy(&vu, u + x, sizeof(vu));
+        std::memcpy(&vv, v + x, sizeof(vv));
+        I32x4 c = (vy - k.yOffset) * k.y;
+        vu -= 128;
+        vv -= 128;
+        I32x4 r = clampVector(c + k.vr * vv);
+        I32x4 g = clampVector(c - k.ug * vu - k.vg * vv);
+        I32x4 b = clampVector(c + k.ub * vu);
+        for (int i = 0; i < 4; i++) {
+            out[i * 4] = uint8_t(r[i]);
+            out[i * 4 + 1] = uint8_t(g[i]);
+            out[i * 4 + 2] = uint8_t(b[i]);
+            out[i * 4 + 3] = 255;
+        }
+    }
+#endif
+    for (; x < width; x++, out += 4) {
+        convertPixel(k, y[x], u[x], v[x], out);
+    }
+}
+
+inline int boxStart(int i, int source, int destination)
+{
+    return int(int64_t(i) * source / destination);
+}
+
+inline int boxEnd(int i, int source, int destination)
+{
+    return std::max(boxStart(i, source, destination) + 1, boxStart(i + 1, source, destination));
+}
+
+} // namespace
+
+bool OutputSize::skipsFrame(uint16_t codecId, ConstByteSpan frame, int hevcMaxTemporalId) const
+{
+    return !isFullResolution() && maxWidth < skipNonReferenceBelowWidth &&
+           isNonReferenceFrame(codecId, frame, hevcMaxTemporalId);
+}
+
+void FrameScaler::convert(const Nv12Picture &src, int maxWidth, int maxHeight, Image &dst)
+{
+    int width = src.width;
+    int height = src.height;
+    if (maxWidth > 0 && maxHeight > 0) {
+        fitSize(src.width, src.height, maxWidth, maxHeight, &width, &height);
+    }
+    convertTo(src, width, height, dst);
+}
+
+void FrameScaler::sumRows(const uint8_t *plane, size_t stride, int y0, int y1, size_t bytes)
+{
+    uint32_t *sums = columnSums_.data();
+    std::fill(sums, sums + bytes, 0);
+    for (int y = y0; y < y1; y++) {
+        const uint8_t *row = plane + size_t(y) * stride;
+        size_t x = 0;
+#if CAMCORE_VECTOR_EXTENSIONS
+        for (; x + 8 <= bytes; x += 8) {
+            U8x8 pixels;
+            U32x8 sum;
+            std::memcpy(&pixels, row + x, sizeof(pixels));
+            std::memcpy(&sum, sums + x, sizeof(sum));
+            sum += __builtin_convertvector(pixels, U32x8);
+            std::memcpy(sums + x, &sum, sizeof(sum));
+        }
+#endif
+        for (; x < bytes; x++) {
+            sums[x] += row[x];
+        }
+    }
+}
+
+void FrameScaler::convertTo(const Nv12Picture &src, int width, int height, Image &dst)
+{
+    width = std::min(std::max(width, 1), src.width);
+    height = std::min(std::max(height, 1), src.height);
+    dst.resize(width, height);
+    if (src.width <= 0 || src.height <= 0) {
+        return;
+    }
+    const Coefficients &k = src.fullRange ? kFullRange : kVideoRange;
+    int chromaWidth = (src.width + 1) / 2;
+    int chromaHeight = (src.height + 1) / 2;
+    columnSums_.resize(std::max(size_t(src.width), size_t(chromaWidth) * 2));
+    y_.resize(size_t(width));
+    u_.resize(size_t(width));
+    v_.resize(size_t(width));
+
+    // Source column ranges of the destination columns, boundary dx and dx + 1 of each plane
+    columns_.resize(size_t(width) * 2 + 2);
+    uint32_t *lumaColumns = columns_.data();
+    uint32_t *chromaColumns = columns_.data() + width + 1;
+    for (int dx = 0; dx <= width; dx++) {
+        lumaColumns[dx] = uint32_t(boxStart(dx, src.width, width));
+        chromaColumns[dx] = uint32_t(boxStart(dx, chromaWidth, width));
+    }
+
+    for (int dy = 0; dy < height; dy++) {
+        int y0 = boxStart(dy, src.height, height);
+        int y1 = boxEnd(dy, src.height, height);
+        sumRows(src.y, src.yStride, y0, y1, size_t(src.width));
+        for (int dx = 0; dx < width; dx++) {
+            uint32_t x0 = lumaColumns[dx];
+            uint32_t x1 = std::max(x0 + 1, lumaColumns[dx + 1]);
+            uint32_t sum = 0;
+            for (uint32_t x = x0; x < x1; x++) {
+                sum += columnSums_[x];
+            }
+            uint32_t count = (x1 - x0) * uint32_t(y1 - y0);
+            y_[size_t(dx)] = int32_t(count == 1 ? sum : (sum + count / 2) / count);
+        }
+
+        int cy0 = boxStart(dy, chromaHeight, height);
+        int cy1 = boxEnd(dy, chromaHeight, height);
+        sumRows(src.uv, src.uvStride, cy0, cy1, size_t(chromaWidth) * 2);
+        for (int dx = 0; dx < width; dx++) {
+            uint32_t x0 = chromaColumns[dx];
+            uint32_t x1 = std::max(x0 + 1, chromaColumns[dx + 1]);
+            uint32_t sumU = 0;
+            uint32_t sumV = 0;
+            for (uint32_t x = x0; x < x1; x++) {
+                sumU += columnSums_[x * 2];
+                sumV += columnSums_[x * 2 + 1];
+            }
+            uint32_t count = (x1 - x0) * uint32_t(cy1 - cy0);
+            u_[size_t(dx)] = int32_t(count == 1 ? sumU : (sumU + count / 2) / count);
+            v_[size_t(dx)] = int32_t(count == 1 ? sumV : (sumV + count / 2) / count);
+        }
+
+        convertRow(k, y_.data(), u_.data(), v_.data(), width, dst.rgba.data() + size_t(dy) * size_t(width) * 4);
+    }
+}
+
+} // namespace cam
@@ -0,0 +1,158 @@
+//
+//  FrameTrace.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/FrameTrace.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+
+namespace cam {
+
+namespace {
+
+uint64_t makeKey(int avIndex, uint32_t frameNumber, TraceStage stage)
+{
+    return uint64_t(uint32_t(avIndex) & 0xFFFFFF) << 40 | uint64_t(stage) << 32 | frameNumber;
+}
+
+int keyAvIndex(uint64_t key)
+{
+    uint32_t value = uint32_t(key >> 40) & 0xFFFFFF;
+    return value & 0x800000 ? int(value | 0xFF000000) : int(value);
+}
+
+} // namespace
+
+const char *traceStageName(TraceStage stage)
+{
+    switch (stage) {
+        case TraceStage::Received: return "Received";
+        case TraceStage::DecodeStart: return "Queued";
+        case TraceStage::Decoded: return "Decode";
+        case TraceStage::Converted: return "Convert";
+        case TraceStage::Delivered: return "Deliver";
+    }
+    return "Unknown";
+}
+
+bool frameTraceBuiltIn()
+{
+    return CAMCORE_FRAME_TRACE != 0;
+}
+
+FrameTrace::FrameTrace(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    slots_.reset(new Slot[size]);
+    mask_ = size - 1;
+}
+
+void FrameTrace::record(int avIndex, uint32_t frameNumber, TraceStage stage, uint64_t time)
+{
+    uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[index & mask_];
+
+    // A writer a lap behind may still be in the slot: the newer event waits for it, the older one is dropped
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if (sequence > 2 * index) {
+            return;
+        }
+        if (sequence & 1) {
+            std::this_thread::yield();
+            sequence = slot.sequence.load(std::memory_order_relaxed);
+        } else if (slot.sequence.compare_exchange_weak(sequence, 2 * index + 1, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.key.store(makeKey(avIndex, frameNumber, stage), std::memory_order_relaxed);
+    slot.time.store(time, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<TraceEvent> FrameTrace::events() const
+{
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t capacity = mask_ + 1;
+    uint64_t first = head > capacity ? head - capacity : 0;
+
+    std::vector<TraceEvent> events;
+    events.reserve(size_t(head - first));
+    for (uint64_t index = first; index < head; index++) {
+        const Slot &slot = slots_[index & mask_];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != 2 * index + 2) {
+            continue;       // Being written, or already overwritten by a newer event
+        }
+        uint64_t key = slot.key.load(std::memory_order_relaxed);
+        uint64_t time = slot.time.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        events.push_back(TraceEvent{keyAvIndex(key), uint32_t(key), TraceStage(uint8_t(key >> 32)), time});
+    }
+    return events;
+}
+
+std::string FrameTrace::exportChromeJson() const
+{
+    std::vector<TraceEvent> events = this->events();
+    // Events of different threads are claimed in index order but may carry times slightly out of order
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent &a, const TraceEvent &b) {
+        return a.time < b.time;
+    });
+
+    std::unordered_map<uint64_t, uint64_t> previousStage;
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char line[256];
+    bool first = true;
+    for (const TraceEvent &event : events) {
+        uint64_t frame = makeKey(event.avIndex, event.frameNumber, TraceStage::Received);
+        auto previous = previousStage.find(frame);
+        int length;
+        if (event.stage != TraceStage::Received && previous != previousStage.end()) {
+            length = snprintf(line, sizeof(line),
+                              "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64
+                              ",\"args\":{\"frame\":%" PRIu32 "}}",
+                              first ? "" : ",", traceStageName(event.stage), event.avIndex, previous->second,
+                              event.time - previous->second, event.frameNumber);
+        } else {
+            // Received, or the earlier stages of the frame were overwritten
+            length = snprintf(line, sizeof(line),
+                              "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64
+                              ",\"args\":{\"frame\":%" PRIu32 "}}",
+                              first ? "" : ",", traceStageName(event.stage), event.avIndex, event.time,
+                              event.frameNumber);
+        }
+        json.append(line, size_t(length));
+        first = false;
+        if (event.stage == TraceStage::Delivered) {
+            previousStage.erase(frame);
+        } else {
+            previousStage[frame] = event.time;
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+void FrameTrace::clear()
+{
+    // Slots are matched to their index, moving the head past them hides the old events
+    head_.fetch_add(mask_ + 1, std::memory_order_relaxed);
+}
+
+} // namespace cam
@@ -0,0 +1,62 @@
+//
+//  Image.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/Image.h"
+
+#include <algorithm>
+
+namespace cam {
+
+void fitSize(int width, int height, int maxWidth, int maxHeight, int *outWidth, int *outHeight)
+{
+    if (width <= 0 || height <= 0) {
+        *outWidth = 0;
+        *outHeight = 0;
+        return;
+    }
+    maxWidth = std::min(std::max(maxWidth, 1), width);
+    maxHeight = std::min(std::max(maxHeight, 1), height);
+    // Compare maxWidth / width with maxHeight / height without rounding
+    if (int64_t(maxWidth) * height <= int64_t(maxHeight) * width) {
+        *outWidth = maxWidth;
+        *outHeight = std::max(1, int(int64_t(height) * maxWidth / width));
+    } else {
+        *outHeight = maxHeight;
+        *outWidth = std::max(1, int(int64_t(width) * maxHeight / height));
+    }
+}
+
+void downscaleBox(const Image &src, int width, int height, Image &dst)
+{
+    dst.resize(width, height);
+    for (int y = 0; y < height; y++) {
+        int y0 = int(int64_t(y) * src.height / height);
+        int y1 = std::max(y0 + 1, int(int64_t(y + 1) * src.height / height));
+        for (int x = 0; x < width; x++) {
+            int x0 = int(int64_t(x) * src.width / width);
+            int x1 = std::max(x0 + 1, int(int64_t(x + 1) * src.width / width));
+            uint32_t sum[4] = {0, 0, 0, 0};
+            for (int sy = y0; sy < y1; sy++) {
+                const uint8_t *p = src.rgba.data() + (size_t(sy) * src.width + x0) * 4;
+                for (int sx = x0; sx < x1; sx++, p += 4) {
+                    sum[0] += p[0];
+                    sum[1] += p[1];
+                    sum[2] += p[2];
+                    sum[3] += p[3];
+                }
+            }
+            uint32_t count = uint32_t((y1 - y0) * (x1 - x0));
+            uint8_t *q = dst.rgba.data() + (size_t(y) * width + x) * 4;
+            for (int c = 0; c < 4; c++) {
+                q[c] = uint8_t((sum[c] + count / 2) / count);
+            }
+        }
+    }
+}
+
+} // namespace cam
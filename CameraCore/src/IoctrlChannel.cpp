@@ -0,0 +1,138 @@
+//
+//  IoctrlChannel.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/IoctrlChannel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+namespace {
+
+/// Longest receive, the time it takes the reader to see a stop
+constexpr int kReadSliceMs = 50;
+
+} // namespace
+
+IoctrlChannel::IoctrlChannel(Transport &transport, int avIndex)
+    : transport_(transport), avIndex_(avIndex)
+{
+    thread_ = std::thread(&IoctrlChannel::run, this);
+}
+
+IoctrlChannel::~IoctrlChannel()
+{
+    stop_ = true;
+    thread_.join();
+}
+
+int IoctrlChannel::subscribe(std::vector<uint32_t> types, Handler handler, StoppedHandler stopped)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = nextId_++;
+    subscriptions_.push_back(Subscription{id, std::move(types), std::move(handler), std::move(stopped)});
+    return id;
+}
+
+void IoctrlChannel::unsubscribe(int id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                                        [id](const Subscription &subscription) { return subscription.id == id; }),
+                         subscriptions_.end());
+}
+
+void IoctrlChannel::run()
+{
+    uint8_t data[kMaxIoctrlSize];
+    while (!stop_) {
+        uint32_t type = 0;
+        int size = transport_.recvIOCtrl(avIndex_, &type, ByteSpan{data, sizeof(data)}, kReadSliceMs);
+        if (size == kErrTimeout) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size < 0) {
+            error_.store(size, std::memory_order_release);
+            for (const Subscription &subscription : subscriptions_) {
+                if (subscription.stopped) {
+                    subscription.stopped(size);
+                }
+            }
+            return;
+        }
+        for (const Subscription &subscription : subscriptions_) {
+            if (subscription.types.empty() ||
+                std::find(subscription.types.begin(), subscription.types.end(), type) != subscription.types.end()) {
+                subscription.handler(type, ConstByteSpan{data, size_t(size)});
+            }
+        }
+    }
+}
+
+IoctrlQueue::IoctrlQueue(IoctrlChannel &channel, std::vector<uint32_t> types, size_t maxQueued)
+    : channel_(channel), maxQueued_(std::max<size_t>(maxQueued, 1))
+{
+    id_ = channel_.subscribe(
+        std::move(types),
+        [this](uint32_t type, ConstByteSpan data) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.size() >= maxQueued_) {
+                queue_.pop_front();
+            }
+            queue_.emplace_back(type, std::vector<uint8_t>(data.data, data.data + data.size));
+            changed_.notify_all();
+        },
+        [this](int error) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = error;
+            changed_.notify_all();
+        });
+    // The reader may have stopped before the subscription
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel_.error() < 0) {
+        error_ = channel_.error();
+    }
+}
+
+IoctrlQueue::~IoctrlQueue()
+{
+    channel_.unsubscribe(id_);
+}
+
+int IoctrlQueue::recv(uint32_t *type, ByteSpan buffer, int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!changed_.wait_for(lock, std::chrono::milliseconds(std::max(timeoutMs, 0)),
+                           [this] { return !queue_.empty() || error_ < 0; })) {
+        return kErrTimeout;
+    }
+    if (queue_.empty()) {
+        return error_;
+    }
+    auto ioctrl = std::move(queue_.front());
+    queue_.pop_front();
+    *type = ioctrl.first;
+    if (ioctrl.second.size() > buffer.size) {
+        return kErrBufferTooSmall;
+    }
+    std::memcpy(buffer.data, ioctrl.second.data(), ioctrl.second.size());
+    return int(ioctrl.second.size());
+}
+
+void IoctrlQueue::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+}
+
+} // namespace cam
@@ -0,0 +1,149 @@
+//
+//  IoctrlReassembler.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/IoctrlReassembler.h"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlChannel.h"
+#include "CameraCore/IoctrlCodec.h"
+#include "CameraCore/Transport.h"
+
+namespace cam {
+
+static_assert(IoctrlReassembler::kHeaderSize == ioctrl::DataPackageHeaderCodec::size, "Package header size");
+
+IoctrlReassembler::IoctrlReassembler(uint32_t maxTotal, std::shared_ptr<SessionMemory> memory)
+    : buffer_(SessionAllocator<uint8_t>(std::move(memory)))
+    , maxTotal_(maxTotal)
+{
+}
+
+void IoctrlReassembler::reset()
+{
+    total_ = 0;
+    received_ = 0;
+    nextIndex_ = 0;
+    complete_ = false;
+}
+
+void IoctrlReassembler::shrink()
+{
+    reset();
+    SessionBytes(buffer_.get_allocator()).swap(buffer_);
+}
+
+int IoctrlReassembler::add(ConstByteSpan package)
+{
+    if (complete_) {
+        reset();
+    }
+    ioctrl::DataPackageHeader header;
+    if (!ioctrl::DataPackageHeaderCodec::decode(package, header)) {
+        reset();
+        return kErrBadPackage;
+    }
+
+    uint32_t total = header.total;
+    unsigned index = header.index;
+    bool end = header.endflag != 0;
+    uint16_t count = header.count;
+
+    // The index is one byte, replies longer than 256 packages wrap around
+    bool ok = package.size - kHeaderSize >= count && index == (nextIndex_ & 0xFF) && total <= maxTotal_ &&
+              (nextIndex_ == 0 || total == total_) && count <= total - (nextIndex_ == 0 ? 0 : received_);
+    if (!ok) {
+        reset();
+        return kErrBadPackage;
+    }
+
+    if (nextIndex_ == 0) {
+        if (buffer_.size() < total) {
+            // The smaller buffer goes first, the memory of the session holds one buffer at a time
+            shrink();
+            try {
+                buffer_.resize(total);
+            } catch (const std::bad_alloc &) {
+                shrink();
+                return kErrMemoryBudget;
+            }
+        }
+        total_ = total;
+        received_ = 0;
+    }
+    std::memcpy(buffer_.data() + received_, package.data + kHeaderSize, count);
+    received_ += count;
+    nextIndex_++;
+
+    if (!end) {
+        return 0;
+    }
+    if (received_ != total_) {
+        reset();
+        return kErrBadPackage;
+    }
+    complete_ = true;
+    return 1;
+}
+
+namespace {
+
+/// recv(type, buffer, timeoutMs) receives the next IO control
+template <typename Recv>
+int recvPackages(Recv recv, uint32_t type, IoctrlReassembler &reassembler, int timeoutMs)
+{
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    uint8_t package[kMaxIoctrlSize];
+
+    reassembler.reset();
+    for (;;) {
+        int remaining = int(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        if (remaining <= 0) {
+            return kErrTimeout;
+        }
+        uint32_t receivedType = 0;
+        int size = recv(&receivedType, ByteSpan{package, sizeof(package)}, remaining);
+        if (size < 0) {
+            return size;
+        }
+        if (receivedType != type) {
+            continue;
+        }
+        int result = reassembler.add(ConstByteSpan{package, size_t(size)});
+        if (result < 0) {
+            return result;
+        }
+        if (result == 1) {
+            return int(reassembler.data().size);
+        }
+    }
+}
+
+} // namespace
+
+int recvReassembled(Transport &transport, int avIndex, uint32_t type, IoctrlReassembler &reassembler, int timeoutMs)
+{
+    auto recv = [&](uint32_t *receivedType, ByteSpan buffer, int remaining) {
+        return transport.recvIOCtrl(avIndex, receivedType, buffer, remaining);
+    };
+    return recvPackages(recv, type, reassembler, timeoutMs);
+}
+
+int recvReassembled(IoctrlQueue &queue, uint32_t type, IoctrlReassembler &reassembler, int timeoutMs)
+{
+    auto recv = [&](uint32_t *receivedType, ByteSpan buffer, int remaining) {
+        return queue.recv(receivedType, buffer, remaining);
+    };
+    return recvPackages(recv, type, reassembler, timeoutMs);
+}
+
+} // namespace cam
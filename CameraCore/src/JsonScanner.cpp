@@ -0,0 +1,443 @@
+//
+//  JsonScanner.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/JsonScanner.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+namespace {
+
+/// One step of the position in the document, an object key or an array index
+struct Segment
+{
+    const char *key;            // nullptr for an array element
+    size_t keySize;
+    size_t index;
+};
+
+enum class Match { None, Prefix, Exact };
+
+/// The path component equals the decimal array index
+bool isIndex(const char *component, size_t size, size_t index)
+{
+    if (size == 0 || size > 9) {
+        return false;
+    }
+    size_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (component[i] < '0' || component[i] > '9') {
+            return false;
+        }
+        value = value * 10 + size_t(component[i] - '0');
+    }
+    return value == index;
+}
+
+/// How a field path relates to the position given by segments
+Match matchPath(const char *path, const Segment *segments, int depth)
+{
+    const char *p = path;
+    bool more = *p != '\0';
+    for (int i = 0; i < depth; i++) {
+        if (!more) {
+            return Match::None;
+        }
+        const char *component = p;
+        while (*p != '\0' && *p != '.') {
+            p++;
+        }
+        size_t size = size_t(p - component);
+        const Segment &segment = segments[i];
+        bool equal = segment.key ? size == segment.keySize && std::memcmp(component, segment.key, size) == 0
+                                 : isIndex(component, size, segment.index);
+        if (!equal) {
+            return Match::None;
+        }
+        more = *p == '.';
+        if (more) {
+            p++;
+        }
+    }
+    return more ? Match::Prefix : Match::Exact;
+}
+
+/// @return false if the character does not fit
+bool appendUtf8(uint32_t code, char *out, size_t capacity, size_t &size)
+{
+    char bytes[4];
+    size_t count;
+    if (code < 0x80) {
+        bytes[0] = char(code);
+        count = 1;
+    } else if (code < 0x800) {
+        bytes[0] = char(0xC0 | (code >> 6));
+        bytes[1] = char(0x80 | (code & 0x3F));
+        count = 2;
+    } else if (code < 0x10000) {
+        bytes[0] = char(0xE0 | (code >> 12));
+        bytes[1] = char(0x80 | ((code >> 6) & 0x3F));
+        bytes[2] = char(0x80 | (code & 0x3F));
+        count = 3;
+    } else {
+        bytes[0] = char(0xF0 | (code >> 18));
+        bytes[1] = char(0x80 | ((code >> 12) & 0x3F));
+        bytes[2] = char(0x80 | ((code >> 6) & 0x3F));
+        bytes[3] = char(0x80 | (code & 0x3F));
+        count = 4;
+    }
+    if (size + count > capacity) {
+        return false;
+    }
+    std::memcpy(out + size, bytes, count);
+    size += count;
+    return true;
+}
+
+bool parseHex4(const char *p, uint32_t &value)
+{
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = uint32_t(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = uint32_t(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = uint32_t(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        value = value << 4 | digit;
+    }
+    return true;
+}
+
+/**
+ Unescape the contents of a string into out, NUL terminated and truncated to capacity - 1 bytes
+
+ @return false if an escape is malformed
+ */
+bool unescape(const char *p, const char *end, char *out, size_t capacity)
+{
+    size_t size = 0;
+    capacity--;
+    while (p < end) {
+        if (*p != '\\') {
+            const char *run = p;
+            while (p < end && *p != '\\') {
+                p++;
+            }
+            size_t count = std::min(size_t(p - run), capacity - size);
+            std::memcpy(out + size, run, count);
+            size += count;
+            continue;
+        }
+        if (end - p < 2) {
+            return false;
+        }
+        char c = p[1];
+        p += 2;
+        char plain;
+        switch (c) {
+        case '"': plain = '"'; break;
+        case '\\': plain = '\\'; break;
+        case '/': plain = '/'; break;
+        case 'b': plain = '\b'; break;
+        case 'f': plain = '\f'; break;
+        case 'n': plain = '\n'; break;
+        case 'r': plain = '\r'; break;
+        case 't': plain = '\t'; break;
+        case 'u': {
+            uint32_t code;
+            if (end - p < 4 || !parseHex4(p, code)) {
+                return false;
+            }
+            p += 4;
+            uint32_t low;
+            if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                parseHex4(p + 2, low) && low >= 0xDC00 && low < 0xE000) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+            if (!appendUtf8(code, out, capacity, size)) {
+                // A character is not cut in the middle, nothing is added after it
+                capacity = size;
+            }
+            continue;
+        }
+        default:
+            return false;
+        }
+        if (size < capacity) {
+            out[size++] = plain;
+        }
+    }
+    out[size] = '\0';
+    return true;
+}
+
+class Scanner
+{
+public:
+    Scanner(ConstByteSpan json, JsonField *fields, size_t count)
+        : p_(reinterpret_cast<const char *>(json.data)), end_(p_ + json.size), fields_(fields), count_(count),
+          remaining_(count)
+    {
+    }
+
+    int run()
+    {
+        for (size_t i = 0; i < count_; i++) {
+            fields_[i].found = false;
+        }
+        if (count_ == 0) {
+            return 0;
+        }
+        bool ok = value(0);
+        if (remaining_ == 0) {
+            return int(count_);
+        }
+        if (!ok) {
+            return kErrBadPackage;
+        }
+        // Replies are often sent with the terminating NUL of the C string
+        skipSpace();
+        while (p_ < end_ && *p_ == '\0') {
+            p_++;
+        }
+        return p_ == end_ ? int(count_ - remaining_) : kErrBadPackage;
+    }
+
+private:
+    void skipSpace()
+    {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            p_++;
+        }
+    }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (p_ < end_ && *p_ == c) {
+            p_++;
+            return true;
+        }
+        return false;
+    }
+
+    /// The raw contents of the string at p_, p_ is moved past the closing quote
+    bool string(const char *&start, size_t &size)
+    {
+        if (p_ >= end_ || *p_ != '"') {
+            return false;
+        }
+        start = ++p_;
+        while (p_ < end_) {
+            char c = *p_;
+            if (c == '"') {
+                size = size_t(p_ - start);
+                p_++;
+                return true;
+            }
+            p_ += c == '\\' ? 2 : 1;
+        }
+        return false;
+    }
+
+    /// A number, true, false or null, p_ is moved past it
+    bool token(const char *&start, size_t &size)
+    {
+        start = p_;
+        while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ']' && *p_ != ' ' && *p_ != '\t' && *p_ != '\n' &&
+               *p_ != '\r' && *p_ != '\0') {
+            p_++;
+        }
+        size = size_t(p_ - start);
+        return size > 0;
+    }
+
+    /// Skip an object or array without looking at its values
+    bool skipContainer()
+    {
+        int depth = 0;
+        while (p_ < end_) {
+            char c = *p_;
+            if (c == '"') {
+                const char *start;
+                size_t size;
+                if (!string(start, size)) {
+                    return false;
+                }
+                continue;
+            }
+            p_++;
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool value(int depth)
+    {
+        skipSpace();
+        if (p_ >= end_) {
+            return false;
+        }
+        bool exact = false;
+        bool prefix = false;
+        for (size_t i = 0; i < count_; i++) {
+            if (!fields_[i].found) {
+                Match match = matchPath(fields_[i].path, path_, depth);
+                exact |= match == Match::Exact;
+                prefix |= match == Match::Prefix;
+            }
+        }
+
+        char c = *p_;
+        if (c == '{' || c == '[') {
+            // A field naming a container does not have one of the scalar types
+            return prefix ? container(depth, c == '{') : skipContainer();
+        }
+        const char *start;
+        size_t size;
+        bool quoted = c == '"';
+        if (!(quoted ? string(start, size) : token(start, size))) {
+            return false;
+        }
+        if (exact) {
+            for (size_t i = 0; i < count_; i++) {
+                JsonField &field = fields_[i];
+                if (!field.found && matchPath(field.path, path_, depth) == Match::Exact) {
+                    if (!store(field, quoted, start, size)) {
+                        return false;
+                    }
+                    if (field.found) {
+                        remaining_--;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool container(int depth, bool object)
+    {
+        if (depth >= kMaxJsonDepth) {
+            return false;
+        }
+        char close = object ? '}' : ']';
+        p_++;
+        if (consume(close)) {
+            return true;
+        }
+        for (size_t index = 0;; index++) {
+            Segment &segment = path_[depth];
+            if (object) {
+                skipSpace();
+                if (!string(segment.key, segment.keySize) || !consume(':')) {
+                    return false;
+                }
+            } else {
+                segment.key = nullptr;
+                segment.index = index;
+            }
+            if (!value(depth + 1)) {
+                return false;
+            }
+            if (remaining_ == 0) {
+                return true;
+            }
+            if (consume(close)) {
+                return true;
+            }
+            if (!consume(',')) {
+                return false;
+            }
+        }
+    }
+
+    /// Write the value into the field if it has the type of the field
+    bool store(JsonField &field, bool quoted, const char *start, size_t size)
+    {
+        switch (field.type) {
+        case JsonType::String:
+            if (quoted && field.string && field.stringSize > 0) {
+                if (!unescape(start, start + size, field.string, field.stringSize)) {
+                    return false;
+                }
+                field.found = true;
+            }
+            break;
+        case JsonType::Bool:
+            if (!quoted && (size == 4 && std::memcmp(start, "true", 4) == 0)) {
+                field.boolValue = true;
+                field.found = true;
+            } else if (!quoted && (size == 5 && std::memcmp(start, "false", 5) == 0)) {
+                field.boolValue = false;
+                field.found = true;
+            }
+            break;
+        case JsonType::Int: {
+            int64_t value;
+            auto result = std::from_chars(start, start + size, value);
+            if (!quoted && result.ec == std::errc() && result.ptr == start + size) {
+                field.intValue = value;
+                field.found = true;
+            }
+            break;
+        }
+        case JsonType::Double: {
+            // strtod needs a terminated string, numbers longer than any double are not one
+            char number[64];
+            bool numeric = !quoted && size < sizeof(number) && (*start == '-' || (*start >= '0' && *start <= '9'));
+            if (numeric) {
+                std::memcpy(number, start, size);
+                number[size] = '\0';
+                char *parsed;
+                double value = std::strtod(number, &parsed);
+                if (parsed == number + size) {
+                    field.doubleValue = value;
+                    field.found = true;
+                }
+            }
+            break;
+        }
+        }
+        return true;
+    }
+
+    const char *p_;
+    const char *const end_;
+    JsonField *const fields_;
+    const size_t count_;
+    size_t remaining_;
+    Segment path_[kMaxJsonDepth];
+};
+
+} // namespace
+
+int scanJson(ConstByteSpan json, JsonField *fields, size_t count)
+{
+    return Scanner(json, fields, count).run();
+}
+
+} // namespace cam
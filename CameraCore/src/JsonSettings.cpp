@@ -0,0 +1,124 @@
+//
+//  JsonSettings.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/JsonSettings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+namespace {
+
+/// Replies still missing after this long without any reply on the channel are taken as lost
+constexpr uint64_t kLostReplyUs = 10000000;
+
+/// Packages of replies received and not read yet, a reply that overflows them does not reassemble
+constexpr size_t kMaxQueuedPackages = 1024;
+
+} // namespace
+
+JsonSettings::JsonSettings(IoctrlChannel &control, uint32_t requestType, uint32_t responseType, size_t pipelineDepth)
+    : transport_(control.transport())
+    , avIndex_(control.avIndex())
+    , requestType_(requestType)
+    , responseType_(responseType)
+    , pipelineDepth_(std::max<size_t>(pipelineDepth, 1))
+    , replies_(control, {responseType}, kMaxQueuedPackages)
+{
+}
+
+int JsonSettings::discardLateReplies(int timeoutMs)
+{
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (lateReplies_ > 0) {
+        int remaining = int(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        int size = remaining > 0 ? recvReassembled(replies_, responseType_, reassembler_, remaining)
+                                 : kErrTimeout;
+        if (size == kErrTimeout) {
+            if (monotonicMicros() - lastActivity_ < kLostReplyUs) {
+                return kErrTimeout;
+            }
+            lateReplies_ = 0;
+            break;
+        }
+        if (size < 0 && size != kErrBadPackage) {
+            return size;
+        }
+        lateReplies_--;
+        lastActivity_ = monotonicMicros();
+    }
+    return kNoError;
+}
+
+int JsonSettings::exchange(JsonCommand *commands, size_t count, int timeoutMs)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!commands[i].json || std::strlen(commands[i].json) + 1 > kMaxIoctrlSize) {
+            return kErrInvalidArg;
+        }
+    }
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    // Until the replies of the last exchange are in, a reply could not be told from theirs
+    int ret = discardLateReplies(timeoutMs);
+    if (ret < 0) {
+        for (size_t i = 0; i < count; i++) {
+            commands[i].result = ret;
+        }
+        return ret;
+    }
+    size_t sent = 0;
+    size_t received = 0;
+    int sendError = kNoError;
+    int recvError = kNoError;
+    while (received < count) {
+        while (sendError == kNoError && sent < count && sent - received < pipelineDepth_) {
+            const char *json = commands[sent].json;
+            ConstByteSpan request{reinterpret_cast<const uint8_t *>(json), std::strlen(json) + 1};
+            sendError = transport_.sendIOCtrl(avIndex_, requestType_, request);
+            if (sendError == kNoError) {
+                sent++;
+                lastActivity_ = monotonicMicros();
+            }
+        }
+        if (received == sent) {
+            break;
+        }
+        int remaining = int(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        int size = remaining > 0 ? recvReassembled(replies_, responseType_, reassembler_, remaining)
+                                 : kErrTimeout;
+        if (size < 0 && size != kErrBadPackage) {
+            recvError = size;
+            break;
+        }
+        // A reply that does not reassemble is still the reply of its command
+        lastActivity_ = monotonicMicros();
+        JsonCommand &command = commands[received++];
+        command.result = size < 0 ? size : scanJson(reassembler_.data(), command.fields, command.fieldCount);
+    }
+
+    lateReplies_ = sent - received;
+    for (size_t i = received; i < count; i++) {
+        commands[i].result = i < sent || sendError == kNoError ? recvError : sendError;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (commands[i].result < 0) {
+            return commands[i].result;
+        }
+    }
+    return kNoError;
+}
+
+} // namespace cam
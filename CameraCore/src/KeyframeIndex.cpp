@@ -0,0 +1,240 @@
+//
+//  KeyframeIndex.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/KeyframeIndex.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+namespace {
+
+/// "CKFI"
+constexpr uint32_t kIndexMagic = 0x49464B43;
+constexpr uint16_t kIndexVersion = 1;
+
+struct IndexHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint64_t sourceSize;
+    int64_t sourceModified;     // ns since 1970
+    uint32_t duration;
+    uint32_t count;
+};
+
+using IndexHeaderCodec = ioctrl::Codec<IndexHeader,
+                                       ioctrl::Member<&IndexHeader::magic>,
+                                       ioctrl::Member<&IndexHeader::version>,
+                                       ioctrl::Reserved<IndexHeader, 2>,
+                                       ioctrl::Member<&IndexHeader::sourceSize>,
+                                       ioctrl::Member<&IndexHeader::sourceModified>,
+                                       ioctrl::Member<&IndexHeader::duration>,
+                                       ioctrl::Member<&IndexHeader::count>>;
+
+using EntryCodec = ioctrl::Codec<KeyframeEntry,
+                                 ioctrl::Member<&KeyframeEntry::offset>,
+                                 ioctrl::Member<&KeyframeEntry::timestamp>,
+                                 ioctrl::Member<&KeyframeEntry::size>>;
+
+bool statVideo(const std::string &path, uint64_t *size, int64_t *modified)
+{
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    *size = uint64_t(st.st_size);
+#if defined(__APPLE__)
+    *modified = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    *modified = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+} // namespace
+
+const KeyframeEntry *KeyframeIndex::findAtOrBefore(uint32_t timestamp) const
+{
+    if (entries.empty()) {
+        return nullptr;
+    }
+    auto it = std::upper_bound(entries.begin(), entries.end(), timestamp,
+                               [](uint32_t t, const KeyframeEntry &e) { return t < e.timestamp; });
+    return it == entries.begin() ? &entries.front() : &*(it - 1);
+}
+
+int KeyframeIndex::save(const std::string &videoPath) const
+{
+    IndexHeader header{kIndexMagic, kIndexVersion, 0, 0, duration, uint32_t(entries.size())};
+    if (!statVideo(videoPath, &header.sourceSize, &header.sourceModified)) {
+        return kErrIO;
+    }
+
+    std::string path = indexPath(videoPath);
+    std::string temporary = path + ".tmp";
+    FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return kErrIO;
+    }
+    auto bytes = IndexHeaderCodec::encode(header);
+    bool ok = std::fwrite(bytes.data(), bytes.size(), 1, file) == 1;
+    for (size_t i = 0; ok && i < entries.size(); i++) {
+        auto entry = EntryCodec::encode(entries[i]);
+        ok = std::fwrite(entry.data(), entry.size(), 1, file) == 1;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return kErrIO;
+    }
+    return kNoError;
+}
+
+int KeyframeIndex::load(const std::string &videoPath)
+{
+    uint64_t size = 0;
+    int64_t modified = 0;
+    if (!statVideo(videoPath, &size, &modified)) {
+        return kErrNotFound;
+    }
+    FILE *file = std::fopen(indexPath(videoPath).c_str(), "rb");
+    if (!file) {
+        return kErrNotFound;
+    }
+
+    int ret = kNoError;
+    std::array<uint8_t, IndexHeaderCodec::size> bytes;
+    IndexHeader header{};
+    if (std::fread(bytes.data(), bytes.size(), 1, file) != 1 ||
+        !IndexHeaderCodec::decode(ConstByteSpan{bytes.data(), bytes.size()}, header) ||
+        header.magic != kIndexMagic || header.version != kIndexVersion ||
+        header.count > header.sourceSize / FrameRecordHeaderCodec::size) {
+        ret = kErrIO;
+    } else if (header.sourceSize != size || header.sourceModified != modified) {
+        ret = kErrNotFound;
+    } else {
+        std::vector<uint8_t> data(size_t(header.count) * EntryCodec::size);
+        if (!data.empty() && std::fread(data.data(), data.size(), 1, file) != 1) {
+            ret = kErrIO;
+        } else {
+            std::vector<KeyframeEntry> loaded;
+            loaded.reserve(header.count);
+            ioctrl::decodeElements<EntryCodec>(ConstByteSpan{data.data(), data.size()}, 0, header.count,
+                                               [&](size_t, const KeyframeEntry &e) { loaded.push_back(e); });
+            entries = std::move(loaded);
+            duration = header.duration;
+        }
+    }
+    std::fclose(file);
+    return ret;
+}
+
+bool KeyframeIndexBuilder::feed(ConstByteSpan data)
+{
+    size_t position = 0;
+    while (valid_ && position < data.size) {
+        if (skip_ > 0) {
+            size_t n = size_t(std::min<uint64_t>(skip_, data.size - position));
+            skip_ -= n;
+            position += n;
+            offset_ += n;
+            if (skip_ == 0) {
+                FrameRecordHeader header;
+                FrameRecordHeaderCodec::load(header_, header);
+                addRecord(recordOffset_, header);
+            }
+            continue;
+        }
+        if (headerFill_ == 0) {
+            recordOffset_ = offset_;
+        }
+        size_t n = std::min(sizeof(header_) - headerFill_, data.size - position);
+        std::memcpy(header_ + headerFill_, data.data + position, n);
+        headerFill_ += n;
+        position += n;
+        offset_ += n;
+        if (headerFill_ < sizeof(header_)) {
+            break;
+        }
+        headerFill_ = 0;
+
+        FrameRecordHeader header;
+        FrameRecordHeaderCodec::load(header_, header);
+        if (header.magic != kFrameRecordMagic) {
+            valid_ = false;
+            break;
+        }
+        // The frame is indexed once all of it arrived, a file cut off in a frame has no entry for it
+        skip_ = header.size;
+        if (skip_ == 0) {
+            addRecord(recordOffset_, header);
+        }
+    }
+    return valid_;
+}
+
+void KeyframeIndexBuilder::addFrame(uint64_t offset, const FrameInfo &info, uint32_t size)
+{
+    addRecord(offset, makeFrameRecordHeader(info, size));
+}
+
+void KeyframeIndexBuilder::addRecord(uint64_t offset, const FrameRecordHeader &header)
+{
+    if (!haveBase_) {
+        base_ = header.timestamp;
+        haveBase_ = true;
+    }
+    // Camera time wraps around, the difference stays right
+    uint32_t time = header.timestamp - base_;
+    index_.duration = std::max(index_.duration, time);
+    if (header.flags & kFrameFlagKeyframe) {
+        index_.entries.push_back(KeyframeEntry{offset, time, header.size});
+    }
+}
+
+int loadKeyframeIndex(const std::string &videoPath, KeyframeIndex &index, bool *scanned)
+{
+    if (scanned) {
+        *scanned = false;
+    }
+    if (index.load(videoPath) == kNoError) {
+        return kNoError;
+    }
+
+    FILE *file = std::fopen(videoPath.c_str(), "rb");
+    if (!file) {
+        return kErrIO;
+    }
+    KeyframeIndexBuilder builder;
+    std::vector<uint8_t> buffer(64 * 1024);
+    size_t n;
+    while ((n = std::fread(buffer.data(), 1, buffer.size(), file)) > 0 && builder.feed(ConstByteSpan{buffer.data(), n})) {
+    }
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (failed || !builder.valid()) {
+        return kErrIO;
+    }
+    if (scanned) {
+        *scanned = true;
+    }
+    index = builder.index();
+    // The index is still usable if it can not be saved, e.g. on a read only volume
+    index.save(videoPath);
+    return kNoError;
+}
+
+} // namespace cam
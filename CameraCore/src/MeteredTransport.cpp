@@ -0,0 +1,95 @@
+//
+//  MeteredTransport.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/MeteredTransport.h"
+
+#include "CameraCore/Clock.h"
+
+namespace cam {
+
+MeteredTransport::MeteredTransport(std::unique_ptr<Transport> transport, SessionMetrics &metrics)
+    : transport_(std::move(transport))
+    , metrics_(metrics)
+{
+    metrics_.setPathType(transport_->pathType());
+}
+
+int MeteredTransport::openChannel(int channel, const std::string &account, const std::string &password)
+{
+    uint64_t start = monotonicMicros();
+    int avIndex = transport_->openChannel(channel, account, password);
+    if (avIndex >= 0) {
+        metrics_.addChannel(avIndex).streamStarted(start);
+    }
+    return avIndex;
+}
+
+void MeteredTransport::closeChannel(int avIndex)
+{
+    transport_->closeChannel(avIndex);
+    metrics_.removeChannel(avIndex);
+}
+
+int MeteredTransport::sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data)
+{
+    uint64_t start = monotonicMicros();
+    int ret = transport_->sendIOCtrl(avIndex, type, data);
+    if (ret >= 0) {
+        metrics_.ioctrlAcknowledged(monotonicMicros() - start);
+    }
+    return ret;
+}
+
+int MeteredTransport::recvIOCtrl(int avIndex, uint32_t *type, ByteSpan buffer, int timeoutMs)
+{
+    return transport_->recvIOCtrl(avIndex, type, buffer, timeoutMs);
+}
+
+int MeteredTransport::recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs)
+{
+    int size = transport_->recvFrame(avIndex, buffer, info, timeoutMs);
+    if (size >= 0) {
+        uint64_t now = monotonicMicros();
+        if (ChannelMetrics *channel = metrics_.channel(avIndex)) {
+            channel->frameReceived(uint32_t(size), now);
+        }
+        uint64_t latency = 0;
+        const ClockSync *clock = clock_.load(std::memory_order_acquire);
+        if (clock && clock->frameLatency(info->timestamp, now, &latency)) {
+            metrics_.frameLatency.recordMicros(latency);
+        }
+        CAM_FRAME_TRACE(trace_, avIndex, info->frameNumber, TraceStage::Received);
+    }
+    return size;
+}
+
+MeteredConnector::MeteredConnector(Connector &connector, std::function<SessionMetrics &(const std::string &uid)> metricsForUid)
+    : connector_(connector)
+    , metricsForUid_(std::move(metricsForUid))
+{
+}
+
+std::unique_ptr<Transport> MeteredConnector::connect(const std::string &uid, int timeoutMs, int *error)
+{
+    uint64_t start = monotonicMicros();
+    std::unique_ptr<Transport> transport = connector_.connect(uid, timeoutMs, error);
+    if (!transport) {
+        return nullptr;
+    }
+    bool reconnect;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reconnect = connectedBefore_[uid];
+        connectedBefore_[uid] = true;
+    }
+    SessionMetrics &metrics = metricsForUid_(uid);
+    metrics.connected(transport->pathType(), monotonicMicros() - start, reconnect);
+    return std::unique_ptr<Transport>(new MeteredTransport(std::move(transport), metrics));
+}
+
+} // namespace cam
@@ -0,0 +1,278 @@
+//
+//  Metrics.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/Metrics.h"
+
+#include <algorithm>
+
+#include "CameraCore/Clock.h"
+
+namespace cam {
+
+double HistogramSnapshot::valueAtPercentile(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t rank = std::max<uint64_t>(1, uint64_t(percentile / 100.0 * double(count) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return i < kBounds.size() ? std::min(kBounds[i], max) : max;
+        }
+    }
+    return max;
+}
+
+void LatencyHistogram::recordMicros(uint64_t us)
+{
+    double ms = double(us) / 1000.0;
+    size_t bucket = size_t(std::lower_bound(HistogramSnapshot::kBounds.begin(), HistogramSnapshot::kBounds.end(), ms) -
+                           HistogramSnapshot::kBounds.begin());
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t current = min_.load(std::memory_order_relaxed);
+    while (us < current && !min_.compare_exchange_weak(current, us, std::memory_order_relaxed)) {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (us > current && !max_.compare_exchange_weak(current, us, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    HistogramSnapshot s;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        s.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        s.count += s.counts[i];
+    }
+    if (s.count > 0) {
+        s.min = double(min_.load(std::memory_order_relaxed)) / 1000.0;
+        s.max = double(max_.load(std::memory_order_relaxed)) / 1000.0;
+        // count_ and sum_ are updated together, the bucket sum may be ahead of them by a few records
+        uint64_t count = std::max<uint64_t>(1, count_.load(std::memory_order_relaxed));
+        s.mean = double(sum_.load(std::memory_order_relaxed)) / 1000.0 / double(count);
+    }
+    return s;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &c : counts_) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+void ChannelMetrics::streamStarted(uint64_t now)
+{
+    lastFrame_.store(0, std::memory_order_relaxed);
+    streamStart_.store(now, std::memory_order_relaxed);
+}
+
+void ChannelMetrics::frameReceived(uint32_t bytes, uint64_t now)
+{
+    framesReceived_.fetch_add(1, std::memory_order_relaxed);
+    bytesReceived_.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t last = lastFrame_.exchange(now, std::memory_order_relaxed);
+    if (last != 0) {
+        frameInterval.recordMicros(now > last ? now - last : 0);
+    }
+    uint64_t start = streamStart_.exchange(0, std::memory_order_relaxed);
+    if (start != 0) {
+        firstFrameLatency.recordMicros(now > start ? now - start : 0);
+    }
+}
+
+void ChannelMetrics::qualitySwitched(int level)
+{
+    qualitySwitches_.fetch_add(1, std::memory_order_relaxed);
+    qualityLevel_.store(level, std::memory_order_relaxed);
+}
+
+ChannelSnapshot ChannelMetrics::snapshot() const
+{
+    ChannelSnapshot s;
+    s.avIndex = avIndex_;
+    s.time = monotonicMicros();
+    s.framesReceived = framesReceived_.load(std::memory_order_relaxed);
+    s.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+    s.bytesReceived = bytesReceived_.load(std::memory_order_relaxed);
+    s.qualitySwitches = qualitySwitches_.load(std::memory_order_relaxed);
+    s.qualityLevel = qualityLevel_.load(std::memory_order_relaxed);
+    s.firstFrameLatency = firstFrameLatency.snapshot();
+    s.firstKeyframeLatency = firstKeyframeLatency.snapshot();
+    s.frameInterval = frameInterval.snapshot();
+    return s;
+}
+
+void ChannelMetrics::reset()
+{
+    framesReceived_.store(0, std::memory_order_relaxed);
+    framesDropped_.store(0, std::memory_order_relaxed);
+    bytesReceived_.store(0, std::memory_order_relaxed);
+    lastFrame_.store(0, std::memory_order_relaxed);
+    streamStart_.store(0, std::memory_order_relaxed);
+    qualitySwitches_.store(0, std::memory_order_relaxed);
+    qualityLevel_.store(-1, std::memory_order_relaxed);
+    firstFrameLatency.reset();
+    firstKeyframeLatency.reset();
+    frameInterval.reset();
+}
+
+void SessionMetrics::connected(PathType pathType, uint64_t micros, bool reconnect)
+{
+    setPathType(pathType);
+    connectLatency.recordMicros(micros);
+    if (reconnect) {
+        reconnectCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SessionMetrics::ioctrlAcknowledged(uint64_t micros)
+{
+    ioctrlCount_.fetch_add(1, std::memory_order_relaxed);
+    ioctrlAckLatency.recordMicros(micros);
+}
+
+SessionMetrics::~SessionMetrics()
+{
+    for (auto &channel : channels_) {
+        delete channel.load(std::memory_order_relaxed);
+    }
+}
+
+ChannelMetrics &SessionMetrics::addChannel(int avIndex)
+{
+    if (avIndex < 0 || avIndex >= kMaxChannels) {
+        return overflow_;
+    }
+    ChannelMetrics *channel = channels_[size_t(avIndex)].load(std::memory_order_acquire);
+    if (!channel) {
+        // Two threads may race to create it, the loser deletes its copy
+        ChannelMetrics *created = new ChannelMetrics(avIndex);
+        if (channels_[size_t(avIndex)].compare_exchange_strong(channel, created, std::memory_order_acq_rel)) {
+            channel = created;
+        } else {
+            delete created;
+        }
+    }
+    active_[size_t(avIndex)].store(true, std::memory_order_relaxed);
+    return *channel;
+}
+
+ChannelMetrics *SessionMetrics::channel(int avIndex)
+{
+    if (avIndex < 0 || avIndex >= kMaxChannels || !active_[size_t(avIndex)].load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return channels_[size_t(avIndex)].load(std::memory_order_acquire);
+}
+
+void SessionMetrics::removeChannel(int avIndex)
+{
+    if (avIndex < 0 || avIndex >= kMaxChannels) {
+        return;
+    }
+    active_[size_t(avIndex)].store(false, std::memory_order_relaxed);
+    if (ChannelMetrics *channel = channels_[size_t(avIndex)].load(std::memory_order_acquire)) {
+        channel->reset();
+    }
+}
+
+SessionSnapshot SessionMetrics::snapshot() const
+{
+    SessionSnapshot s;
+    s.time = monotonicMicros();
+    s.pathType = PathType(pathType_.load(std::memory_order_relaxed));
+    s.reconnectCount = reconnectCount_.load(std::memory_order_relaxed);
+    s.ioctrlCount = ioctrlCount_.load(std::memory_order_relaxed);
+    s.connectLatency = connectLatency.snapshot();
+    s.ioctrlAckLatency = ioctrlAckLatency.snapshot();
+    s.frameLatency = frameLatency.snapshot();
+    for (size_t i = 0; i < channels_.size(); i++) {
+        ChannelMetrics *channel = channels_[i].load(std::memory_order_acquire);
+        if (channel && active_[i].load(std::memory_order_relaxed)) {
+            s.channels.push_back(channel->snapshot());
+        }
+    }
+    return s;
+}
+
+void SessionMetrics::reset()
+{
+    reconnectCount_.store(0, std::memory_order_relaxed);
+    ioctrlCount_.store(0, std::memory_order_relaxed);
+    connectLatency.reset();
+    ioctrlAckLatency.reset();
+    frameLatency.reset();
+    for (auto &channel : channels_) {
+        if (ChannelMetrics *c = channel.load(std::memory_order_acquire)) {
+            c->reset();
+        }
+    }
+}
+
+MetricsReporter::MetricsReporter(const SessionMetrics &metrics, int intervalMs, Callback callback)
+    : metrics_(metrics)
+    , intervalMs_(std::max(intervalMs, 100))
+    , callback_(std::move(callback))
+{
+    thread_ = std::thread(&MetricsReporter::run, this);
+}
+
+MetricsReporter::~MetricsReporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+}
+
+void MetricsReporter::computeRates(const SessionSnapshot &previous, SessionSnapshot &current)
+{
+    for (auto &channel : current.channels) {
+        for (auto &before : previous.channels) {
+            if (before.avIndex != channel.avIndex || channel.time <= before.time ||
+                channel.framesReceived < before.framesReceived) {
+                continue;
+            }
+            double seconds = double(channel.time - before.time) / 1e6;
+            channel.fps = double(channel.framesReceived - before.framesReceived) / seconds;
+            channel.bitrate = double(channel.bytesReceived - before.bytesReceived) * 8 / 1000 / seconds;
+        }
+    }
+}
+
+void MetricsReporter::run()
+{
+    SessionSnapshot previous = metrics_.snapshot();
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (condition_.wait_for(lock, std::chrono::milliseconds(intervalMs_), [this] { return stop_; })) {
+            return;
+        }
+        SessionSnapshot current = metrics_.snapshot();
+        computeRates(previous, current);
+        lock.unlock();
+        callback_(current);
+        lock.lock();
+        previous = std::move(current);
+    }
+}
+
+} // namespace cam
@@ -0,0 +1,344 @@
+//
+//  PlaybackControl.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/PlaybackControl.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+namespace {
+
+/// Replies no command waits for, e.g. of a command that timed out, are dropped beyond this
+constexpr size_t kMaxQueuedReplies = 16;
+
+} // namespace
+
+PlaybackControl::PlaybackControl(IoctrlChannel &control, int channel, std::string account, std::string password)
+    : control_(control)
+    , transport_(control.transport())
+    , avIndex_(control.avIndex())
+    , channel_(channel)
+    , account_(std::move(account))
+    , password_(std::move(password))
+{
+    // PLAY_END is seen whenever it arrives, not only while a command waits for its reply
+    subscription_ = control_.subscribe(
+        {PlayRecord::responseType}, [this](uint32_t, ConstByteSpan data) { replyReceived(data); },
+        [this](int error) {
+            std::lock_guard<std::mutex> lock(replyMutex_);
+            replyError_ = error;
+            replied_.notify_all();
+        });
+    std::lock_guard<std::mutex> lock(replyMutex_);
+    if (control_.error() < 0) {
+        replyError_ = control_.error();
+    }
+}
+
+PlaybackControl::~PlaybackControl()
+{
+    stopPrefetch(true, 1000);
+    stop(1000);
+    control_.unsubscribe(subscription_);
+}
+
+void PlaybackControl::replyReceived(ConstByteSpan data)
+{
+    SMsgAVIoctrlPlayRecordResp response;
+    if (!PlayRecord::decodeResponse(data, response)) {
+        return;
+    }
+    if (response.command == AVIOCTRL_RECORD_PLAY_END) {
+        ended_.store(true, std::memory_order_relaxed);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(replyMutex_);
+    if (replies_.size() >= kMaxQueuedReplies) {
+        replies_.pop_front();
+    }
+    replies_.push_back(response);
+    replied_.notify_all();
+}
+
+int PlaybackControl::command(uint32_t command, uint32_t param, const STimeDay &recordTime, int32_t *result, int timeoutMs)
+{
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    SMsgAVIoctrlPlayRecord request{};
+    request.channel = uint32_t(channel_);
+    request.command = command;
+    request.param = param;
+    request.time = recordTime;
+    auto bytes = PlayRecord::encodeRequest(request);
+    {
+        // Replies of earlier commands are not taken for this one
+        std::lock_guard<std::mutex> lock(replyMutex_);
+        replies_.clear();
+    }
+    int ret = transport_.sendIOCtrl(avIndex_, PlayRecord::requestType, ConstByteSpan{bytes.data(), bytes.size()});
+    if (ret < 0) {
+        return ret;
+    }
+
+    // Replies of other commands are skipped
+    std::unique_lock<std::mutex> lock(replyMutex_);
+    for (;;) {
+        if (!replied_.wait_until(lock, deadline, [this] { return !replies_.empty() || replyError_ < 0; })) {
+            return kErrTimeout;
+        }
+        if (replies_.empty()) {
+            return replyError_;
+        }
+        SMsgAVIoctrlPlayRecordResp response = replies_.front();
+        replies_.pop_front();
+        if (response.command != command) {
+            continue;
+        }
+        if (result) {
+            *result = response.result;
+        }
+        return response.result < 0 ? kErrRejected : kNoError;
+    }
+}
+
+int PlaybackControl::startRecording(const STimeDay &recordTime, int timeoutMs)
+{
+    int32_t channel = -1;
+    int ret = command(AVIOCTRL_RECORD_PLAY_START, 0, recordTime, &channel, timeoutMs);
+    if (ret < 0) {
+        return ret;
+    }
+    // The reply carries the camera channel of the playback, the AV client is started on it
+    int avIndex = transport_.openChannel(channel, account_, password_);
+    if (avIndex < 0) {
+        command(AVIOCTRL_RECORD_PLAY_STOP, 0, recordTime, nullptr, timeoutMs);
+    }
+    return avIndex;
+}
+
+void PlaybackControl::stopRecording(int avIndex, const STimeDay &recordTime, int timeoutMs)
+{
+    command(AVIOCTRL_RECORD_PLAY_STOP, 0, recordTime, nullptr, timeoutMs);
+    transport_.closeChannel(avIndex);
+}
+
+int PlaybackControl::start(const STimeDay &recordTime, int timeoutMs)
+{
+    stop(timeoutMs);
+    // A short recording may end right after the reply
+    ended_.store(false, std::memory_order_relaxed);
+    int avIndex = startRecording(recordTime, timeoutMs);
+    if (avIndex < 0) {
+        return avIndex;
+    }
+    recordTime_ = recordTime;
+    speed_.store(1, std::memory_order_relaxed);
+    awaitKeyframe_.store(false, std::memory_order_relaxed);
+    playbackAvIndex_.store(avIndex, std::memory_order_release);
+    return avIndex;
+}
+
+int PlaybackControl::pause(int timeoutMs)
+{
+    if (playbackAvIndex() < 0) {
+        return kErrInvalidArg;
+    }
+    return command(AVIOCTRL_RECORD_PLAY_PAUSE, 0, recordTime_, nullptr, timeoutMs);
+}
+
+int PlaybackControl::stop(int timeoutMs)
+{
+    int avIndex = playbackAvIndex_.exchange(-1, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock(bufferedMutex_);
+        buffered_.clear();
+    }
+    if (avIndex < 0) {
+        return kNoError;
+    }
+    stopRecording(avIndex, recordTime_, timeoutMs);
+    return kNoError;
+}
+
+int PlaybackControl::seek(uint32_t offsetMs, int timeoutMs)
+{
+    if (playbackAvIndex() < 0) {
+        return kErrInvalidArg;
+    }
+    // Before the command is sent, frames of the new position may arrive before its reply
+    {
+        std::lock_guard<std::mutex> lock(bufferedMutex_);
+        buffered_.clear();
+    }
+    ended_.store(false, std::memory_order_relaxed);
+    awaitKeyframe_.store(true, std::memory_order_release);
+    return command(AVIOCTRL_RECORD_PLAY_SEEKTIME, offsetMs, recordTime_, nullptr, timeoutMs);
+}
+
+int PlaybackControl::setSpeed(unsigned speed, int timeoutMs)
+{
+    if (speed != 1 && speed != 2 && speed != 4 && speed != 8) {
+        return kErrInvalidArg;
+    }
+    if (playbackAvIndex() < 0) {
+        return kErrInvalidArg;
+    }
+    int ret = command(AVIOCTRL_RECORD_PLAY_FORWARD, speed, recordTime_, nullptr, timeoutMs);
+    if (ret < 0) {
+        return ret;
+    }
+    speed_.store(speed, std::memory_order_relaxed);
+    return kNoError;
+}
+
+bool PlaybackControl::accept(const FrameInfo &info)
+{
+    if (awaitKeyframe_.load(std::memory_order_acquire)) {
+        if (!info.isKeyframe()) {
+            return false;
+        }
+        awaitKeyframe_.store(false, std::memory_order_relaxed);
+    }
+    return speed() == 1 || info.isKeyframe();
+}
+
+int PlaybackControl::recvFrame(ByteSpan buffer, FrameInfo *info, int timeoutMs)
+{
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(bufferedMutex_);
+            while (!buffered_.empty()) {
+                BufferedFrame &frame = buffered_.front();
+                if (!accept(frame.info)) {
+                    buffered_.pop_front();
+                    continue;
+                }
+                *info = frame.info;
+                int size = int(frame.data.size());
+                if (frame.data.size() <= buffer.size) {
+                    std::memcpy(buffer.data, frame.data.data(), frame.data.size());
+                }
+                buffered_.pop_front();
+                return size <= int(buffer.size) ? size : kErrBufferTooSmall;
+            }
+        }
+
+        int avIndex = playbackAvIndex();
+        if (avIndex < 0) {
+            return kErrClosed;
+        }
+        int remaining = int(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count());
+        if (remaining <= 0) {
+            return kErrTimeout;
+        }
+        int size = transport_.recvFrame(avIndex, buffer, info, remaining);
+        if (size < 0) {
+            return size;
+        }
+        if (accept(*info)) {
+            return size;
+        }
+    }
+}
+
+void PlaybackControl::prefetchLoop(Transport &transport, Prefetch &prefetch, size_t maxBytes)
+{
+    std::vector<uint8_t> buffer(kMaxFrameSize);
+    while (!prefetch.stop.load(std::memory_order_relaxed)) {
+        FrameInfo info;
+        int size = transport.recvFrame(prefetch.avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 100);
+        if (size == kErrTimeout) {
+            continue;
+        }
+        if (size < 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(prefetch.mutex);
+        // Delivery starts at a keyframe, so the buffered frames decode on their own
+        if (prefetch.frames.empty() && !info.isKeyframe()) {
+            continue;
+        }
+        prefetch.frames.push_back(BufferedFrame{info, std::vector<uint8_t>(buffer.begin(), buffer.begin() + size)});
+        prefetch.bytes += size_t(size);
+        if (prefetch.bytes >= maxBytes) {
+            // The rest stays in the AV channel until playPrefetched
+            return;
+        }
+    }
+}
+
+int PlaybackControl::prefetch(const STimeDay &nextRecordTime, size_t maxBytes, int timeoutMs)
+{
+    stopPrefetch(true, timeoutMs);
+    int avIndex = startRecording(nextRecordTime, timeoutMs);
+    if (avIndex < 0) {
+        return avIndex;
+    }
+    prefetch_.reset(new Prefetch);
+    prefetch_->recordTime = nextRecordTime;
+    prefetch_->avIndex = avIndex;
+    prefetch_->thread = std::thread(prefetchLoop, std::ref(transport_), std::ref(*prefetch_), maxBytes);
+    return avIndex;
+}
+
+void PlaybackControl::stopPrefetch(bool stopRecording, int timeoutMs)
+{
+    if (!prefetch_) {
+        return;
+    }
+    prefetch_->stop.store(true, std::memory_order_relaxed);
+    if (prefetch_->thread.joinable()) {
+        prefetch_->thread.join();
+    }
+    if (stopRecording) {
+        this->stopRecording(prefetch_->avIndex, prefetch_->recordTime, timeoutMs);
+        prefetch_.reset();
+    }
+}
+
+int PlaybackControl::playPrefetched(int timeoutMs)
+{
+    if (!prefetch_) {
+        return kErrNotFound;
+    }
+    stopPrefetch(false, timeoutMs);
+    stop(timeoutMs);
+
+    std::unique_ptr<Prefetch> prefetch = std::move(prefetch_);
+    {
+        std::lock_guard<std::mutex> lock(bufferedMutex_);
+        buffered_ = std::move(prefetch->frames);
+    }
+    recordTime_ = prefetch->recordTime;
+    speed_.store(1, std::memory_order_relaxed);
+    ended_.store(false, std::memory_order_relaxed);
+    awaitKeyframe_.store(false, std::memory_order_relaxed);
+    playbackAvIndex_.store(prefetch->avIndex, std::memory_order_release);
+    return prefetch->avIndex;
+}
+
+size_t PlaybackControl::prefetchedBytes() const
+{
+    if (!prefetch_) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(prefetch_->mutex);
+    return prefetch_->bytes;
+}
+
+} // namespace cam
@@ -0,0 +1,208 @@
+//
+//  QualityControl.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/QualityControl.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlMessages.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+namespace {
+
+/// EWMA weight of a goodput sample (one evaluation period) and of a queueing delay sample (one frame)
+constexpr double kGoodputWeight = 0.3;
+constexpr double kDelayWeight = 1.0 / 8;
+
+constexpr int kMaxUpBackoff = 8;
+
+/// The earliest frame is looked for in the last 60 s, in minima of 1 s
+constexpr uint64_t kLatenessBucketUs = 1000000;
+constexpr size_t kLatenessBuckets = 60;
+
+/// Time of a cameraSetting switch
+constexpr int kSettingTimeoutMs = 5000;
+
+} // namespace
+
+QualityEstimator::QualityEstimator(const QualityControlConfig &config)
+    : config_(config), level_(int(config.levels.size()) - 1)
+{
+}
+
+void QualityEstimator::frameReceived(uint32_t bytes, uint32_t timestamp, uint64_t localUs)
+{
+    bytes_ += bytes;
+    if (!hasFrame_) {
+        hasFrame_ = true;
+        firstLocal_ = localUs;
+        firstTimestamp_ = timestamp;
+    }
+    // Relative to the first frame, the camera timestamp wraps after 49 days
+    lastTimestamp_ = int64_t(int32_t(timestamp - firstTimestamp_));
+    int64_t lateness = int64_t((localUs - std::min(localUs, firstLocal_)) / 1000) - lastTimestamp_;
+
+    // A minimum over a window follows the drift of the camera clock, which adds to every lateness
+    uint64_t bucket = localUs / kLatenessBucketUs;
+    if (latenessMinima_.empty() || latenessMinima_.back().first != bucket) {
+        latenessMinima_.emplace_back(bucket, lateness);
+        while (latenessMinima_.front().first + kLatenessBuckets <= bucket) {
+            latenessMinima_.pop_front();
+        }
+    } else {
+        latenessMinima_.back().second = std::min(latenessMinima_.back().second, lateness);
+    }
+    minLateness_ = lateness;
+    for (const auto &minimum : latenessMinima_) {
+        minLateness_ = std::min(minLateness_, minimum.second);
+    }
+    queueDelayMs_ += kDelayWeight * (double(lateness - minLateness_) - queueDelayMs_);
+}
+
+int QualityEstimator::update(uint64_t now)
+{
+    if (level_ < 0) {
+        return level_;
+    }
+    if (lastUpdate_ != 0 && now > lastUpdate_) {
+        double sample = double(bytes_) * 8000 / double(now - lastUpdate_);
+        goodput_ = hasGoodput_ ? goodput_ + kGoodputWeight * (sample - goodput_) : sample;
+        hasGoodput_ = true;
+    }
+    bytes_ = 0;
+    lastUpdate_ = now;
+
+    // A stalled stream is as late as a frame arriving now would be
+    if (hasFrame_) {
+        int64_t stalled = int64_t((now - std::min(now, firstLocal_)) / 1000) - lastTimestamp_ - minLateness_;
+        queueDelayMs_ = std::max(queueDelayMs_, double(stalled));
+    }
+    highSince_ = queueDelayMs_ > config_.downDelayMs ? (highSince_ ? highSince_ : now) : 0;
+    lowSince_ = queueDelayMs_ < config_.upDelayMs ? (lowSince_ ? lowSince_ : now) : 0;
+    if (now < holdUntil_) {
+        return level_;
+    }
+
+    if (highSince_ && now - highSince_ >= uint64_t(config_.downHoldMs) * 1000 && level_ > 0) {
+        // The link carries the goodput while frames queue, the new level leaves room for the backlog to drain
+        int target = 0;
+        for (int i = level_ - 1; i > 0; i--) {
+            if (config_.levels[size_t(i)].bitrate <= config_.downRatio * goodput_) {
+                target = i;
+                break;
+            }
+        }
+        return target;
+    }
+    uint64_t upHold = uint64_t(config_.upHoldMs) * 1000 * uint64_t(upBackoff_);
+    if (lowSince_ && now - lowSince_ >= upHold && level_ + 1 < int(config_.levels.size())) {
+        return level_ + 1;
+    }
+    return level_;
+}
+
+void QualityEstimator::switched(int level, uint64_t now)
+{
+    if (level < level_ && lastUp_ != 0 && now - lastUp_ < uint64_t(config_.upHoldMs) * 1000) {
+        upBackoff_ = std::min(upBackoff_ * 2, kMaxUpBackoff);
+    }
+    if (level > level_) {
+        lastUp_ = now;
+    }
+    level_ = level;
+    holdUntil_ = now + uint64_t(config_.holdOffMs) * 1000;
+    highSince_ = 0;
+    lowSince_ = 0;
+}
+
+QualityController::QualityController(Transport &transport, int avIndex, int channel, QualityControlConfig config,
+                                     JsonSettings *settings, ChannelMetrics *metrics, Callback onSwitch)
+    : transport_(transport)
+    , avIndex_(avIndex)
+    , channel_(channel)
+    , config_(std::move(config))
+    , settings_(settings)
+    , metrics_(metrics)
+    , onSwitch_(std::move(onSwitch))
+    , estimator_(config_)
+{
+    thread_ = std::thread(&QualityController::run, this);
+}
+
+QualityController::~QualityController()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stopped_.notify_all();
+    thread_.join();
+}
+
+void QualityController::frameReceived(uint32_t bytes, const FrameInfo &info)
+{
+    uint64_t now = monotonicMicros();
+    std::lock_guard<std::mutex> lock(mutex_);
+    estimator_.frameReceived(bytes, info.timestamp, now);
+}
+
+int QualityController::level() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimator_.level();
+}
+
+int QualityController::apply(const QualityLevel &level)
+{
+    if (!level.setting.empty()) {
+        if (!settings_) {
+            return kErrInvalidArg;
+        }
+        JsonCommand command;
+        command.json = level.setting.c_str();
+        return settings_->exchange(&command, 1, kSettingTimeoutMs);
+    }
+    auto request = SetStreamCtrl::encodeRequest(SMsgAVIoctrlStreamCtrl{uint32_t(channel_), level.quality});
+    return transport_.sendIOCtrl(avIndex_, SetStreamCtrl::requestType, ConstByteSpan{request.data(), request.size()});
+}
+
+void QualityController::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_.wait_for(lock, std::chrono::milliseconds(std::max(config_.intervalMs, 1)), [this] { return stop_; })) {
+        QualitySwitch change;
+        change.time = monotonicMicros();
+        change.fromLevel = estimator_.level();
+        change.toLevel = estimator_.update(change.time);
+        if (change.toLevel == change.fromLevel) {
+            continue;
+        }
+        change.goodput = estimator_.goodput();
+        change.queueDelayMs = estimator_.queueDelayMs();
+
+        // The receive thread keeps feeding the estimator while the command waits for its acknowledgment
+        lock.unlock();
+        change.result = apply(config_.levels[size_t(change.toLevel)]);
+        if (change.result >= 0 && metrics_) {
+            metrics_->qualitySwitched(change.toLevel);
+        }
+        if (onSwitch_) {
+            onSwitch_(change);
+        }
+        lock.lock();
+        estimator_.switched(change.result < 0 ? change.fromLevel : change.toLevel, monotonicMicros());
+    }
+}
+
+} // namespace cam
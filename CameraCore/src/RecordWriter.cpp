@@ -0,0 +1,600 @@
+//
+//  RecordWriter.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/RecordWriter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/FrameFile.h"
+#include "CameraCore/KeyframeIndex.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define CAMCORE_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace cam {
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+
+} // namespace
+
+struct RecordWriter::Block
+{
+    explicit Block(size_t size, uint64_t fileOffset)
+        : size(size)
+        , fileOffset(fileOffset)
+    {
+        void *memory = nullptr;
+        if (posix_memalign(&memory, kPageSize, size) != 0) {
+            throw std::bad_alloc();
+        }
+        data = static_cast<uint8_t *>(memory);
+    }
+
+    ~Block() { std::free(data); }
+
+    Block(const Block &) = delete;
+    Block &operator=(const Block &) = delete;
+
+    uint8_t *data;
+    const size_t size;
+    const uint64_t fileOffset;
+    size_t fill = 0;            // Bytes appended
+    size_t submitted = 0;       // Bytes handed to the I/O thread
+};
+
+struct RecordWriter::Recording
+{
+    std::string path;
+    int fd = -1;
+
+    // Appending, guarded by mutex
+    std::mutex mutex;
+    KeyframeIndexBuilder index;
+    uint64_t offset = 0;
+    std::shared_ptr<Block> block;
+    bool awaitKeyframe = false;
+    bool closed = false;
+
+    int pending = 0;            // Writes not completed, guarded by queueMutex_
+    std::atomic<bool> failed{false};
+};
+
+struct RecordWriter::Operation
+{
+    std::shared_ptr<Recording> recording;
+    std::shared_ptr<Block> block;       // Kept alive until the write completed
+    size_t begin;
+    size_t end;
+    struct iovec iov;
+};
+
+#if CAMCORE_HAVE_IO_URING
+
+/// The part of io_uring the writer needs, on the raw system calls so no liburing is required
+class RecordWriter::Uring
+{
+public:
+    ~Uring()
+    {
+        if (sqes_) {
+            munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ && cqRing_ != sqRing_) {
+            munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_) {
+            munmap(sqRing_, sqRingSize_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    /// @return false if io_uring is not available, e.g. an old kernel or a seccomp sandbox
+    bool init(unsigned entries)
+    {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = int(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            return false;
+        }
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) {
+            sqRing_ = nullptr;
+            return false;
+        }
+        if (single) {
+            cqRing_ = sqRing_;
+        } else {
+            cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) {
+                cqRing_ = nullptr;
+                return false;
+            }
+        }
+        sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void *sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+        sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+        auto *sq = static_cast<uint8_t *>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        auto *cq = static_cast<uint8_t *>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+        entries_ = params.sq_entries;
+        return true;
+    }
+
+    unsigned entries() const { return entries_; }
+
+    void prepareWrite(int fd, const struct iovec *iov, uint64_t offset, uint64_t userData)
+    {
+        unsigned tail = *sqTail_;
+        unsigned index = tail & sqMask_;
+        struct io_uring_sqe *sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = fd;
+        sqe->addr = uint64_t(uintptr_t(iov));
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = userData;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    /// Entries prepared and not taken by the kernel are taken back, they are written with pwrite instead
+    void discardUnsubmitted(unsigned count) { __atomic_store_n(sqTail_, *sqTail_ - count, __ATOMIC_RELEASE); }
+
+    int enter(unsigned submit, unsigned wait)
+    {
+        int ret = int(syscall(__NR_io_uring_enter, fd_, submit, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+        return ret < 0 ? -errno : ret;
+    }
+
+    bool popCompletion(uint64_t *userData, int *result)
+    {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        const struct io_uring_cqe &cqe = cqes_[head & cqMask_];
+        *userData = cqe.user_data;
+        *result = cqe.res;
+        __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    int fd_ = -1;
+    unsigned entries_ = 0;
+    void *sqRing_ = nullptr;
+    void *cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    struct io_uring_sqe *sqes_ = nullptr;
+    unsigned *sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned *sqArray_ = nullptr;
+    unsigned *cqHead_ = nullptr;
+    unsigned *cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    struct io_uring_cqe *cqes_ = nullptr;
+};
+
+#else
+
+class RecordWriter::Uring
+{
+public:
+    bool init(unsigned) { return false; }
+    unsigned entries() const { return 0; }
+    void prepareWrite(int, const struct iovec *, uint64_t, uint64_t) {}
+    void discardUnsubmitted(unsigned) {}
+    int enter(unsigned, unsigned) { return -ENOSYS; }
+    bool popCompletion(uint64_t *, int *) { return false; }
+};
+
+#endif
+
+RecordWriter::RecordWriter(RecordWriterConfig config)
+    : config_([&config] {
+        config.blockSize = std::max(kPageSize, (config.blockSize + kPageSize - 1) / kPageSize * kPageSize);
+        config.queueDepth = std::max(config.queueDepth, 1u);
+        return config;
+    }())
+{
+    if (config_.useIoUring) {
+        uring_.reset(new Uring);
+        if (!uring_->init(config_.queueDepth)) {
+            uring_.reset();
+        }
+    }
+    thread_ = std::thread(&RecordWriter::run, this);
+}
+
+RecordWriter::~RecordWriter()
+{
+    std::vector<int> ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : recordings_) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (int id : ids) {
+        close(id);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stop_ = true;
+    }
+    queueChanged_.notify_all();
+    thread_.join();
+}
+
+std::shared_ptr<RecordWriter::Recording> RecordWriter::find(int id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = recordings_.find(id);
+    return it == recordings_.end() ? nullptr : it->second;
+}
+
+int RecordWriter::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return kErrIO;
+    }
+    auto recording = std::make_shared<Recording>();
+    recording->path = path;
+    recording->fd = fd;
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = nextId_++;
+    recordings_[id] = std::move(recording);
+    return id;
+}
+
+int RecordWriter::write(int id, const FrameInfo &info, ConstByteSpan data)
+{
+    std::shared_ptr<Recording> recording = find(id);
+    if (!recording) {
+        return kErrNotFound;
+    }
+    std::lock_guard<std::mutex> lock(recording->mutex);
+    if (recording->closed) {
+        return kErrNotFound;
+    }
+    if (recording->failed.load(std::memory_order_relaxed)) {
+        return kErrIO;
+    }
+    if (recording->awaitKeyframe && !info.isKeyframe()) {
+        framesDropped_.fetch_add(1, std::memory_order_relaxed);
+        return kErrMemoryBudget;
+    }
+
+    size_t size = FrameRecordHeaderCodec::size + data.size;
+    size_t inFlight = bytesInFlight_.load(std::memory_order_relaxed);
+    do {
+        if (inFlight + size > config_.maxBytesInFlight) {
+            framesDropped_.fetch_add(1, std::memory_order_relaxed);
+            recording->awaitKeyframe = true;
+            // The partial blocks hold the budget until they are written, without a flush interval
+            // nothing else would write them and no block could fill again
+            flushLocked(recording);
+            {
+                std::lock_guard<std::mutex> queueLock(queueMutex_);
+                flushRequested_ = true;
+            }
+            queueChanged_.notify_one();
+            return kErrMemoryBudget;
+        }
+    } while (!bytesInFlight_.compare_exchange_weak(inFlight, inFlight + size, std::memory_order_relaxed));
+    size_t peak = peakBytesInFlight_.load(std::memory_order_relaxed);
+    while (inFlight + size > peak && !peakBytesInFlight_.compare_exchange_weak(peak, inFlight + size, std::memory_order_relaxed)) {
+    }
+    recording->awaitKeyframe = false;
+
+    recording->index.addFrame(recording->offset, info, uint32_t(data.size));
+    auto header = FrameRecordHeaderCodec::encode(makeFrameRecordHeader(info, uint32_t(data.size)));
+    append(recording, header.data(), header.size());
+    append(recording, data.data, data.size);
+    framesQueued_.fetch_add(1, std::memory_order_relaxed);
+    return kNoError;
+}
+
+void RecordWriter::append(const std::shared_ptr<Recording> &recording, const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        if (!recording->block) {
+            // Blocks follow each other, so every block starts at a multiple of blockSize
+            recording->block = std::make_shared<Block>(config_.blockSize, recording->offset);
+        }
+        Block &block = *recording->block;
+        size_t count = std::min(size, block.size - block.fill);
+        std::memcpy(block.data + block.fill, data, count);
+        block.fill += count;
+        recording->offset += count;
+        data += count;
+        size -= count;
+        if (block.fill == block.size) {
+            submit(recording, recording->block, block.size);
+            recording->block.reset();
+        }
+    }
+}
+
+void RecordWriter::submit(const std::shared_ptr<Recording> &recording, const std::shared_ptr<Block> &block, size_t end)
+{
+    if (end <= block->submitted) {
+        return;
+    }
+    Operation operation{recording, block, block->submitted, end, {}};
+    block->submitted = end;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        recording->pending++;
+        queue_.push_back(std::move(operation));
+    }
+    queueChanged_.notify_one();
+}
+
+void RecordWriter::flushLocked(const std::shared_ptr<Recording> &recording)
+{
+    // The partial block stays the current block, the next write of it starts where this one ends
+    if (recording->block) {
+        submit(recording, recording->block, recording->block->fill);
+    }
+}
+
+void RecordWriter::flushAll()
+{
+    std::vector<std::shared_ptr<Recording>> recordings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : recordings_) {
+            recordings.push_back(entry.second);
+        }
+    }
+    for (auto &recording : recordings) {
+        std::lock_guard<std::mutex> lock(recording->mutex);
+        flushLocked(recording);
+    }
+}
+
+int RecordWriter::waitWritten(Recording &recording)
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    written_.wait(lock, [&recording] { return recording.pending == 0; });
+    return recording.failed.load() ? kErrIO : kNoError;
+}
+
+int RecordWriter::flush(int id)
+{
+    std::shared_ptr<Recording> recording = find(id);
+    if (!recording) {
+        return kErrNotFound;
+    }
+    {
+        std::lock_guard<std::mutex> lock(recording->mutex);
+        flushLocked(recording);
+    }
+    return waitWritten(*recording);
+}
+
+int RecordWriter::close(int id)
+{
+    std::shared_ptr<Recording> recording;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = recordings_.find(id);
+        if (it == recordings_.end()) {
+            return kErrNotFound;
+        }
+        recording = std::move(it->second);
+        recordings_.erase(it);
+    }
+    {
+        std::lock_guard<std::mutex> lock(recording->mutex);
+        flushLocked(recording);
+        recording->closed = true;
+        recording->block.reset();
+    }
+    int ret = waitWritten(*recording);
+    if (::close(recording->fd) != 0) {
+        ret = kErrIO;
+    }
+    if (ret == kNoError) {
+        // Without the index the recording is scanned once when it is opened
+        recording->index.index().save(recording->path);
+    }
+    return ret;
+}
+
+void RecordWriter::complete(Operation &operation, bool ok)
+{
+    size_t size = operation.end - operation.begin;
+    bytesInFlight_.fetch_sub(size, std::memory_order_relaxed);
+    if (ok) {
+        bytesWritten_.fetch_add(size, std::memory_order_relaxed);
+        writes_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        operation.recording->failed.store(true);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        operation.recording->pending--;
+    }
+    written_.notify_all();
+}
+
+void RecordWriter::writeSync(Operation &operation, size_t done)
+{
+    size_t size = operation.end - operation.begin;
+    while (done < size) {
+        ssize_t ret = pwrite(operation.recording->fd, operation.block->data + operation.begin + done, size - done,
+                             off_t(operation.block->fileOffset + operation.begin + done));
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            complete(operation, false);
+            return;
+        }
+        done += size_t(ret);
+    }
+    complete(operation, true);
+}
+
+void RecordWriter::writeBatch(std::vector<Operation> &batch)
+{
+    if (!uring_) {
+        for (Operation &operation : batch) {
+            writeSync(operation, 0);
+        }
+        return;
+    }
+
+    unsigned count = unsigned(batch.size());
+    for (unsigned i = 0; i < count; i++) {
+        Operation &operation = batch[i];
+        operation.iov.iov_base = operation.block->data + operation.begin;
+        operation.iov.iov_len = operation.end - operation.begin;
+        uring_->prepareWrite(operation.recording->fd, &operation.iov, operation.block->fileOffset + operation.begin, i);
+    }
+    // Submit the batch and wait for all of it with one call, the kernel takes the entries in order
+    unsigned submitted = 0;
+    while (submitted < count) {
+        int ret = uring_->enter(count - submitted, count - submitted);
+        syscalls_.fetch_add(1, std::memory_order_relaxed);
+        if (ret == -EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            break;
+        }
+        submitted += unsigned(ret);
+    }
+    if (submitted < count) {
+        uring_->discardUnsubmitted(count - submitted);
+        for (unsigned i = submitted; i < count; i++) {
+            writeSync(batch[i], 0);
+        }
+    }
+
+    unsigned completed = 0;
+    while (completed < submitted) {
+        uint64_t index = 0;
+        int result = 0;
+        if (!uring_->popCompletion(&index, &result)) {
+            uring_->enter(0, 1);
+            syscalls_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        completed++;
+        Operation &operation = batch[size_t(index)];
+        size_t size = operation.end - operation.begin;
+        if (result < 0) {
+            complete(operation, false);
+        } else if (size_t(result) < size) {
+            writeSync(operation, size_t(result));
+        } else {
+            complete(operation, true);
+        }
+    }
+}
+
+void RecordWriter::run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(config_.flushInterval);
+    const size_t batchSize = uring_ ? std::min<size_t>(config_.queueDepth, uring_->entries()) : config_.queueDepth;
+    auto nextFlush = Clock::now() + interval;
+    std::vector<Operation> batch;
+    batch.reserve(batchSize);
+
+    for (;;) {
+        bool flushNow;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            auto ready = [this] { return stop_ || flushRequested_ || !queue_.empty(); };
+            if (config_.flushInterval > 0) {
+                queueChanged_.wait_until(lock, nextFlush, ready);
+            } else {
+                queueChanged_.wait(lock, ready);
+            }
+            if (stop_ && queue_.empty()) {
+                return;
+            }
+            size_t count = std::min(queue_.size(), batchSize);
+            std::move(queue_.begin(), queue_.begin() + long(count), std::back_inserter(batch));
+            queue_.erase(queue_.begin(), queue_.begin() + long(count));
+            flushNow = flushRequested_;
+            flushRequested_ = false;
+        }
+        if (flushNow || (config_.flushInterval > 0 && Clock::now() >= nextFlush)) {
+            flushAll();
+            nextFlush = Clock::now() + interval;
+        }
+        if (!batch.empty()) {
+            writeBatch(batch);
+            batch.clear();
+        }
+    }
+}
+
+RecordWriterStats RecordWriter::stats() const
+{
+    RecordWriterStats stats;
+    stats.framesQueued = framesQueued_.load(std::memory_order_relaxed);
+    stats.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    stats.writes = writes_.load(std::memory_order_relaxed);
+    stats.syscalls = syscalls_.load(std::memory_order_relaxed);
+    stats.bytesInFlight = bytesInFlight_.load(std::memory_order_relaxed);
+    stats.peakBytesInFlight = peakBytesInFlight_.load(std::memory_order_relaxed);
+    stats.ioUring = uring_ != nullptr;
+    return stats;
+}
+
+} // namespace cam
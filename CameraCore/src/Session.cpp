@@ -0,0 +1,246 @@
+//
+//  Session.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/Session.h"
+
+#include <algorithm>
+#include <new>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+namespace {
+
+/// Longest receive, the time it takes a receive thread to see closeChannel
+constexpr int kReceiveSliceMs = 100;
+
+} // namespace
+
+struct Session::Channel
+{
+    int avIndex = -1;
+    int cameraChannel = 0;
+    std::shared_ptr<FrameHub> hub = std::make_shared<FrameHub>();
+    DecodePool *pool = nullptr;
+    int decodeSession = -1;
+    size_t maxFrameSize = 0;
+    std::atomic<bool> stop{false};
+    std::atomic<int> error{0};
+    std::thread thread;
+    std::unique_ptr<IoctrlChannel> ioctrl;
+};
+
+std::unique_ptr<Session> Session::connect(Connector &connector, const std::string &uid, SessionConfig config,
+                                          int timeoutMs, int *error)
+{
+    uint64_t start = monotonicMicros();
+    std::unique_ptr<Transport> transport = connector.connect(uid, timeoutMs, error);
+    if (!transport) {
+        return nullptr;
+    }
+    auto session = std::make_unique<Session>(std::move(transport), std::move(config));
+    session->metrics_.connected(session->transport_.pathType(), monotonicMicros() - start, false);
+    return session;
+}
+
+Session::Session(std::unique_ptr<Transport> transport, SessionConfig config)
+    : config_(std::move(config))
+    , transport_(std::move(transport), metrics_)
+    , memory_(std::make_shared<SessionMemory>(config_.memoryBudget))
+{
+    transport_.setFrameTrace(config_.trace);
+}
+
+Session::~Session()
+{
+    std::vector<std::unique_ptr<Channel>> channels;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channels.swap(channels_);
+    }
+    for (auto &channel : channels) {
+        stop(*channel);
+    }
+}
+
+int Session::openChannel(int cameraChannel, ChannelConfig config)
+{
+    if (config.pool && !config.decoder) {
+        return kErrInvalidArg;
+    }
+    // A second open of the camera channel waits for the first one and finds it
+    std::lock_guard<std::mutex> openLock(openMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &channel : channels_) {
+            if (channel->cameraChannel == cameraChannel) {
+                return kErrInvalidArg;
+            }
+        }
+    }
+    int avIndex = transport_.openChannel(cameraChannel, config_.account, config_.password);
+    if (avIndex < 0) {
+        return avIndex;
+    }
+
+    auto channel = std::make_unique<Channel>();
+    channel->avIndex = avIndex;
+    channel->cameraChannel = cameraChannel;
+    channel->pool = config.pool;
+    channel->maxFrameSize = config.maxFrameSize;
+    if (channel->pool) {
+        channel->decodeSession =
+            channel->pool->addSession(avIndex, *channel->hub, std::move(config.decoder), config.priority, config_.trace, memory_);
+    }
+    channel->thread = std::thread(&Session::receive, this, std::ref(*channel));
+    std::lock_guard<std::mutex> lock(mutex_);
+    channels_.push_back(std::move(channel));
+    return avIndex;
+}
+
+int Session::closeChannel(int avIndex)
+{
+    std::unique_ptr<Channel> channel;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(channels_.begin(), channels_.end(),
+                               [&](const std::unique_ptr<Channel> &channel) { return channel->avIndex == avIndex; });
+        if (it == channels_.end()) {
+            return kErrNotFound;
+        }
+        channel = std::move(*it);
+        channels_.erase(it);
+    }
+    stop(*channel);
+    return kNoError;
+}
+
+void Session::stop(Channel &channel)
+{
+    channel.stop = true;
+    channel.thread.join();
+    if (channel.pool) {
+        channel.pool->removeSession(channel.decodeSession);
+    }
+    channel.ioctrl.reset();
+    transport_.closeChannel(channel.avIndex);
+}
+
+std::vector<int> Session::openChannels() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int> avIndexes;
+    for (const auto &channel : channels_) {
+        avIndexes.push_back(channel->avIndex);
+    }
+    return avIndexes;
+}
+
+int Session::cameraChannel(int avIndex) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &channel : channels_) {
+        if (channel->avIndex == avIndex) {
+            return channel->cameraChannel;
+        }
+    }
+    return kErrNotFound;
+}
+
+std::shared_ptr<FrameHub> Session::hub(int avIndex) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &channel : channels_) {
+        if (channel->avIndex == avIndex) {
+            return channel->hub;
+        }
+    }
+    return nullptr;
+}
+
+IoctrlChannel *Session::ioctrl(int avIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &channel : channels_) {
+        if (channel->avIndex == avIndex) {
+            if (!channel->ioctrl) {
+                channel->ioctrl = std::make_unique<IoctrlChannel>(transport_, avIndex);
+            }
+            return channel->ioctrl.get();
+        }
+    }
+    return nullptr;
+}
+
+int Session::channelError(int avIndex) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &channel : channels_) {
+        if (channel->avIndex == avIndex) {
+            return channel->error.load(std::memory_order_relaxed);
+        }
+    }
+    return kErrNotFound;
+}
+
+void Session::receive(Channel &channel)
+{
+    // The receive buffer counts against the budget like the frames
+    SessionBytes buffer{SessionAllocator<uint8_t>(memory_)};
+    try {
+        buffer.resize(channel.maxFrameSize);
+    } catch (const std::bad_alloc &) {
+        channel.error = kErrMemoryBudget;
+        return;
+    }
+
+    ChannelMetrics &metrics = metrics_.addChannel(channel.avIndex);
+    bool awaitKeyframe = false;
+    while (!channel.stop) {
+        FrameInfo info;
+        int size = transport_.recvFrame(channel.avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, kReceiveSliceMs);
+        if (size == kErrTimeout) {
+            continue;
+        }
+        if (size == kErrBufferTooSmall) {
+            metrics.frameDropped();
+            awaitKeyframe = true;
+            continue;
+        }
+        if (size < 0) {
+            channel.error = size;
+            return;
+        }
+        // The frames after a dropped one reference it, the pool or the hub gets the next keyframe first
+        if (awaitKeyframe && !info.isKeyframe()) {
+            metrics.frameDropped();
+            continue;
+        }
+        ConstByteSpan data{buffer.data(), size_t(size)};
+        if (channel.pool) {
+            // The pool waits for a keyframe itself after the frames it drops
+            awaitKeyframe = false;
+            if (channel.pool->submit(channel.decodeSession, info, data) == kErrMemoryBudget) {
+                metrics.frameDropped();
+            }
+            continue;
+        }
+        std::shared_ptr<Frame> frame = makeFrame(memory_, channel.avIndex, info, data);
+        awaitKeyframe = !frame;
+        if (frame) {
+            channel.hub->publish(frame);
+            CAM_FRAME_TRACE(config_.trace, channel.avIndex, info.frameNumber, TraceStage::Delivered);
+        } else {
+            metrics.frameDropped();
+        }
+    }
+}
+
+} // namespace cam
@@ -0,0 +1,225 @@
+//
+//  SessionMemory.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/SessionMemory.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cam {
+
+namespace {
+
+constexpr size_t kMinBlock = 64;
+constexpr size_t kAlignment = 16;
+constexpr size_t kLargeClass = SIZE_MAX;
+
+} // namespace
+
+struct SessionMemory::Chunk
+{
+    explicit Chunk(size_t size) : data(new uint8_t[size]), size(size) {}
+
+    std::unique_ptr<uint8_t[]> data;
+    const size_t size;
+    size_t fill = 0;            // Bytes carved into blocks
+    size_t live = 0;            // Blocks in use
+    bool trimmed = false;
+};
+
+/// In front of every block
+struct alignas(kAlignment) SessionMemory::Header
+{
+    Chunk *chunk;               // nullptr for a large block
+    size_t sizeClass;
+};
+
+/// The payload of a released block in the free list of its size class, the header stays intact
+struct SessionMemory::FreeBlock
+{
+    FreeBlock *next;
+};
+
+SessionMemory::SessionMemory(size_t budget, size_t chunkSize)
+    : chunkSize_(std::max(chunkSize, kMinBlock * 4))
+{
+    static_assert(sizeof(Header) == kAlignment, "Blocks are 16 byte aligned");
+    stats_.budget = budget;
+}
+
+SessionMemory::~SessionMemory() = default;
+
+size_t SessionMemory::classOf(size_t size) const
+{
+    size_t block = kMinBlock;
+    for (size_t sizeClass = 0; sizeClass < kClassCount; sizeClass++, block *= 2) {
+        if (block > chunkSize_ / 4) {
+            break;
+        }
+        if (size <= block) {
+            return sizeClass;
+        }
+    }
+    return kLargeClass;
+}
+
+bool SessionMemory::fits(size_t size)
+{
+    if (stats_.budget == 0 || stats_.reserved + size <= stats_.budget) {
+        return true;
+    }
+    // The chunks nobody uses are the memory to give up first
+    trimLocked();
+    return stats_.reserved + size <= stats_.budget;
+}
+
+void *SessionMemory::allocate(size_t size)
+{
+    size_t total = sizeof(Header) + std::max<size_t>(size, 1);
+    size_t sizeClass = classOf(total);
+    std::lock_guard<std::mutex> lock(mutex_);
+    void *block = sizeClass == kLargeClass ? allocateLarge(total) : allocateSmall(total, sizeClass);
+    if (!block) {
+        stats_.refused++;
+        return nullptr;
+    }
+    stats_.allocations++;
+    stats_.peakReserved = std::max(stats_.peakReserved, stats_.reserved);
+    return block;
+}
+
+void *SessionMemory::allocateSmall(size_t, size_t sizeClass)
+{
+    size_t blockSize = kMinBlock << sizeClass;
+    Header *header;
+    if (FreeBlock *block = free_[sizeClass]) {
+        free_[sizeClass] = block->next;
+        header = reinterpret_cast<Header *>(block) - 1;
+    } else {
+        if (!current_ || current_->size - current_->fill < blockSize) {
+            if (!fits(chunkSize_)) {
+                return nullptr;
+            }
+            // The rest of the previous chunk stays unused until the chunk is trimmed
+            chunks_.push_back(std::make_unique<Chunk>(chunkSize_));
+            current_ = chunks_.back().get();
+            stats_.reserved += chunkSize_;
+        }
+        header = reinterpret_cast<Header *>(current_->data.get() + current_->fill);
+        header->chunk = current_;
+        current_->fill += blockSize;
+    }
+    header->sizeClass = sizeClass;
+    header->chunk->live++;
+    stats_.used += blockSize;
+    return header + 1;
+}
+
+void *SessionMemory::allocateLarge(size_t size)
+{
+    if (!fits(size)) {
+        return nullptr;
+    }
+    auto *header = static_cast<Header *>(std::malloc(size));
+    if (!header) {
+        return nullptr;
+    }
+    header->chunk = nullptr;
+    header->sizeClass = kLargeClass;
+    stats_.reserved += size;
+    stats_.used += size;
+    return header + 1;
+}
+
+void SessionMemory::deallocate(void *block, size_t size)
+{
+    if (!block) {
+        return;
+    }
+    Header *header = static_cast<Header *>(block) - 1;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header->sizeClass == kLargeClass) {
+        size_t total = sizeof(Header) + std::max<size_t>(size, 1);
+        std::free(header);
+        stats_.reserved -= total;
+        stats_.used -= total;
+        return;
+    }
+    size_t sizeClass = header->sizeClass;
+    header->chunk->live--;
+    stats_.used -= kMinBlock << sizeClass;
+    auto *freeBlock = static_cast<FreeBlock *>(block);
+    freeBlock->next = free_[sizeClass];
+    free_[sizeClass] = freeBlock;
+}
+
+size_t SessionMemory::trim()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trimLocked();
+}
+
+size_t SessionMemory::trimLocked()
+{
+    size_t count = 0;
+    for (auto &chunk : chunks_) {
+        chunk->trimmed = chunk->live == 0;
+        count += chunk->trimmed;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    // Unlink the blocks of the trimmed chunks from the free lists before the chunks go
+    for (FreeBlock *&list : free_) {
+        FreeBlock **link = &list;
+        while (*link) {
+            if ((reinterpret_cast<Header *>(*link) - 1)->chunk->trimmed) {
+                *link = (*link)->next;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+    if (current_ && current_->trimmed) {
+        current_ = nullptr;
+    }
+    chunks_.erase(std::remove_if(chunks_.begin(), chunks_.end(), [](const std::unique_ptr<Chunk> &chunk) { return chunk->trimmed; }),
+                  chunks_.end());
+    size_t bytes = count * chunkSize_;
+    stats_.reserved -= bytes;
+    stats_.trims += count;
+    return bytes;
+}
+
+void SessionMemory::setBudget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.budget = budget;
+    if (budget != 0 && stats_.reserved > budget) {
+        trimLocked();
+    }
+}
+
+SessionMemoryStats SessionMemory::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool assignSessionBytes(SessionBytes &buffer, const uint8_t *data, size_t size)
+{
+    try {
+        buffer.assign(data, data + size);
+        return true;
+    } catch (const std::bad_alloc &) {
+        SessionBytes(buffer.get_allocator()).swap(buffer);
+        return false;
+    }
+}
+
+} // namespace cam
@@ -0,0 +1,799 @@
+//
+//  SimulatedDevice.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/SimulatedDevice.h"
+
+#include <sys/types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/FrameFile.h"
+#include "CameraCore/KeyframeIndex.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+namespace {
+
+/// Events of one LISTEVENT reply: the fixed part and as many SAvEvent as fit in one IO control
+constexpr size_t kEventsPerReply = (kMaxIoctrlSize - SMsgAVIoctrlListEventRespCodec::size) / SAvEventCodec::size;
+
+int compareTime(const STimeDay &a, const STimeDay &b)
+{
+    // wday is derived from the date and not compared
+    const int left[] = {a.year, a.month, a.day, a.hour, a.minute, a.second};
+    const int right[] = {b.year, b.month, b.day, b.hour, b.minute, b.second};
+    for (size_t i = 0; i < 6; i++) {
+        if (left[i] != right[i]) {
+            return left[i] < right[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+double qualityScale(uint8_t quality)
+{
+    switch (quality) {
+        case AVIOCTRL_QUALITY_HIGH: return 0.7;
+        case AVIOCTRL_QUALITY_MIDDLE: return 0.5;
+        case AVIOCTRL_QUALITY_LOW: return 0.3;
+        case AVIOCTRL_QUALITY_MIN: return 0.15;
+        default: return 1;
+    }
+}
+
+void sleepMicros(uint64_t us)
+{
+    if (us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+} // namespace
+
+class SimulatedDevice::Session
+{
+public:
+    Session(SimulatedDevice &device, uint32_t seed)
+        : device_(device)
+        , config_(device.config_)
+        , random_(seed)
+    {
+    }
+
+    ~Session()
+    {
+        for (auto &entry : channels_) {
+            if (entry.second->file) {
+                fclose(entry.second->file);
+            }
+        }
+    }
+
+    int openChannel(int channel, const std::string &account, const std::string &password);
+    void closeChannel(int avIndex);
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data);
+    int recvIOCtrl(int avIndex, uint32_t *type, ByteSpan buffer, int timeoutMs);
+    int recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs);
+    void reportEvent(uint32_t channel, const std::vector<uint8_t> &event);
+
+private:
+    struct Message
+    {
+        uint64_t deliverAt;
+        uint32_t type;
+        std::vector<uint8_t> data;
+    };
+
+    struct Channel
+    {
+        int cameraChannel = 0;
+        bool closed = false;
+        std::deque<Message> ioctrls;
+        uint64_t lastIoctrl = 0;
+
+        // Next frame, produced ahead of its due time so loss and jitter are drawn once
+        bool hasFrame = false;
+        FrameInfo info;
+        uint32_t size = 0;
+        uint64_t due = 0;
+        uint64_t source = 0;            // Generated frame index or file offset of the frame
+        uint32_t position = 0;          // Time from the beginning of the recording (ms)
+        std::vector<uint8_t> data;      // Frame of a recording file
+        uint32_t frameNumber = 0;
+        uint64_t lastDue = 0;
+        uint64_t linkFree = 0;
+
+        // Live view
+        bool streaming = false;
+        uint64_t streamStart = 0;
+        uint64_t nextSource = 0;
+        uint64_t gopStart = 0;          // Generated frame index of the first keyframe
+
+        // Playback
+        bool playback = false;
+        int controlAvIndex = -1;
+        const SimulatedRecording *recording = nullptr;
+        FILE *file = nullptr;
+        KeyframeIndex index;
+        uint32_t firstTimestamp = 0;
+        bool stopped = false;
+        bool paused = false;
+        bool ended = false;
+        bool endReported = false;
+        unsigned speed = 1;
+        uint64_t playStart = 0;         // Local time the frame at playBase is sent (us)
+        uint32_t playBase = 0;
+    };
+
+    struct PendingPlayback
+    {
+        const SimulatedRecording *recording;
+        int controlAvIndex;
+    };
+
+    Channel *find(int avIndex)
+    {
+        auto it = channels_.find(avIndex);
+        return it == channels_.end() ? nullptr : it->second.get();
+    }
+
+    uint64_t jitter()
+    {
+        if (config_.jitter <= 0) {
+            return 0;
+        }
+        return std::uniform_int_distribution<uint64_t>(0, uint64_t(config_.jitter) * 1000)(random_);
+    }
+
+    void post(Channel &channel, uint32_t type, const uint8_t *data, size_t size, uint64_t deliverAt);
+
+    template <typename Codec>
+    void reply(Channel &channel, uint32_t type, const typename Codec::Struct &message, uint64_t deliverAt)
+    {
+        auto bytes = Codec::encode(message);
+        post(channel, type, bytes.data(), bytes.size(), deliverAt);
+    }
+
+    void listEvents(Channel &channel, const SMsgAVIoctrlListEventReq &request, uint64_t deliverAt);
+    int32_t playControl(int avIndex, const SMsgAVIoctrlPlayRecord &request, uint64_t now);
+    Channel *findPlayback(int controlAvIndex, const STimeDay &time);
+    void rewind(Channel &channel);
+    void seekPlayback(Channel &channel, uint32_t offset, uint64_t now);
+    bool produce(Channel &channel, uint64_t now);
+    bool produceLive(Channel &channel);
+    bool producePlayback(Channel &channel);
+    void fill(Channel &channel, uint8_t *out) const;
+
+    SimulatedDevice &device_;
+    const SimulatorConfig &config_;
+    std::mt19937 random_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::map<int, std::unique_ptr<Channel>> channels_;
+    std::map<int, PendingPlayback> pending_;
+    int nextAvIndex_ = 0;
+};
+
+void SimulatedDevice::Session::post(Channel &channel, uint32_t type, const uint8_t *data, size_t size, uint64_t deliverAt)
+{
+    // IO controls are reliable and ordered, jitter only delays them
+    deliverAt = std::max(deliverAt, channel.lastIoctrl);
+    channel.lastIoctrl = deliverAt;
+    channel.ioctrls.push_back(Message{deliverAt, type, std::vector<uint8_t>(data, data + size)});
+    changed_.notify_all();
+}
+
+int SimulatedDevice::Session::openChannel(int channel, const std::string &account, const std::string &password)
+{
+    sleepMicros(uint64_t(config_.delay) * 2000);
+    if (account != config_.account || password != config_.password) {
+        return kErrRejected;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<Channel> opened(new Channel);
+    opened->cameraChannel = channel;
+    if (channel >= kPlaybackChannelBase) {
+        auto it = pending_.find(channel);
+        if (it == pending_.end()) {
+            return kErrNotFound;
+        }
+        opened->playback = true;
+        opened->recording = it->second.recording;
+        opened->controlAvIndex = it->second.controlAvIndex;
+        pending_.erase(it);
+        if (!opened->recording->path.empty()) {
+            if (loadKeyframeIndex(opened->recording->path, opened->index) < 0) {
+                return kErrIO;
+            }
+            opened->file = fopen(opened->recording->path.c_str(), "rb");
+            uint8_t bytes[FrameRecordHeaderCodec::size];
+            FrameRecordHeader first;
+            if (!opened->file || fread(bytes, 1, sizeof(bytes), opened->file) != sizeof(bytes) ||
+                !FrameRecordHeaderCodec::decode(ConstByteSpan{bytes, sizeof(bytes)}, first)) {
+                if (opened->file) {
+                    fclose(opened->file);
+                }
+                return kErrIO;
+            }
+            // Positions are relative to the first frame, like the timestamps of KeyframeIndex
+            opened->firstTimestamp = first.timestamp;
+            fseeko(opened->file, 0, SEEK_SET);
+        }
+        opened->playStart = monotonicMicros();
+    } else if (channel < 0 || channel >= config_.channels) {
+        return kErrInvalidArg;
+    }
+    int avIndex = nextAvIndex_++;
+    channels_[avIndex] = std::move(opened);
+    return avIndex;
+}
+
+void SimulatedDevice::Session::closeChannel(int avIndex)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel *channel = find(avIndex);
+    if (!channel) {
+        return;
+    }
+    // Kept until the session ends, so a receive thread still waiting on it sees kErrClosed
+    channel->closed = true;
+    channel->hasFrame = false;
+    if (channel->file) {
+        fclose(channel->file);
+        channel->file = nullptr;
+    }
+    changed_.notify_all();
+}
+
+int SimulatedDevice::Session::sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data)
+{
+    uint64_t sent = monotonicMicros();
+    uint64_t delay = uint64_t(config_.delay) * 1000;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Channel *channel = find(avIndex);
+        if (!channel) {
+            return kErrInvalidArg;
+        }
+        if (channel->closed) {
+            return kErrClosed;
+        }
+        // The camera handles the request after one way, the reply arrives after the round trip
+        uint64_t handled = sent + delay;
+        uint64_t answered = sent + 2 * delay + jitter();
+        switch (type) {
+            case IOTYPE_USER_IPCAM_START:
+                if (!channel->playback && !channel->streaming) {
+                    channel->streaming = true;
+                    channel->streamStart = handled;
+                    channel->nextSource = 0;
+                    channel->gopStart = uint64_t(std::max(config_.firstKeyframe, 0));
+                    channel->hasFrame = false;
+                }
+                break;
+            case IOTYPE_USER_IPCAM_STOP:
+                channel->streaming = false;
+                channel->hasFrame = false;
+                break;
+            case IOTYPE_USER_IPCAM_LISTEVENT_REQ: {
+                SMsgAVIoctrlListEventReq request;
+                if (SMsgAVIoctrlListEventReqCodec::decode(data, request)) {
+                    listEvents(*channel, request, answered);
+                }
+                break;
+            }
+            case IOTYPE_USER_IPCAM_RECORD_PLAYCONTROL: {
+                SMsgAVIoctrlPlayRecord request;
+                if (SMsgAVIoctrlPlayRecordCodec::decode(data, request)) {
+                    int32_t result = playControl(avIndex, request, handled);
+                    channel = find(avIndex);
+                    reply<SMsgAVIoctrlPlayRecordRespCodec>(*channel, PlayRecord::responseType,
+                                                           SMsgAVIoctrlPlayRecordResp{request.command, result}, answered);
+                }
+                break;
+            }
+            case IOTYPE_USER_IPCAM_SETSTREAMCTRL_REQ: {
+                SMsgAVIoctrlStreamCtrl request;
+                if (SMsgAVIoctrlStreamCtrlCodec::decode(data, request)) {
+                    int32_t result = -1;
+                    {
+                        std::lock_guard<std::mutex> deviceLock(device_.mutex_);
+                        if (request.channel < device_.quality_.size()) {
+                            device_.quality_[request.channel] = request.quality;
+                            result = 0;
+                        }
+                    }
+                    reply<SMsgAVIoctrlResultCodec>(*channel, SetStreamCtrl::responseType, SMsgAVIoctrlResult{result}, answered);
+                }
+                break;
+            }
+            case IOTYPE_USER_IPCAM_GETSTREAMCTRL_REQ: {
+                SMsgAVIoctrlAVStream request;
+                if (SMsgAVIoctrlAVStreamCodec::decode(data, request)) {
+                    uint8_t quality = device_.quality(int(request.channel));
+                    reply<SMsgAVIoctrlStreamCtrlCodec>(*channel, GetStreamCtrl::responseType,
+                                                       SMsgAVIoctrlStreamCtrl{request.channel, quality}, answered);
+                }
+                break;
+            }
+            case IOTYPE_USER_IPCAM_DEVINFO_REQ: {
+                SMsgAVIoctrlDeviceInfoResp response{};
+                std::strncpy(response.model, "Simulator", sizeof(response.model));
+                std::strncpy(response.vendor, "CameraCore", sizeof(response.vendor));
+                response.version = 1;
+                response.channel = uint32_t(config_.channels);
+                response.total = 32768;
+                response.free = 16384;
+                reply<SMsgAVIoctrlDeviceInfoRespCodec>(*channel, DeviceInfo::responseType, response, answered);
+                break;
+            }
+            default:
+                if (config_.keyframeRequestType != 0 && type == config_.keyframeRequestType && channel->streaming) {
+                    // A frame produced ahead is sent as it is, the next one produced is the keyframe
+                    channel->gopStart = channel->nextSource;
+                }
+                // Acknowledged without an answer, like firmware that does not know the command
+                break;
+        }
+        changed_.notify_all();
+    }
+    // avSendIOCtrl returns with the acknowledgment
+    sleepMicros(sent + 2 * delay - std::min(sent + 2 * delay, monotonicMicros()));
+    return kNoError;
+}
+
+void SimulatedDevice::Session::listEvents(Channel &channel, const SMsgAVIoctrlListEventReq &request, uint64_t deliverAt)
+{
+    std::vector<const SimulatedRecording *> matches;
+    for (const SimulatedRecording &recording : config_.recordings) {
+        if (compareTime(recording.time, request.startTime) >= 0 && compareTime(recording.time, request.endTime) <= 0 &&
+            (request.event == 0 || request.event == recording.event)) {
+            matches.push_back(&recording);
+        }
+    }
+    size_t total = std::max<size_t>(1, (matches.size() + kEventsPerReply - 1) / kEventsPerReply);
+    for (size_t index = 0; index < total; index++) {
+        size_t first = index * kEventsPerReply;
+        size_t count = std::min(kEventsPerReply, matches.size() - std::min(first, matches.size()));
+        uint8_t bytes[kMaxIoctrlSize];
+        SMsgAVIoctrlListEventRespCodec::store(bytes, SMsgAVIoctrlListEventResp{request.channel, uint32_t(total), uint8_t(index),
+                                                                               uint8_t(index + 1 == total), uint8_t(count)});
+        for (size_t i = 0; i < count; i++) {
+            const SimulatedRecording &recording = *matches[first + i];
+            SAvEventCodec::store(bytes + SMsgAVIoctrlListEventRespCodec::size + i * SAvEventCodec::size,
+                                 SAvEvent{recording.time, recording.event, 0});
+        }
+        post(channel, ListEvent::responseType, bytes, SMsgAVIoctrlListEventRespCodec::size + count * SAvEventCodec::size, deliverAt);
+    }
+}
+
+SimulatedDevice::Session::Channel *SimulatedDevice::Session::findPlayback(int controlAvIndex, const STimeDay &time)
+{
+    for (auto it = channels_.rbegin(); it != channels_.rend(); ++it) {
+        Channel &channel = *it->second;
+        if (channel.playback && !channel.closed && !channel.stopped && channel.controlAvIndex == controlAvIndex &&
+            compareTime(channel.recording->time, time) == 0) {
+            return &channel;
+        }
+    }
+    return nullptr;
+}
+
+int32_t SimulatedDevice::Session::playControl(int avIndex, const SMsgAVIoctrlPlayRecord &request, uint64_t now)
+{
+    if (request.command == AVIOCTRL_RECORD_PLAY_START) {
+        for (const SimulatedRecording &recording : config_.recordings) {
+            if (compareTime(recording.time, request.time) == 0) {
+                int channel = device_.nextPlaybackChannel_.fetch_add(1, std::memory_order_relaxed);
+                pending_[channel] = PendingPlayback{&recording, avIndex};
+                return channel;
+            }
+        }
+        return -1;
+    }
+    Channel *playback = findPlayback(avIndex, request.time);
+    if (request.command == AVIOCTRL_RECORD_PLAY_STOP) {
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            bool match = it->second.controlAvIndex == avIndex && compareTime(it->second.recording->time, request.time) == 0;
+            it = match ? pending_.erase(it) : std::next(it);
+        }
+        if (playback) {
+            playback->stopped = true;
+            playback->hasFrame = false;
+        }
+        return 0;
+    }
+    if (!playback) {
+        return -1;
+    }
+    switch (request.command) {
+        case AVIOCTRL_RECORD_PLAY_PAUSE:
+            playback->paused = !playback->paused;
+            rewind(*playback);
+            playback->playStart = now;
+            playback->playBase = playback->position;
+            return 0;
+        case AVIOCTRL_RECORD_PLAY_FORWARD:
+            if (request.param != 1 && request.param != 2 && request.param != 4 && request.param != 8) {
+                return -1;
+            }
+            rewind(*playback);
+            playback->speed = request.param;
+            playback->playStart = now;
+            playback->playBase = playback->position;
+            return 0;
+        case AVIOCTRL_RECORD_PLAY_SEEKTIME:
+            seekPlayback(*playback, request.param, now);
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+void SimulatedDevice::Session::rewind(Channel &channel)
+{
+    // The produced frame is not sent yet, it is produced again with the new timing
+    if (!channel.hasFrame) {
+        return;
+    }
+    channel.hasFrame = false;
+    channel.frameNumber = channel.info.frameNumber;
+    channel.lastDue = 0;
+    if (channel.file) {
+        fseeko(channel.file, off_t(channel.source), SEEK_SET);
+    } else {
+        channel.nextSource = channel.source;
+    }
+}
+
+void SimulatedDevice::Session::seekPlayback(Channel &channel, uint32_t offset, uint64_t now)
+{
+    rewind(channel);
+    channel.ended = false;
+    channel.endReported = false;
+    channel.lastDue = 0;
+    if (channel.file) {
+        const KeyframeEntry *entry = channel.index.findAtOrBefore(offset);
+        fseeko(channel.file, entry ? off_t(entry->offset) : 0, SEEK_SET);
+        channel.position = entry ? entry->timestamp : 0;
+    } else {
+        uint64_t frame = uint64_t(offset) * uint64_t(config_.fps) / 1000;
+        channel.nextSource = frame - frame % uint64_t(config_.gop);
+        channel.position = uint32_t(channel.nextSource * 1000 / uint64_t(config_.fps));
+    }
+    channel.playStart = now;
+    channel.playBase = channel.position;
+}
+
+bool SimulatedDevice::Session::produceLive(Channel &channel)
+{
+    uint64_t index = channel.nextSource++;
+    bool keyframe = index >= channel.gopStart && (index - channel.gopStart) % uint64_t(config_.gop) == 0;
+    double scale = qualityScale(device_.quality(channel.cameraChannel));
+    uint32_t size = uint32_t(double(keyframe ? config_.keyframeSize : config_.frameSize) * scale);
+
+    uint64_t capture = channel.streamStart + index * 1000000 / uint64_t(config_.fps);
+    channel.source = index;
+    channel.info = FrameInfo{};
+    channel.info.codecId = config_.codecId;
+    channel.info.flags = keyframe ? kFrameFlagKeyframe : 0;
+    channel.info.channel = uint8_t(channel.cameraChannel);
+    channel.info.timestamp = uint32_t(capture / 1000);
+    channel.size = std::max<uint32_t>(size, 8);
+    channel.due = capture + uint64_t(config_.delay) * 1000;
+    return true;
+}
+
+bool SimulatedDevice::Session::producePlayback(Channel &channel)
+{
+    if (channel.stopped || channel.paused || channel.ended) {
+        return false;
+    }
+    const SimulatedRecording &recording = *channel.recording;
+    if (channel.file) {
+        channel.source = uint64_t(ftello(channel.file));
+        uint8_t bytes[FrameRecordHeaderCodec::size];
+        FrameRecordHeader header;
+        bool read = fread(bytes, 1, sizeof(bytes), channel.file) == sizeof(bytes) &&
+                    FrameRecordHeaderCodec::decode(ConstByteSpan{bytes, sizeof(bytes)}, header) && header.magic == kFrameRecordMagic;
+        if (read) {
+            channel.data.resize(header.size);
+            read = fread(channel.data.data(), 1, header.size, channel.file) == header.size;
+        }
+        if (!read) {
+            channel.ended = true;
+            return false;
+        }
+        channel.info = FrameInfo{};
+        channel.info.codecId = header.codecId;
+        channel.info.flags = header.flags;
+        channel.info.timestamp = header.timestamp;
+        channel.size = header.size;
+        channel.position = header.timestamp - channel.firstTimestamp;
+    } else {
+        uint64_t index = channel.nextSource;
+        uint32_t position = uint32_t(index * 1000 / uint64_t(config_.fps));
+        if (position > recording.duration) {
+            channel.ended = true;
+            return false;
+        }
+        channel.nextSource++;
+        channel.source = index;
+        bool keyframe = index % uint64_t(config_.gop) == 0;
+        channel.info = FrameInfo{};
+        channel.info.codecId = config_.codecId;
+        channel.info.flags = keyframe ? kFrameFlagKeyframe : 0;
+        channel.info.timestamp = position;
+        channel.size = std::max<uint32_t>(keyframe ? config_.keyframeSize : config_.frameSize, 8);
+        channel.position = position;
+    }
+    channel.info.channel = uint8_t(channel.cameraChannel);
+
+    uint64_t due = channel.playStart;
+    if (config_.pacedPlayback && channel.position > channel.playBase) {
+        due += uint64_t(channel.position - channel.playBase) * 1000 / channel.speed;
+    }
+    channel.due = due + uint64_t(config_.delay) * 1000;
+    return true;
+}
+
+bool SimulatedDevice::Session::produce(Channel &channel, uint64_t now)
+{
+    for (;;) {
+        bool produced = channel.playback ? producePlayback(channel) : channel.streaming && produceLive(channel);
+        if (!produced) {
+            if (channel.playback && channel.ended && !channel.endReported) {
+                Channel *control = find(channel.controlAvIndex);
+                if (control && !control->closed) {
+                    reply<SMsgAVIoctrlPlayRecordRespCodec>(*control, PlayRecord::responseType,
+                                                           SMsgAVIoctrlPlayRecordResp{AVIOCTRL_RECORD_PLAY_END, 0},
+                                                           std::max(now, channel.lastDue));
+                }
+                channel.endReported = true;
+            }
+            return false;
+        }
+        channel.info.frameNumber = channel.frameNumber++;
+        if (config_.lossRate > 0 && std::uniform_real_distribution<double>(0, 1)(random_) < config_.lossRate) {
+            device_.framesLost_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // Jitter delays a frame but does not reorder, the link sends one frame after the other
+        uint64_t due = std::max(channel.due + jitter(), channel.lastDue);
+        if (config_.bandwidth > 0) {
+            due = std::max(due, channel.linkFree);
+            channel.linkFree = due + uint64_t(channel.size) * 8000 / config_.bandwidth;
+        }
+        channel.due = due;
+        channel.lastDue = due;
+        channel.hasFrame = true;
+        return true;
+    }
+}
+
+void SimulatedDevice::Session::fill(Channel &channel, uint8_t *out) const
+{
+    if (channel.playback && channel.file) {
+        std::memcpy(out, channel.data.data(), channel.size);
+        return;
+    }
+    // Annex B start code, NAL header and a body without start code emulation
+    static const uint8_t kStartCode[] = {0, 0, 0, 1};
+    std::memcpy(out, kStartCode, sizeof(kStartCode));
+    out[4] = channel.info.isKeyframe() ? 0x65 : 0x41;
+    std::memset(out + 5, 0x10 + int(channel.info.frameNumber % 0xE0), channel.size - 5);
+}
+
+int SimulatedDevice::Session::recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs)
+{
+    uint64_t deadline = monotonicMicros() + uint64_t(std::max(timeoutMs, 0)) * 1000;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Channel *channel = find(avIndex);
+        if (!channel) {
+            return kErrInvalidArg;
+        }
+        if (channel->closed) {
+            return kErrClosed;
+        }
+        uint64_t now = monotonicMicros();
+        if (!channel->hasFrame) {
+            produce(*channel, now);
+        }
+        if (channel->hasFrame && channel->due <= now) {
+            *info = channel->info;
+            channel->hasFrame = false;
+            if (channel->size > buffer.size) {
+                // Dropped like avRecvFrameData2 drops it, the next call gets the next frame
+                return kErrBufferTooSmall;
+            }
+            fill(*channel, buffer.data);
+            device_.framesSent_.fetch_add(1, std::memory_order_relaxed);
+            return int(channel->size);
+        }
+        if (now >= deadline) {
+            return kErrTimeout;
+        }
+        uint64_t until = channel->hasFrame ? std::min(channel->due, deadline) : deadline;
+        changed_.wait_for(lock, std::chrono::microseconds(until - now));
+    }
+}
+
+int SimulatedDevice::Session::recvIOCtrl(int avIndex, uint32_t *type, ByteSpan buffer, int timeoutMs)
+{
+    uint64_t deadline = monotonicMicros() + uint64_t(std::max(timeoutMs, 0)) * 1000;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Channel *channel = find(avIndex);
+        if (!channel) {
+            return kErrInvalidArg;
+        }
+        if (channel->closed) {
+            return kErrClosed;
+        }
+        uint64_t now = monotonicMicros();
+        if (!channel->ioctrls.empty() && channel->ioctrls.front().deliverAt <= now) {
+            Message &message = channel->ioctrls.front();
+            if (message.data.size() > buffer.size) {
+                return kErrBufferTooSmall;
+            }
+            std::memcpy(buffer.data, message.data.data(), message.data.size());
+            *type = message.type;
+            int size = int(message.data.size());
+            channel->ioctrls.pop_front();
+            return size;
+        }
+        // Playback frames that run out end the recording, the camera reports it without a receiver
+        for (auto &entry : channels_) {
+            Channel &playback = *entry.second;
+            if (playback.playback && playback.controlAvIndex == avIndex && !playback.hasFrame && !playback.closed) {
+                produce(playback, now);
+            }
+        }
+        if (now >= deadline) {
+            return kErrTimeout;
+        }
+        uint64_t until = channel->ioctrls.empty() ? deadline : std::min(channel->ioctrls.front().deliverAt, deadline);
+        changed_.wait_for(lock, std::chrono::microseconds(until - now));
+    }
+}
+
+void SimulatedDevice::Session::reportEvent(uint32_t channel, const std::vector<uint8_t> &event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t deliverAt = monotonicMicros() + uint64_t(config_.delay) * 1000 + jitter();
+    for (auto &entry : channels_) {
+        Channel &open = *entry.second;
+        if (!open.closed && !open.playback && open.cameraChannel == int(channel)) {
+            post(open, IOTYPE_USER_IPCAM_EVENT_REPORT, event.data(), event.size(), deliverAt);
+        }
+    }
+}
+
+class SimulatedDevice::SessionTransport : public Transport
+{
+public:
+    SessionTransport(std::shared_ptr<Session> session, PathType pathType)
+        : session_(std::move(session))
+        , pathType_(pathType)
+    {
+    }
+
+    int openChannel(int channel, const std::string &account, const std::string &password) override
+    {
+        return session_->openChannel(channel, account, password);
+    }
+
+    void closeChannel(int avIndex) override { session_->closeChannel(avIndex); }
+
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) override
+    {
+        return session_->sendIOCtrl(avIndex, type, data);
+    }
+
+    int recvIOCtrl(int avIndex, uint32_t *type, ByteSpan buffer, int timeoutMs) override
+    {
+        return session_->recvIOCtrl(avIndex, type, buffer, timeoutMs);
+    }
+
+    int recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs) override
+    {
+        return session_->recvFrame(avIndex, buffer, info, timeoutMs);
+    }
+
+    PathType pathType() const override { return pathType_; }
+
+private:
+    std::shared_ptr<Session> session_;
+    PathType pathType_;
+};
+
+SimulatedDevice::SimulatedDevice(SimulatorConfig config)
+    : config_(std::move(config))
+    , quality_(size_t(std::max(config_.channels, 0)), AVIOCTRL_QUALITY_MAX)
+{
+}
+
+SimulatedDevice::~SimulatedDevice() = default;
+
+std::unique_ptr<Transport> SimulatedDevice::connect(const std::string &uid, int timeoutMs, int *error)
+{
+    uint64_t time = uint64_t(config_.connectTime) * 1000 + uint64_t(config_.delay) * 2000;
+    if (time > uint64_t(std::max(timeoutMs, 0)) * 1000) {
+        sleepMicros(uint64_t(std::max(timeoutMs, 0)) * 1000);
+        if (error) {
+            *error = kErrTimeout;
+        }
+        return nullptr;
+    }
+    sleepMicros(time);
+    if (uid != config_.uid) {
+        if (error) {
+            *error = kErrNotFound;
+        }
+        return nullptr;
+    }
+
+    uint64_t count = sessionCount_.fetch_add(1, std::memory_order_relaxed);
+    auto session = std::make_shared<Session>(*this, config_.seed + uint32_t(count));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.erase(std::remove_if(sessions_.begin(), sessions_.end(),
+                                       [](const std::weak_ptr<Session> &s) { return s.expired(); }),
+                        sessions_.end());
+        sessions_.push_back(session);
+    }
+    return std::unique_ptr<Transport>(new SessionTransport(std::move(session), config_.pathType));
+}
+
+void SimulatedDevice::reportEvent(uint32_t channel, uint32_t event)
+{
+    SMsgAVIoctrlEvent report{};
+    report.channel = channel;
+    report.event = event;
+    report.utcTime = uint32_t(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    auto bytes = SMsgAVIoctrlEventCodec::encode(report);
+    std::vector<uint8_t> data(bytes.begin(), bytes.end());
+
+    std::vector<std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &weak : sessions_) {
+            if (auto session = weak.lock()) {
+                sessions.push_back(std::move(session));
+            }
+        }
+    }
+    for (auto &session : sessions) {
+        session->reportEvent(channel, data);
+    }
+}
+
+uint8_t SimulatedDevice::quality(int channel) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel < 0 || size_t(channel) >= quality_.size()) {
+        return AVIOCTRL_QUALITY_UNKNOWN;
+    }
+    return quality_[size_t(channel)];
+}
+
+} // namespace cam
@@ -0,0 +1,146 @@
+//
+//  StreamDemand.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/StreamDemand.h"
+
+#include <algorithm>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlMessages.h"
+
+namespace cam {
+
+using namespace ioctrl;
+
+StreamDemand::Token &StreamDemand::Token::operator=(Token &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        demand_ = other.demand_;
+        kind_ = other.kind_;
+        other.demand_ = nullptr;
+    }
+    return *this;
+}
+
+void StreamDemand::Token::release()
+{
+    if (demand_) {
+        demand_->release(kind_);
+        demand_ = nullptr;
+    }
+}
+
+StreamDemand::StreamDemand(Transport &transport, int avIndex, int channel, int gracePeriodMs)
+    : transport_(transport), avIndex_(avIndex), channel_(channel), gracePeriod_(uint64_t(std::max(gracePeriodMs, 0)) * 1000)
+{
+    thread_ = std::thread(&StreamDemand::run, this);
+}
+
+StreamDemand::~StreamDemand()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        for (StreamKind kind : {StreamKind::Video, StreamKind::Audio}) {
+            if (streams_[size_t(kind)].streaming) {
+                send(kind, false);
+                streams_[size_t(kind)].streaming = false;
+            }
+        }
+    }
+    changed_.notify_all();
+    thread_.join();
+}
+
+int StreamDemand::acquire(StreamKind kind, Token &token)
+{
+    token.release();
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stream &stream = streams_[size_t(kind)];
+    if (!stream.streaming) {
+        int result = send(kind, true);
+        if (result < 0) {
+            return result;
+        }
+        stream.streaming = true;
+    }
+    stream.consumers++;
+    stream.stopAt = 0;
+    token = Token(this, kind);
+    return kNoError;
+}
+
+void StreamDemand::release(StreamKind kind)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stream &stream = streams_[size_t(kind)];
+        if (--stream.consumers > 0) {
+            return;
+        }
+        stream.stopAt = monotonicMicros() + gracePeriod_;
+    }
+    changed_.notify_all();
+}
+
+int StreamDemand::consumerCount(StreamKind kind) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_[size_t(kind)].consumers;
+}
+
+bool StreamDemand::isStreaming(StreamKind kind) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_[size_t(kind)].streaming;
+}
+
+int StreamDemand::send(StreamKind kind, bool start)
+{
+    SMsgAVIoctrlAVStream request{uint32_t(channel_)};
+    if (kind == StreamKind::Video) {
+        auto bytes = start ? StartStream::encodeRequest(request) : StopStream::encodeRequest(request);
+        return transport_.sendIOCtrl(avIndex_, start ? StartStream::requestType : StopStream::requestType,
+                                     ConstByteSpan{bytes.data(), bytes.size()});
+    }
+    auto bytes = start ? StartAudio::encodeRequest(request) : StopAudio::encodeRequest(request);
+    return transport_.sendIOCtrl(avIndex_, start ? StartAudio::requestType : StopAudio::requestType,
+                                 ConstByteSpan{bytes.data(), bytes.size()});
+}
+
+void StreamDemand::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        uint64_t next = UINT64_MAX;
+        uint64_t now = monotonicMicros();
+        for (StreamKind kind : {StreamKind::Video, StreamKind::Audio}) {
+            Stream &stream = streams_[size_t(kind)];
+            if (stream.stopAt == 0) {
+                continue;
+            }
+            if (stream.stopAt <= now) {
+                // A failed STOP is not retried, the camera ends the stream when the AV channel closes
+                send(kind, false);
+                stream.streaming = false;
+                stream.stopAt = 0;
+            } else {
+                next = std::min(next, stream.stopAt);
+            }
+        }
+        if (next == UINT64_MAX) {
+            changed_.wait(lock);
+        } else {
+            changed_.wait_for(lock, std::chrono::microseconds(next - now));
+        }
+    }
+}
+
+} // namespace cam
@@ -0,0 +1,75 @@
+//
+//  Thumbnails.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include "CameraCore/Thumbnails.h"
+
+#include <sys/types.h>
+
+#include <cstdio>
+
+#include "CameraCore/Error.h"
+
+namespace cam {
+
+std::vector<size_t> selectThumbnailKeyframes(const KeyframeIndex &index, size_t count)
+{
+    std::vector<size_t> selected;
+    for (size_t i = 0; i < count && !index.entries.empty(); i++) {
+        uint32_t time = uint32_t(uint64_t(index.duration) * i / count);
+        size_t entry = size_t(index.findAtOrBefore(time) - index.entries.data());
+        if (selected.empty() || selected.back() != entry) {
+            selected.push_back(entry);
+        }
+    }
+    return selected;
+}
+
+int generateThumbnails(const std::string &videoPath, const KeyframeIndex &index, size_t count, int maxWidth, int maxHeight,
+                       KeyframeDecoder &decoder, std::vector<Image> &thumbnails)
+{
+    thumbnails.clear();
+    std::vector<size_t> selected = selectThumbnailKeyframes(index, count);
+    if (selected.empty()) {
+        return kErrNotFound;
+    }
+    FILE *file = std::fopen(videoPath.c_str(), "rb");
+    if (!file) {
+        return kErrIO;
+    }
+
+    int ret = kNoError;
+    std::vector<uint8_t> record;
+    Image picture;
+    for (size_t i : selected) {
+        const KeyframeEntry &entry = index.entries[i];
+        record.resize(FrameRecordHeaderCodec::size + entry.size);
+        FrameRecordHeader header;
+        if (fseeko(file, off_t(entry.offset), SEEK_SET) != 0 ||
+            std::fread(record.data(), record.size(), 1, file) != 1 ||
+            !FrameRecordHeaderCodec::decode(ConstByteSpan{record.data(), record.size()}, header) ||
+            header.magic != kFrameRecordMagic || header.size != entry.size) {
+            ret = kErrIO;
+            break;
+        }
+        ret = decoder.decode(header.codecId, ConstByteSpan{record.data() + FrameRecordHeaderCodec::size, entry.size}, picture);
+        if (ret < 0) {
+            break;
+        }
+        int width, height;
+        fitSize(picture.width, picture.height, maxWidth, maxHeight, &width, &height);
+        thumbnails.emplace_back();
+        downscaleBox(picture, width, height, thumbnails.back());
+    }
+    std::fclose(file);
+    if (ret < 0) {
+        thumbnails.clear();
+    }
+    return ret;
+}
+
+} // namespace cam
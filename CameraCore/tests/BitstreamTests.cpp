@@ -0,0 +1,105 @@
+//
+//  BitstreamTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <vector>
+
+#include "CameraCore/Bitstream.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// Annex B frame of NAL units with the given first header bytes and a short body each
+std::vector<uint8_t> annexB(std::initializer_list<uint8_t> headers, bool longStartCode = false)
+{
+    std::vector<uint8_t> frame;
+    for (uint8_t header : headers) {
+        if (longStartCode) {
+            frame.push_back(0);
+        }
+        frame.insert(frame.end(), {0, 0, 1, header, 0x01, 0x88, 0x84, 0x21});
+    }
+    return frame;
+}
+
+/// A single temporal sub-layer for HEVC
+bool nonReference(uint16_t codecId, const std::vector<uint8_t> &frame, int hevcMaxTemporalId = 0)
+{
+    return isNonReferenceFrame(codecId, ConstByteSpan{frame.data(), frame.size()}, hevcMaxTemporalId);
+}
+
+/// HEVC NAL unit of a type and TemporalId, followed by one payload byte
+std::vector<uint8_t> hevcNal(unsigned type, unsigned temporalId, uint8_t payload = 0x88)
+{
+    return std::vector<uint8_t>{0, 0, 1, uint8_t(type << 1), uint8_t(temporalId + 1), payload, 0x84, 0x21};
+}
+
+void testH264()
+{
+    // IDR and P frame with nal_ref_idc 3 / 2, as SimulatedDevice sends them
+    CHECK(!nonReference(kCodecH264, annexB({0x65})));
+    CHECK(!nonReference(kCodecH264, annexB({0x41})));
+    // Non-reference B / P slice, with SEI and AUD in front
+    CHECK(nonReference(kCodecH264, annexB({0x01})));
+    CHECK(nonReference(kCodecH264, annexB({0x09, 0x06, 0x01, 0x01}, true)));
+    // One reference slice makes the frame a reference
+    CHECK(!nonReference(kCodecH264, annexB({0x01, 0x21})));
+    // Parameter sets only, or no start code
+    CHECK(!nonReference(kCodecH264, annexB({0x67, 0x68})));
+    CHECK(!nonReference(kCodecH264, std::vector<uint8_t>{0x01, 0x02, 0x03, 0x04}));
+    CHECK(!nonReference(kCodecH264, std::vector<uint8_t>{}));
+}
+
+void testHEVC()
+{
+    // The type is in bits 1..6 of the first header byte
+    auto hevc = [](unsigned type) { return uint8_t(type << 1); };
+    CHECK(nonReference(kCodecHEVC, annexB({hevc(0)})));       // TRAIL_N
+    CHECK(nonReference(kCodecHEVC, annexB({hevc(8)})));       // RASL_N
+    CHECK(!nonReference(kCodecHEVC, annexB({hevc(1)})));      // TRAIL_R
+    CHECK(!nonReference(kCodecHEVC, annexB({hevc(19)})));     // IDR_W_RADL
+    CHECK(nonReference(kCodecHEVC, annexB({hevc(35), hevc(39), hevc(2)})));    // AUD, SEI, TSA_N
+    CHECK(!nonReference(kCodecHEVC, annexB({hevc(32), hevc(33), hevc(34)})));  // VPS, SPS, PPS
+}
+
+void testTemporalLayers()
+{
+    // SPS of two sub-layers (sps_max_sub_layers_minus1 1) with an IDR, then slices of both sub-layers
+    std::vector<uint8_t> keyframe = hevcNal(33, 0, 0x03);
+    std::vector<uint8_t> idr = hevcNal(19, 0);
+    keyframe.insert(keyframe.end(), idr.begin(), idr.end());
+    CHECK_EQ(hevcMaxTemporalId(ConstByteSpan{keyframe.data(), keyframe.size()}), 1);
+    CHECK_EQ(hevcMaxTemporalId(ConstByteSpan{idr.data(), idr.size()}), -1);
+
+    // TRAIL_N of sub-layer 0 is referenced by sub-layer 1, only the top sub-layer is droppable
+    CHECK(!nonReference(kCodecHEVC, hevcNal(0, 0), 1));
+    CHECK(nonReference(kCodecHEVC, hevcNal(0, 1), 1));
+    CHECK(nonReference(kCodecHEVC, hevcNal(2, 1), 1));      // TSA_N
+    CHECK(!nonReference(kCodecHEVC, hevcNal(1, 1), 1));     // TRAIL_R
+    // Nothing is dropped before the SPS is known
+    CHECK(!nonReference(kCodecHEVC, hevcNal(0, 0), -1));
+    // H.264 does not depend on it
+    CHECK(nonReference(kCodecH264, annexB({0x01}), -1));
+}
+
+void testOtherCodecs()
+{
+    CHECK(!nonReference(0x8A, annexB({0x01})));
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testH264);
+    RUN_TEST(testHEVC);
+    RUN_TEST(testTemporalLayers);
+    RUN_TEST(testOtherCodecs);
+    return TEST_RESULT();
+}
@@ -0,0 +1,202 @@
+//
+//  ClockSyncTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/ClockSync.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/MeteredTransport.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// A camera clock 5 s ahead of the local clock at start, running 50 ppm fast
+struct DriftingClock
+{
+    uint64_t startUs = 1000000000;
+    double offsetUs = 5000000;
+    double driftPpm = 50;
+
+    double at(uint64_t localUs) const { return double(localUs) + offsetUs + driftPpm * 1e-6 * double(localUs - startUs); }
+};
+
+/// A time request with the given delay each way, the camera answers 1 ms after receiving it
+void request(ClockEstimator &estimator, const DriftingClock &clock, uint64_t sendUs, uint64_t upUs, uint64_t downUs,
+             uint64_t resolutionUs = 1000)
+{
+    CameraTime time;
+    time.resolutionUs = resolutionUs;
+    time.receiveUs = int64_t(clock.at(sendUs + upUs)) / int64_t(resolutionUs) * int64_t(resolutionUs);
+    time.sendUs = int64_t(clock.at(sendUs + upUs + 1000)) / int64_t(resolutionUs) * int64_t(resolutionUs);
+    estimator.addSample(sendUs, sendUs + upUs + 1000 + downUs, time);
+}
+
+void testOffsetAndDrift()
+{
+    DriftingClock clock;
+    ClockEstimator estimator(32);
+    CHECK(!estimator.estimate().valid);
+
+    // One request every 10 s for an hour, every fourth one waits in a queue on the way back
+    uint64_t now = clock.startUs;
+    for (int i = 0; i < 360; i++, now += 10000000) {
+        uint64_t delay = 10000 + uint64_t(i % 5) * 2000;
+        request(estimator, clock, now, delay, i % 4 == 3 ? delay + 400000 : delay);
+    }
+    ClockEstimate estimate = estimator.estimate();
+    CHECK(estimate.valid);
+    CHECK_EQ(estimate.sampleCount, 360);
+    CHECK(std::fabs(estimate.driftPpm - 50) < 1);
+    CHECK(estimate.roundTripMs >= 19 && estimate.roundTripMs < 21);
+    CHECK(estimate.accuracyMs >= 9.5 && estimate.accuracyMs < 11);
+    // The offset grew by 50 ppm of the hour, 180 ms
+    CHECK(std::fabs(estimate.offsetMs - (clock.at(estimate.referenceUs) - double(estimate.referenceUs)) / 1000) < 1);
+
+    // The line predicts the camera clock an hour on, within the accuracy
+    uint64_t later = now + 3600000000ull;
+    CHECK(std::fabs(double(estimate.toCameraMicros(later)) - clock.at(later)) < 10000);
+    uint64_t local = estimate.toLocalMicros(int64_t(clock.at(later)));
+    CHECK(std::fabs(double(local) - double(later)) < 10000);
+
+    estimator.reset();
+    CHECK(!estimator.estimate().valid);
+}
+
+void testWholeSeconds()
+{
+    DriftingClock clock;
+    clock.offsetUs = 5300000;
+    ClockEstimator estimator;
+    uint64_t now = clock.startUs;
+    for (int i = 0; i < 8; i++, now += 1000000) {
+        request(estimator, clock, now, 30000, 30000, 1000000);
+    }
+    // Eight seconds of a whole second clock tell nothing of the drift
+    ClockEstimate estimate = estimator.estimate();
+    CHECK_EQ(estimate.driftPpm, 0.0);
+    CHECK(estimate.accuracyMs >= 500);
+    double truth = (clock.at(estimate.referenceUs) - double(estimate.referenceUs)) / 1000;
+    CHECK(std::fabs(estimate.offsetMs - truth) <= estimate.accuracyMs);
+}
+
+class FakeClock : public CameraClock
+{
+public:
+    int read(CameraTime &time, int) override
+    {
+        if (reads++ == 1) {
+            return kErrTimeout;
+        }
+        time.receiveUs = time.sendUs = int64_t(monotonicMicros()) + 2000000;
+        time.resolutionUs = 1000;
+        return kNoError;
+    }
+
+    std::atomic<int> reads{0};
+};
+
+void testSampling()
+{
+    FakeClock clock;
+    ClockSyncConfig config;
+    config.initialSamples = 4;
+    config.initialIntervalMs = 10;
+    config.intervalMs = 60000;
+    ClockSync sync(clock, config);
+    for (int i = 0; i < 500 && sync.requestCount() < 4; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // The first samples are sent quickly, the next one waits for the interval
+    CHECK_EQ(sync.requestCount(), 4u);
+    CHECK_EQ(sync.failureCount(), 1u);
+    ClockEstimate estimate = sync.estimate();
+    CHECK(estimate.valid);
+    CHECK_EQ(estimate.sampleCount, 3);
+    CHECK(std::fabs(estimate.offsetMs - 2000) <= estimate.accuracyMs + 1);
+}
+
+/// Frames 30 ms old by the clock of FakeClock
+class AgedFrameTransport : public Transport
+{
+public:
+    int openChannel(int channel, const std::string &, const std::string &) override { return channel; }
+    void closeChannel(int) override {}
+    int sendIOCtrl(int, uint32_t, ConstByteSpan) override { return kNoError; }
+    int recvIOCtrl(int, uint32_t *, ByteSpan, int) override { return kErrTimeout; }
+    int recvFrame(int, ByteSpan, FrameInfo *info, int) override
+    {
+        info->timestamp = uint32_t((monotonicMicros() + 2000000) / 1000 - 30);
+        return 100;
+    }
+    PathType pathType() const override { return PathType::LAN; }
+};
+
+void testFrameLatency()
+{
+    // The 32 bit ms timestamp wrapped between the frame and now
+    ClockEstimate estimate;
+    estimate.valid = true;
+    estimate.referenceUs = 1000000;
+    estimate.offsetMs = double(uint64_t(1) << 32) + 10 - 1000;
+    CHECK_EQ(estimate.frameAgeMicros(uint32_t(-30), 1000500), 40500);
+
+    FakeClock clock;
+    ClockSyncConfig config;
+    config.initialIntervalMs = 10;
+    config.latencyAccuracyMs = 50;
+    SessionMetrics metrics;
+    MeteredTransport transport(std::unique_ptr<Transport>(new AgedFrameTransport), metrics);
+    int avIndex = transport.openChannel(0, "admin", "admin");
+    FrameInfo info;
+    uint8_t byte = 0;
+    {
+        ClockSync sync(clock, config);
+        transport.setClockSync(&sync);
+        for (int i = 0; i < 500 && !sync.estimate().valid; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        for (int i = 0; i < 10; i++) {
+            transport.recvFrame(avIndex, ByteSpan{&byte, 1}, &info, 100);
+        }
+        transport.setClockSync(nullptr);
+    }
+    HistogramSnapshot latency = metrics.snapshot().frameLatency;
+    CHECK_EQ(latency.count, 10u);
+    CHECK(latency.min >= 29 && latency.max <= 35);
+
+    // A clock that is not accurate enough measures nothing
+    config.latencyAccuracyMs = 0.1;
+    ClockSync coarse(clock, config);
+    for (int i = 0; i < 500 && !coarse.estimate().valid; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    uint64_t micros = 0;
+    CHECK(!coarse.frameLatency(info.timestamp, monotonicMicros(), &micros));
+    transport.setClockSync(&coarse);
+    transport.recvFrame(avIndex, ByteSpan{&byte, 1}, &info, 100);
+    transport.setClockSync(nullptr);
+    CHECK_EQ(metrics.snapshot().frameLatency.count, 10u);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testOffsetAndDrift);
+    RUN_TEST(testWholeSeconds);
+    RUN_TEST(testSampling);
+    RUN_TEST(testFrameLatency);
+    return TEST_RESULT();
+}
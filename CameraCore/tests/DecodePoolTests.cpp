@@ -0,0 +1,359 @@
+//
+//  DecodePoolTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Bitstream.h"
+#include "CameraCore/DecodePool.h"
+#include "CameraCore/Error.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// Blocks decode calls until opened
+class Gate
+{
+public:
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiting_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [this] { return open_; });
+    }
+
+    void waitUntilBlocked()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return waiting_; });
+    }
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        changed_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool waiting_ = false;
+    bool open_ = false;
+};
+
+/// Decodes every frame to a gray 64 x 36 picture of the first payload byte, and logs the frames
+class FakeDecoder : public VideoDecoder
+{
+public:
+    FakeDecoder(int stream, std::vector<int> *log = nullptr, std::mutex *logMutex = nullptr, Gate *gate = nullptr)
+        : stream_(stream), log_(log), logMutex_(logMutex), gate_(gate), y_(64 * 36), uv_(64 * 18, 128)
+    {
+    }
+
+    int decode(uint16_t, ConstByteSpan frame, Nv12Picture &picture) override
+    {
+        CHECK(!busy_.exchange(true));
+        if (gate_) {
+            gate_->wait();
+        }
+        if (log_) {
+            std::lock_guard<std::mutex> lock(*logMutex_);
+            log_->push_back(stream_);
+        }
+        if (frame.size > 5 && frame.data[4] == 0xFF) {
+            busy_ = false;
+            return kErrInvalidArg;
+        }
+        std::fill(y_.begin(), y_.end(), frame.data[frame.size - 1]);
+        picture = Nv12Picture{64, 36, y_.data(), 64, uv_.data(), 64, true};
+        busy_ = false;
+        return kNoError;
+    }
+
+private:
+    int stream_;
+    std::vector<int> *log_;
+    std::mutex *logMutex_;
+    Gate *gate_;
+    std::vector<uint8_t> y_;
+    std::vector<uint8_t> uv_;
+    std::atomic<bool> busy_{false};
+};
+
+/// An H.264 frame: IDR, reference P frame or non-reference frame, the last byte is the picture value
+std::vector<uint8_t> h264Frame(uint8_t nalHeader, uint8_t value)
+{
+    return std::vector<uint8_t>{0, 0, 0, 1, nalHeader, 0x88, value};
+}
+
+FrameInfo frameInfo(uint32_t frameNumber, bool keyframe)
+{
+    FrameInfo info;
+    info.codecId = kCodecH264;
+    info.flags = keyframe ? kFrameFlagKeyframe : 0;
+    info.frameNumber = frameNumber;
+    return info;
+}
+
+int submit(DecodePool &pool, int session, uint32_t frameNumber, uint8_t nalHeader = 0x41)
+{
+    std::vector<uint8_t> frame = h264Frame(nalHeader, uint8_t(frameNumber));
+    return pool.submit(session, frameInfo(frameNumber, nalHeader == 0x65), ConstByteSpan{frame.data(), frame.size()});
+}
+
+void testOrderPerSession()
+{
+    DecodePoolConfig config;
+    config.threads = 4;
+    config.maxQueuedPerSession = 1000;
+    const int sessions = 12;
+    const uint32_t frames = 100;
+    // Hubs outlive the pool sessions
+    std::vector<std::unique_ptr<FrameHub>> hubs;
+    std::vector<std::shared_ptr<FrameSubscription>> subscriptions;
+    DecodePool pool(config);
+    CHECK_EQ(pool.threadCount(), 4u);
+    std::vector<int> ids;
+    for (int i = 0; i < sessions; i++) {
+        hubs.push_back(std::make_unique<FrameHub>());
+        subscriptions.push_back(hubs.back()->subscribe(SubscriptionConfig{frames, DropPolicy::Newest}));
+        ids.push_back(pool.addSession(i, *hubs.back(), std::make_unique<FakeDecoder>(i), StreamPriority(i % 3)));
+    }
+    // Frames of all sessions interleaved from several receive threads
+    std::vector<std::thread> receivers;
+    for (int r = 0; r < 3; r++) {
+        receivers.emplace_back([&, r] {
+            for (uint32_t n = 0; n < frames; n++) {
+                for (int i = r; i < sessions; i += 3) {
+                    CHECK_EQ(submit(pool, ids[size_t(i)], n, n == 0 ? 0x65 : 0x41), kNoError);
+                }
+            }
+        });
+    }
+    for (auto &receiver : receivers) {
+        receiver.join();
+    }
+
+    for (int i = 0; i < sessions; i++) {
+        for (uint32_t n = 0; n < frames; n++) {
+            FramePtr frame = subscriptions[size_t(i)]->next(5000);
+            CHECK(frame && frame->info.frameNumber == n && frame->avIndex == i);
+            CHECK(frame && frame->picture && frame->picture->width == 64 && frame->picture->rgba[0] == uint8_t(n));
+        }
+        DecodeSessionStats stats;
+        CHECK_EQ(pool.sessionStats(ids[size_t(i)], stats), kNoError);
+        CHECK_EQ(stats.framesDecoded, frames);
+        CHECK_EQ(stats.decodeTime.count, frames);
+        CHECK_EQ(stats.queued, 0u);
+    }
+    CHECK_EQ(pool.queueDepth(), 0u);
+}
+
+void testPriority()
+{
+    DecodePoolConfig config;
+    config.threads = 1;
+    std::vector<int> log;
+    std::mutex logMutex;
+    Gate gate;
+    FrameHub blockerHub, backgroundHub, focusedHub, visibleHub;
+    DecodePool pool(config);
+    int blocker = pool.addSession(0, blockerHub, std::make_unique<FakeDecoder>(0, nullptr, nullptr, &gate));
+    int background = pool.addSession(1, backgroundHub, std::make_unique<FakeDecoder>(1, &log, &logMutex), StreamPriority::Background);
+    int visible = pool.addSession(2, visibleHub, std::make_unique<FakeDecoder>(2, &log, &logMutex), StreamPriority::Visible);
+    int focused = pool.addSession(3, focusedHub, std::make_unique<FakeDecoder>(3, &log, &logMutex), StreamPriority::Background);
+    pool.setPriority(focused, StreamPriority::Focused);
+
+    // The only thread is busy, the frames queue up
+    submit(pool, blocker, 0, 0x65);
+    gate.waitUntilBlocked();
+    for (uint32_t n = 0; n < 5; n++) {
+        submit(pool, background, n, n == 0 ? 0x65 : 0x41);
+        submit(pool, visible, n, n == 0 ? 0x65 : 0x41);
+        submit(pool, focused, n, n == 0 ? 0x65 : 0x41);
+    }
+    CHECK_EQ(pool.queueDepth(), 15u);
+    gate.open();
+    pool.removeSession(background);     // Waits only for a frame being decoded
+    pool.removeSession(blocker);
+
+    // Focused first, then visible, the background frames were dropped by removeSession or decoded last
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::lock_guard<std::mutex> lock(logMutex);
+    CHECK(log.size() >= 10);
+    for (size_t i = 0; i < log.size(); i++) {
+        CHECK_EQ(log[i], i < 5 ? 3 : i < 10 ? 2 : 1);
+    }
+}
+
+void testSkipping()
+{
+    DecodePoolConfig config;
+    config.threads = 2;
+    FrameHub tileHub, liveHub;
+    DecodePool pool(config);
+
+    // A small tile skips non-reference frames
+    auto tile = tileHub.subscribe(SubscriptionConfig{16, DropPolicy::Oldest});
+    int session = pool.addSession(0, tileHub, std::make_unique<FakeDecoder>(0));
+    pool.setOutputSize(session, OutputSize{16, 16, 320});
+    submit(pool, session, 0, 0x65);
+    submit(pool, session, 1, 0x01);
+    submit(pool, session, 2, 0x41);
+    submit(pool, session, 3, 0x01);
+    CHECK_EQ(tile->next(1000)->picture->width, 16);
+    CHECK_EQ(tile->next(1000)->info.frameNumber, 2u);
+    CHECK(tile->next(50) == nullptr);
+    DecodeSessionStats stats;
+    pool.sessionStats(session, stats);
+    CHECK_EQ(stats.framesSkipped, 2u);
+    CHECK_EQ(stats.framesDecoded, 2u);
+
+    // A consumer that is behind skips them too, reference frames are still decoded
+    stats = DecodeSessionStats();
+    auto live = liveHub.subscribe(SubscriptionConfig{1, DropPolicy::Latest});
+    session = pool.addSession(1, liveHub, std::make_unique<FakeDecoder>(1));
+    submit(pool, session, 0, 0x65);
+    while (live->queued() == 0) {
+        std::this_thread::yield();
+    }
+    submit(pool, session, 1, 0x01);
+    submit(pool, session, 2, 0x41);
+    // The stats are counted before the publish, frame 2 replaces frame 0 when it is published
+    for (int i = 0; i < 5000 && (stats.framesDecoded + stats.framesSkipped < 3 || live->framesDropped() == 0); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pool.sessionStats(session, stats);
+    }
+    CHECK_EQ(stats.framesSkipped, 1u);
+    CHECK_EQ(live->next(1000)->info.frameNumber, 2u);
+    CHECK_EQ(live->framesDropped(), 1u);
+
+    // Decoder errors are counted and nothing is published
+    std::vector<uint8_t> broken{0, 0, 0, 1, 0xFF, 0x00, 0x00};
+    pool.submit(session, frameInfo(3, false), ConstByteSpan{broken.data(), broken.size()});
+    for (int i = 0; i < 5000 && stats.framesFailed == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        pool.sessionStats(session, stats);
+    }
+    CHECK_EQ(stats.framesFailed, 1u);
+    CHECK(live->next(50) == nullptr);
+}
+
+void testQueueLimit()
+{
+    DecodePoolConfig config;
+    config.threads = 1;
+    config.maxQueuedPerSession = 3;
+    Gate gate;
+    FrameHub blockerHub, hub;
+    DecodePool pool(config);
+    auto subscription = hub.subscribe(SubscriptionConfig{16, DropPolicy::Oldest});
+    int blocker = pool.addSession(0, blockerHub, std::make_unique<FakeDecoder>(0, nullptr, nullptr, &gate));
+    int session = pool.addSession(1, hub, std::make_unique<FakeDecoder>(1));
+    submit(pool, blocker, 0, 0x65);
+    gate.waitUntilBlocked();
+
+    CHECK_EQ(submit(pool, session, 0, 0x65), kNoError);
+    CHECK_EQ(submit(pool, session, 1), kNoError);
+    CHECK_EQ(submit(pool, session, 2), kNoError);
+    // The full queue is dropped, frames are refused up to the next keyframe
+    CHECK_EQ(submit(pool, session, 3), kErrMemoryBudget);
+    CHECK_EQ(submit(pool, session, 4), kErrMemoryBudget);
+    CHECK_EQ(submit(pool, session, 5, 0x65), kNoError);
+    CHECK_EQ(submit(pool, session, 6), kNoError);
+    CHECK_EQ(pool.queueDepth(), 2u);
+    gate.open();
+
+    CHECK_EQ(subscription->next(1000)->info.frameNumber, 5u);
+    CHECK_EQ(subscription->next(1000)->info.frameNumber, 6u);
+    DecodeSessionStats stats;
+    pool.sessionStats(session, stats);
+    CHECK_EQ(stats.framesDropped, 5u);
+    CHECK_EQ(pool.submit(99, frameInfo(0, true), ConstByteSpan{nullptr, 0}), kErrNotFound);
+}
+
+void testMemoryBudget()
+{
+    DecodePoolConfig config;
+    config.threads = 1;
+    Gate gate;
+    FrameHub blockerHub, hub;
+    auto memory = std::make_shared<SessionMemory>(4096, 1024);
+    std::weak_ptr<SessionMemory> weak = memory;
+    {
+        DecodePool pool(config);
+        auto subscription = hub.subscribe(SubscriptionConfig{16, DropPolicy::Oldest});
+        int blocker = pool.addSession(0, blockerHub, std::make_unique<FakeDecoder>(0, nullptr, nullptr, &gate));
+        int session = pool.addSession(1, hub, std::make_unique<FakeDecoder>(1), StreamPriority::Visible, nullptr, memory);
+        submit(pool, blocker, 0, 0x65);
+        gate.waitUntilBlocked();
+
+        // Frames queue until the budget is reached, then the queue is dropped up to the next keyframe
+        CHECK_EQ(submit(pool, session, 0, 0x65), kNoError);
+        uint32_t queued = 1;
+        while (queued < 100 && submit(pool, session, queued) == kNoError) {
+            queued++;
+        }
+        CHECK(queued > 2 && queued < 100);
+        CHECK(memory->stats().refused > 0);
+        CHECK(memory->stats().reserved <= 4096u);
+        CHECK_EQ(pool.queueDepth(), 0u);
+        CHECK_EQ(submit(pool, session, queued + 1), kErrMemoryBudget);
+        CHECK_EQ(submit(pool, session, queued + 2, 0x65), kNoError);
+        gate.open();
+
+        CHECK_EQ(subscription->next(1000)->info.frameNumber, queued + 2);
+        DecodeSessionStats stats;
+        pool.sessionStats(session, stats);
+        CHECK_EQ(stats.framesDropped, uint64_t(queued + 2));
+        pool.removeSession(session);
+        hub.unsubscribe(subscription);
+    }
+    // No frame holds the memory any more, it goes in one step with the session
+    CHECK_EQ(memory->stats().used, 0u);
+    memory.reset();
+    CHECK(weak.expired());
+}
+
+void testPictureReuse()
+{
+    DecodePoolConfig config;
+    config.threads = 1;
+    FrameHub hub;
+    DecodePool pool(config);
+    auto subscription = hub.subscribe(SubscriptionConfig{1, DropPolicy::Latest});
+    int session = pool.addSession(0, hub, std::make_unique<FakeDecoder>(0));
+    submit(pool, session, 0, 0x65);
+    const Image *first = subscription->next(1000)->picture.get();
+    // The first picture was released by the consumer and is converted into again
+    submit(pool, session, 1);
+    FramePtr second = subscription->next(1000);
+    CHECK(second->picture.get() == first);
+    submit(pool, session, 2);
+    CHECK(subscription->next(1000)->picture.get() != first);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testOrderPerSession);
+    RUN_TEST(testPriority);
+    RUN_TEST(testSkipping);
+    RUN_TEST(testQueueLimit);
+    RUN_TEST(testMemoryBudget);
+    RUN_TEST(testPictureReuse);
+    return TEST_RESULT();
+}
@@ -0,0 +1,297 @@
+//
+//  DeviceMessagesTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/DeviceMessages.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/SimulatedDevice.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+constexpr uint32_t kFotaReq = 0x7101;
+constexpr uint32_t kFotaResp = 0x7102;
+constexpr uint32_t kPlaybackEndReq = 0x7103;
+constexpr uint32_t kPlaybackEndResp = 0x7104;
+constexpr uint32_t kSensorReq = 0x7105;
+constexpr uint32_t kSensorResp = 0x7106;
+
+/// Firmware without pushes, answers the polls like the vendor commands
+class PollingTransport : public Transport
+{
+public:
+    int openChannel(int, const std::string &, const std::string &) override { return 0; }
+    void closeChannel(int) override {}
+
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) override
+    {
+        CHECK_EQ(avIndex, 4);
+        SMsgAVIoctrlAVStream request;
+        CHECK(SMsgAVIoctrlAVStreamCodec::decode(data, request) && request.channel == 1u);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (type == kFotaReq) {
+            SMsgFOTAResult result = fotaScript.empty() ? SMsgFOTAResult{0, 0} : fotaScript.front();
+            if (fotaScript.size() > 1) {
+                fotaScript.pop_front();
+            }
+            queue(kFotaResp, SMsgFOTAResultCodec::encode(result));
+        } else if (type == kPlaybackEndReq) {
+            queue(kPlaybackEndResp, SMsgAVIoctrlResultCodec::encode(SMsgAVIoctrlResult{playbackEnded.load()}));
+        } else if (type == kSensorReq) {
+            queue(kSensorResp, SMsgSensorDetailCodec::encode(SMsgSensorDetail{0, 0, 0, 10, 20, 30}));
+        }
+        return kNoError;
+    }
+
+    int recvIOCtrl(int, uint32_t *type, ByteSpan buffer, int timeoutMs) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!changed_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return !messages_.empty(); })) {
+            return kErrTimeout;
+        }
+        auto message = std::move(messages_.front());
+        messages_.pop_front();
+        *type = message.first;
+        std::memcpy(buffer.data, message.second.data(), message.second.size());
+        return int(message.second.size());
+    }
+
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return kErrTimeout; }
+    PathType pathType() const override { return PathType::LAN; }
+
+    template <typename Bytes>
+    void push(uint32_t type, const Bytes &bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue(type, bytes);
+    }
+
+    std::deque<SMsgFOTAResult> fotaScript;
+    std::atomic<int32_t> playbackEnded{0};
+
+private:
+    template <typename Bytes>
+    void queue(uint32_t type, const Bytes &bytes)
+    {
+        messages_.push_back({type, std::vector<uint8_t>(bytes.begin(), bytes.end())});
+        changed_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::pair<uint32_t, std::vector<uint8_t>>> messages_;
+};
+
+DeviceMessageConfig pollingConfig()
+{
+    DeviceMessageConfig config;
+    config.channel = 1;
+    config.fotaRequestType = kFotaReq;
+    config.fotaResponseType = kFotaResp;
+    config.playbackEndRequestType = kPlaybackEndReq;
+    config.playbackEndResponseType = kPlaybackEndResp;
+    config.sensorRequestType = kSensorReq;
+    config.sensorResponseType = kSensorResp;
+    config.activeIntervalMs = 20;
+    config.idleIntervalMs = 5000;
+    return config;
+}
+
+/// Wait until the condition holds, at most 5 s
+template <typename Condition>
+bool waitFor(Condition condition)
+{
+    for (int i = 0; i < 500 && !condition(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+void testAdaptivePolling()
+{
+    PollingTransport transport;
+    // Downloading for three polls, then no newer firmware
+    transport.fotaScript = {{2, 10}, {2, 50}, {2, 90}, {0, 0}};
+
+    std::mutex mutex;
+    std::vector<int32_t> progress;
+    int sensorDetails = 0;
+    int playbackEnds = 0;
+    DeviceMessageHandlers handlers;
+    handlers.fota = [&](const SMsgFOTAResult &result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.push_back(result.reserved);
+    };
+    handlers.sensorDetail = [&](const SMsgSensorDetail &detail) {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK_EQ(detail.pirValue, 20);
+        sensorDetails++;
+    };
+    handlers.playbackEnd = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        playbackEnds++;
+    };
+    IoctrlChannel control(transport, 4);
+    DeviceMessages messages(control, pollingConfig(), handlers);
+
+    // Polled at the active interval while downloading, idle once it is done
+    CHECK(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return progress.size() >= 4;
+    }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK((std::vector<int32_t>(progress.begin(), progress.begin() + 4) == std::vector<int32_t>{10, 50, 90, 0}));
+        CHECK_EQ(sensorDetails, 1);
+    }
+    uint64_t fotaPolls = messages.pollCount(DeviceMessage::Fota);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    // One more poll at the active interval may have been planned before the download was done
+    CHECK(messages.pollCount(DeviceMessage::Fota) <= fotaPolls + 1);
+    CHECK_EQ(messages.pollCount(DeviceMessage::PlaybackEnd), 1u);
+    CHECK_EQ(messages.pollCount(DeviceMessage::Sensor), 1u);
+
+    // A playback polls for its end at the active interval until it ends
+    messages.setActive(DeviceMessage::PlaybackEnd, true);
+    CHECK(waitFor([&] { return messages.pollCount(DeviceMessage::PlaybackEnd) >= 4; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK_EQ(playbackEnds, 0);
+    }
+    transport.playbackEnded = 1;
+    CHECK(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return playbackEnds == 1;
+    }));
+    uint64_t playbackPolls = messages.pollCount(DeviceMessage::PlaybackEnd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    CHECK(messages.pollCount(DeviceMessage::PlaybackEnd) <= playbackPolls + 1);
+
+    for (size_t i = 0; i < kDeviceMessageCount; i++) {
+        CHECK(!messages.pushSupported(DeviceMessage(i)));
+    }
+    CHECK_EQ(messages.error(), kNoError);
+}
+
+void testPushStopsPolling()
+{
+    PollingTransport transport;
+    DeviceMessageConfig config = pollingConfig();
+    config.idleIntervalMs = 20;
+    std::mutex mutex;
+    std::vector<int32_t> results;
+    int playbackEnds = 0;
+    DeviceMessageHandlers handlers;
+    handlers.fota = [&](const SMsgFOTAResult &result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(result.result);
+    };
+    handlers.playbackEnd = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        playbackEnds++;
+    };
+    IoctrlChannel control(transport, 4);
+    DeviceMessages messages(control, config, handlers);
+    CHECK(waitFor([&] { return messages.pollCount(DeviceMessage::Fota) >= 3; }));
+    CHECK(!messages.pushSupported(DeviceMessage::Fota));
+
+    // Progress the camera sends by itself, and the end of a playback
+    transport.push(kFotaResp, SMsgFOTAResultCodec::encode(SMsgFOTAResult{4, 30}));
+    transport.push(PlayRecord::responseType,
+                   SMsgAVIoctrlPlayRecordRespCodec::encode(SMsgAVIoctrlPlayRecordResp{AVIOCTRL_RECORD_PLAY_END, 0}));
+    CHECK(waitFor([&] { return messages.pushSupported(DeviceMessage::Fota); }));
+    CHECK(waitFor([&] { return messages.pushSupported(DeviceMessage::PlaybackEnd); }));
+    uint64_t fotaPolls = messages.pollCount(DeviceMessage::Fota);
+    uint64_t playbackPolls = messages.pollCount(DeviceMessage::PlaybackEnd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK_EQ(messages.pollCount(DeviceMessage::Fota), fotaPolls);
+    CHECK_EQ(messages.pollCount(DeviceMessage::PlaybackEnd), playbackPolls);
+    // The sensor state is still polled, also after an event report
+    transport.push(IOTYPE_USER_IPCAM_EVENT_REPORT, SMsgAVIoctrlEventCodec::encode(SMsgAVIoctrlEvent{{}, 0, 1, 2}));
+    uint64_t sensorPolls = messages.pollCount(DeviceMessage::Sensor);
+    CHECK(waitFor([&] { return messages.pollCount(DeviceMessage::Sensor) >= sensorPolls + 3; }));
+    CHECK(!messages.pushSupported(DeviceMessage::Sensor));
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(std::find(results.begin(), results.end(), 4) != results.end());
+    CHECK_EQ(playbackEnds, 1);
+}
+
+void testSimulatorEvents()
+{
+    SimulatorConfig simulatorConfig;
+    simulatorConfig.delay = 5;
+    SimulatedDevice device(simulatorConfig);
+    int error = 0;
+    auto transport = device.connect(simulatorConfig.uid, 1000, &error);
+    CHECK(transport != nullptr);
+    int avIndex = transport->openChannel(0, simulatorConfig.account, simulatorConfig.password);
+    CHECK(avIndex >= 0);
+
+    std::mutex mutex;
+    std::vector<uint32_t> events;
+    std::vector<uint32_t> others;
+    DeviceMessageHandlers handlers;
+    handlers.event = [&](const SMsgAVIoctrlEvent &event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(event.event);
+    };
+    handlers.other = [&](uint32_t type, ConstByteSpan) {
+        std::lock_guard<std::mutex> lock(mutex);
+        others.push_back(type);
+    };
+    // The simulator has no vendor commands, nothing is polled
+    IoctrlChannel control(*transport, avIndex);
+    DeviceMessages messages(control, DeviceMessageConfig{}, handlers);
+    // A command waiting for its reply gets it too
+    IoctrlQueue replies(control, {GetStreamCtrl::responseType});
+
+    device.reportEvent(0, 2);
+    device.reportEvent(0, 4);
+    auto request = GetStreamCtrl::encodeRequest(SMsgAVIoctrlAVStream{0});
+    CHECK_EQ(transport->sendIOCtrl(avIndex, GetStreamCtrl::requestType, ConstByteSpan{request.data(), request.size()}), kNoError);
+    CHECK(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.size() == 2 && others.size() == 1;
+    }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK((events == std::vector<uint32_t>{2, 4}));
+        CHECK_EQ(others[0], uint32_t(GetStreamCtrl::responseType));
+    }
+    uint32_t type = 0;
+    uint8_t reply[kMaxIoctrlSize];
+    CHECK(replies.recv(&type, ByteSpan{reply, sizeof(reply)}, 1000) > 0);
+    CHECK_EQ(type, uint32_t(GetStreamCtrl::responseType));
+    CHECK(!messages.pushSupported(DeviceMessage::Sensor));
+    CHECK_EQ(messages.pollCount(DeviceMessage::Sensor), 0u);
+
+    // The listener stops when the AV channel is closed
+    transport->closeChannel(avIndex);
+    CHECK(waitFor([&] { return messages.error() == kErrClosed; }));
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testAdaptivePolling);
+    RUN_TEST(testPushStopsPolling);
+    RUN_TEST(testSimulatorEvents);
+    return TEST_RESULT();
+}
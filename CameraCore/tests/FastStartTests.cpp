@@ -0,0 +1,123 @@
+//
+//  FastStartTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <atomic>
+#include <thread>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/FastStart.h"
+#include "CameraCore/SimulatedDevice.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// Vendor IO control of the simulated firmware
+constexpr uint32_t kKeyframeRequest = 0x7F01;
+
+/// 50 fps, the first keyframe 800 ms after the start
+SimulatorConfig midGopConfig()
+{
+    SimulatorConfig config;
+    config.fps = 50;
+    config.gop = 50;
+    config.firstKeyframe = 40;
+    config.keyframeSize = 2000;
+    config.frameSize = 200;
+    config.keyframeRequestType = kKeyframeRequest;
+    return config;
+}
+
+void testNextGop()
+{
+    SimulatedDevice device(midGopConfig());
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(device.config().uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+    CHECK(avIndex >= 0);
+
+    // Without a keyframe request the start waits for the GOP boundary
+    FastStartConfig config;
+    FastStartResult result;
+    CHECK_EQ(fastStart(*transport, avIndex, config, &result), kNoError);
+    CHECK(result.keyframe != nullptr && result.keyframe->info.isKeyframe());
+    CHECK_EQ(result.keyframe->info.frameNumber, 40u);
+    CHECK_EQ(result.skippedFrames, 40u);
+    CHECK(result.timeToFirstFrameUs >= 700000);
+}
+
+void testKeyframeRequest()
+{
+    SimulatedDevice device(midGopConfig());
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(device.config().uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+    FrameHub hub;
+    auto subscription = hub.subscribe(SubscriptionConfig{8, DropPolicy::Oldest});
+    ChannelMetrics metrics(avIndex);
+
+    std::atomic<bool> setupRan{false};
+    FastStartConfig config;
+    config.withAudio = true;
+    config.keyframeRequestType = kKeyframeRequest;
+    config.setup = [&] {
+        setupRan = true;
+        return 7;
+    };
+    config.hub = &hub;
+    config.metrics = &metrics;
+    FastStartResult result;
+    CHECK_EQ(fastStart(*transport, avIndex, config, &result), kNoError);
+    CHECK(setupRan);
+    CHECK_EQ(result.setupError, 7);
+    CHECK_EQ(result.audioError, kNoError);
+    CHECK(result.skippedFrames <= 2);
+    CHECK(result.timeToFirstFrameUs < 300000);
+
+    // The consumer has the keyframe without any decode or queueing in between
+    FramePtr frame = subscription->next(0);
+    CHECK(frame == result.keyframe);
+    CHECK(frame->info.isKeyframe());
+    ChannelSnapshot snapshot = metrics.snapshot();
+    CHECK_EQ(snapshot.firstKeyframeLatency.count, 1u);
+
+    // The stream goes on with the P frames of the new GOP
+    FrameInfo info;
+    uint8_t buffer[4096];
+    CHECK(transport->recvFrame(avIndex, ByteSpan{buffer, sizeof(buffer)}, &info, 1000) > 0);
+    CHECK(!info.isKeyframe());
+    CHECK_EQ(info.frameNumber, frame->info.frameNumber + 1);
+}
+
+void testTimeout()
+{
+    SimulatorConfig simulatorConfig = midGopConfig();
+    simulatorConfig.firstKeyframe = 1000;
+    SimulatedDevice device(simulatorConfig);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(device.config().uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+
+    FastStartConfig config;
+    config.timeoutMs = 200;
+    FastStartResult result;
+    CHECK_EQ(fastStart(*transport, avIndex, config, &result), kErrTimeout);
+    CHECK(result.keyframe == nullptr);
+    CHECK(result.skippedFrames > 0);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testNextGop);
+    RUN_TEST(testKeyframeRequest);
+    RUN_TEST(testTimeout);
+    return TEST_RESULT();
+}
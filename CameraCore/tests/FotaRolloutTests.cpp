@@ -0,0 +1,331 @@
+//
+//  FotaRolloutTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/FotaRollout.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+enum class Firmware { Updates, Latest, DownloadFails, Stuck };
+
+/// A camera, its FOTA result moves one step on every getFOTAResult
+struct Camera
+{
+    Firmware firmware = Firmware::Updates;
+    std::string password = "admin";
+    std::vector<SMsgFOTAResult> script;     // Results after the last command
+    size_t position = 0;
+    bool rebooting = false;
+    int refusedConnects = 0;                // Connects refused while it reboots
+    bool installed = false;
+};
+
+class Fleet;
+
+class CameraTransport : public Transport
+{
+public:
+    CameraTransport(Fleet &fleet, std::string uid) : fleet_(fleet), uid_(std::move(uid)) {}
+
+    int openChannel(int channel, const std::string &account, const std::string &password) override;
+    void closeChannel(int) override {}
+    int sendIOCtrl(int, uint32_t, ConstByteSpan) override { return kNoError; }
+    int recvIOCtrl(int, uint32_t *, ByteSpan, int) override { return kErrTimeout; }
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return kErrTimeout; }
+    PathType pathType() const override { return PathType::P2P; }
+
+    const std::string &uid() const { return uid_; }
+
+private:
+    Fleet &fleet_;
+    std::string uid_;
+};
+
+/// The cameras, their connector and their FOTA commands
+class Fleet : public Connector, public FotaCommands
+{
+public:
+    std::map<std::string, Camera> cameras;
+
+    std::unique_ptr<Transport> connect(const std::string &uid, int, int *error) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cameras.find(uid);
+        if (it == cameras.end()) {
+            *error = kErrNotFound;
+            return nullptr;
+        }
+        Camera &camera = it->second;
+        if (camera.rebooting && camera.refusedConnects-- > 0) {
+            *error = kErrTimeout;
+            return nullptr;
+        }
+        if (camera.rebooting) {
+            // Back with the new firmware
+            camera.rebooting = false;
+            camera.installed = true;
+            camera.script = {{5, 0}};
+            camera.position = 0;
+        }
+        return std::make_unique<CameraTransport>(*this, uid);
+    }
+
+    int openChannel(const std::string &uid, const std::string &account, const std::string &password)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Camera &camera = cameras.at(uid);
+        return account == "admin" && password == camera.password ? 0 : kErrRejected;
+    }
+
+    int checkVersion(Transport &transport, int) override
+    {
+        return command(transport, [](Camera &camera) {
+            if (camera.firmware == Firmware::Latest) {
+                return std::vector<SMsgFOTAResult>{{-1, 0}, {0, 0}};
+            }
+            return std::vector<SMsgFOTAResult>{{-1, 0}, {-1, 0}, {1, 200}};
+        });
+    }
+
+    int download(Transport &transport, int) override
+    {
+        return command(transport, [](Camera &camera) {
+            switch (camera.firmware) {
+            case Firmware::DownloadFails:
+                return std::vector<SMsgFOTAResult>{{2, 0}, {2, 40}, {-3, 0}};
+            case Firmware::Stuck:
+                return std::vector<SMsgFOTAResult>{{2, 10}};
+            default:
+                return std::vector<SMsgFOTAResult>{{2, 0}, {2, 50}, {2, 100}, {3, 0}, {3, 1}, {3, 2}};
+            }
+        });
+    }
+
+    int install(Transport &transport, int) override
+    {
+        return command(transport, [](Camera &) { return std::vector<SMsgFOTAResult>{{4, 0}, {4, 60}}; });
+    }
+
+    int result(Transport &transport, int, SMsgFOTAResult &result, int) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Camera &camera = cameras.at(static_cast<CameraTransport &>(transport).uid());
+        if (camera.rebooting) {
+            return kErrClosed;
+        }
+        if (camera.script.empty()) {
+            result = SMsgFOTAResult{0, 0};
+            return kNoError;
+        }
+        result = camera.script[std::min(camera.position, camera.script.size() - 1)];
+        camera.position++;
+        // The camera reboots after the upgrade progress
+        if (result.result == 4 && camera.position >= camera.script.size()) {
+            camera.rebooting = true;
+            camera.refusedConnects = 2;
+        }
+        return kNoError;
+    }
+
+private:
+    template <typename Script>
+    int command(Transport &transport, Script script)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Camera &camera = cameras.at(static_cast<CameraTransport &>(transport).uid());
+        camera.script = script(camera);
+        camera.position = 0;
+        return kNoError;
+    }
+
+    std::mutex mutex_;
+};
+
+int CameraTransport::openChannel(int, const std::string &account, const std::string &password)
+{
+    return fleet_.openChannel(uid_, account, password);
+}
+
+RolloutConfig testConfig()
+{
+    RolloutConfig config;
+    config.connectTimeoutMs = 100;
+    config.stepTimeoutMs = 2000;
+    config.rebootTimeoutMs = 2000;
+    config.pollIntervalMs = 1;
+    return config;
+}
+
+/// Collects the callbacks of a rollout
+struct Observer
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t maxRunning = 0;
+    int finishes = 0;
+    RolloutProgress last;
+
+    FotaRollout::DeviceCallback deviceCallback()
+    {
+        return [this](const RolloutProgress &progress, const RolloutDevice &) {
+            std::lock_guard<std::mutex> lock(mutex);
+            maxRunning = std::max(maxRunning, progress.running);
+        };
+    }
+
+    FotaRollout::FinishCallback finishCallback()
+    {
+        return [this](const RolloutProgress &progress) {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishes++;
+            last = progress;
+            changed.notify_all();
+        };
+    }
+
+    bool waitFinishes(int count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(20), [&] { return finishes >= count; });
+    }
+};
+
+void testRollout()
+{
+    Fleet fleet;
+    std::map<std::string, DeviceCredentials> credentials;
+    for (int i = 0; i < 6; i++) {
+        std::string uid = "CAM" + std::to_string(i);
+        fleet.cameras[uid].password = "secret" + std::to_string(i);
+        credentials[uid].password = "secret" + std::to_string(i);
+    }
+    fleet.cameras["CAM2"].firmware = Firmware::Latest;
+    // The credentials of the UID are used, this camera has another password
+    fleet.cameras["CAM4"].password = "changed";
+
+    RolloutConfig config = testConfig();
+    config.waveSizes = {2, 10};
+    config.maxConcurrent = 3;
+    config.maxFailureRate = 0.5;
+    FotaRollout rollout(fleet, fleet, credentials, config);
+    Observer observer;
+    CHECK_EQ(rollout.start(observer.deviceCallback(), observer.finishCallback()), kNoError);
+    CHECK_EQ(rollout.start(nullptr, nullptr), kErrInvalidArg);
+    CHECK(observer.waitFinishes(1));
+
+    RolloutProgress progress = rollout.progress();
+    CHECK(progress.finished && !progress.halted);
+    CHECK_EQ(progress.total, 6u);
+    CHECK_EQ(progress.succeeded, 4u);
+    CHECK_EQ(progress.upToDate, 1u);
+    CHECK_EQ(progress.failed, 1u);
+    CHECK_EQ(progress.pending + progress.running + progress.cancelled, 0u);
+    CHECK_EQ(progress.wave, 1);
+    CHECK_EQ(progress.percent, 100.0);
+    CHECK(observer.maxRunning <= 3u);
+
+    std::vector<RolloutDevice> devices = rollout.devices();
+    CHECK_EQ(devices[0].wave, 0);
+    CHECK_EQ(devices[1].wave, 0);
+    CHECK_EQ(devices[2].wave, 1);
+    CHECK(devices[0].state == RolloutState::Succeeded);
+    CHECK_EQ(devices[0].result, 5);
+    CHECK(devices[2].state == RolloutState::UpToDate);
+    CHECK(devices[4].state == RolloutState::Failed);
+    CHECK_EQ(devices[4].error, kErrRejected);
+    CHECK(fleet.cameras["CAM5"].installed);
+}
+
+void testHaltAndResume()
+{
+    Fleet fleet;
+    std::map<std::string, DeviceCredentials> credentials;
+    for (const char *uid : {"A", "B", "C", "D"}) {
+        credentials[uid];
+        fleet.cameras[uid];
+    }
+    fleet.cameras["A"].firmware = Firmware::DownloadFails;
+
+    RolloutConfig config = testConfig();
+    config.waveSizes = {2};
+    config.maxFailureRate = 0.25;
+    FotaRollout rollout(fleet, fleet, credentials, config);
+    Observer observer;
+    rollout.start(observer.deviceCallback(), observer.finishCallback());
+    CHECK(observer.waitFinishes(1));
+
+    // Half of the first wave failed, the second one waits
+    RolloutProgress progress = rollout.progress();
+    CHECK(progress.halted && !progress.finished);
+    CHECK_EQ(progress.failed, 1u);
+    CHECK_EQ(progress.succeeded, 1u);
+    CHECK_EQ(progress.pending, 2u);
+    std::vector<RolloutDevice> devices = rollout.devices();
+    CHECK_EQ(devices[0].result, -3);
+    CHECK_EQ(devices[0].error, kErrRejected);
+
+    CHECK_EQ(rollout.resume(), kNoError);
+    CHECK(observer.waitFinishes(2));
+    progress = rollout.progress();
+    CHECK(progress.finished && !progress.halted);
+    CHECK_EQ(progress.succeeded, 3u);
+    CHECK_EQ(rollout.resume(), kErrInvalidArg);
+}
+
+void testTimeoutAndCancel()
+{
+    Fleet fleet;
+    std::map<std::string, DeviceCredentials> credentials;
+    for (const char *uid : {"A", "B", "C"}) {
+        credentials[uid];
+        fleet.cameras[uid].firmware = Firmware::Stuck;
+    }
+
+    RolloutConfig config = testConfig();
+    config.waveSizes = {1};
+    config.stepTimeoutMs = 300;
+    config.maxFailureRate = 1;
+    FotaRollout rollout(fleet, fleet, credentials, config);
+    Observer observer;
+    rollout.start(observer.deviceCallback(), observer.finishCallback());
+
+    // The camera started when cancelled is finished, the others are not started
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    rollout.cancel();
+    CHECK(observer.waitFinishes(1));
+    std::vector<RolloutDevice> devices = rollout.devices();
+    CHECK(devices[0].state == RolloutState::Failed);
+    CHECK_EQ(devices[0].error, kErrTimeout);
+    CHECK_EQ(devices[0].result, 2);
+    CHECK(devices[1].state == RolloutState::Cancelled);
+    CHECK(devices[2].state == RolloutState::Cancelled);
+    CHECK_EQ(observer.last.cancelled, 2u);
+    CHECK(observer.last.finished);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testRollout);
+    RUN_TEST(testHaltAndResume);
+    RUN_TEST(testTimeoutAndCancel);
+    return TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+//
+//  FrameHubTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/FrameHub.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+FramePtr makeFrame(uint32_t frameNumber, bool keyframe = false)
+{
+    auto frame = std::make_shared<Frame>();
+    frame->avIndex = 0;
+    frame->info.frameNumber = frameNumber;
+    frame->info.flags = keyframe ? kFrameFlagKeyframe : 0;
+    frame->data.assign(1000, uint8_t(frameNumber));
+    return frame;
+}
+
+void testFanOutSharesFrames()
+{
+    FrameHub hub;
+    auto preview = hub.subscribe();
+    auto recorder = hub.subscribe();
+    CHECK_EQ(hub.subscriberCount(), 2u);
+
+    FramePtr frame = makeFrame(1, true);
+    hub.publish(frame);
+    FramePtr a = preview->next(0);
+    FramePtr b = recorder->next(0);
+    // Both consumers hold the published object, not a copy
+    CHECK(a == frame && b == frame);
+    CHECK_EQ(frame.use_count(), 3);
+    CHECK(preview->next(0) == nullptr);
+
+    hub.unsubscribe(recorder);
+    hub.publish(makeFrame(2));
+    CHECK_EQ(hub.subscriberCount(), 1u);
+    CHECK(recorder->next(0) == nullptr);
+    CHECK_EQ(preview->next(0)->info.frameNumber, 2u);
+    CHECK_EQ(preview->framesDelivered(), 2u);
+}
+
+void testDropPolicies()
+{
+    FrameHub hub;
+    auto oldest = hub.subscribe(SubscriptionConfig{2, DropPolicy::Oldest});
+    auto newest = hub.subscribe(SubscriptionConfig{2, DropPolicy::Newest});
+    auto untilKeyframe = hub.subscribe(SubscriptionConfig{2, DropPolicy::UntilKeyframe});
+    for (uint32_t i = 0; i < 4; i++) {
+        hub.publish(makeFrame(i, i == 0));
+    }
+
+    CHECK_EQ(oldest->next(0)->info.frameNumber, 2u);
+    CHECK_EQ(oldest->next(0)->info.frameNumber, 3u);
+    CHECK_EQ(oldest->framesDropped(), 2u);
+
+    CHECK_EQ(newest->next(0)->info.frameNumber, 0u);
+    CHECK_EQ(newest->next(0)->info.frameNumber, 1u);
+    CHECK_EQ(newest->framesDropped(), 2u);
+
+    // Frame 2 found the queue full: 0, 1 and 2 are dropped, 3 is not a keyframe either
+    CHECK(untilKeyframe->next(0) == nullptr);
+    CHECK_EQ(untilKeyframe->framesDropped(), 4u);
+    hub.publish(makeFrame(4));
+    hub.publish(makeFrame(5, true));
+    hub.publish(makeFrame(6));
+    CHECK_EQ(untilKeyframe->next(0)->info.frameNumber, 5u);
+    CHECK_EQ(untilKeyframe->next(0)->info.frameNumber, 6u);
+    CHECK_EQ(untilKeyframe->framesDropped(), 5u);
+}
+
+void testSlowConsumerDoesNotStallOthers()
+{
+    FrameHub hub;
+    auto fast = hub.subscribe(SubscriptionConfig{4, DropPolicy::Oldest});
+    auto slow = hub.subscribe(SubscriptionConfig{4, DropPolicy::Oldest});
+    const uint32_t count = 2000;
+
+    std::atomic<uint32_t> received{0};
+    std::thread consumer([&] {
+        uint32_t last = 0;
+        bool ordered = true;
+        while (received < count) {
+            FramePtr frame = fast->next(1000);
+            if (!frame) {
+                break;
+            }
+            ordered = ordered && (received == 0 || frame->info.frameNumber > last);
+            last = frame->info.frameNumber;
+            received++;
+        }
+        CHECK(ordered);
+    });
+    // The slow consumer never takes a frame, publish goes on regardless
+    for (uint32_t i = 0; i < count; i++) {
+        hub.publish(makeFrame(i));
+        if (i % 4 == 3) {
+            while (fast->queued() > 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    consumer.join();
+
+    CHECK_EQ(received.load(), count);
+    CHECK_EQ(fast->framesDropped(), 0u);
+    CHECK_EQ(slow->queued(), 4u);
+    CHECK_EQ(slow->framesDropped(), uint64_t(count - 4));
+}
+
+void testLatestMailbox()
+{
+    FrameHub hub;
+    CHECK(!hub.consumersBehind());
+    auto live = hub.subscribe(SubscriptionConfig{8, DropPolicy::Latest});
+    auto recorder = hub.subscribe(SubscriptionConfig{8, DropPolicy::Oldest});
+    hub.publish(makeFrame(0, true));
+    CHECK(!hub.consumersBehind());
+
+    // The new frame replaces the pending one, queueDepth is ignored
+    hub.publish(makeFrame(1));
+    hub.publish(makeFrame(2));
+    CHECK_EQ(live->queued(), 1u);
+    CHECK_EQ(live->framesDropped(), 2u);
+    CHECK_EQ(live->next(0)->info.frameNumber, 2u);
+    CHECK_EQ(recorder->queued(), 3u);
+
+    // Only behind when every consumer is a full mailbox
+    hub.publish(makeFrame(3));
+    CHECK(!hub.consumersBehind());
+    hub.unsubscribe(recorder);
+    CHECK(hub.consumersBehind());
+    live->next(0);
+    CHECK(!hub.consumersBehind());
+}
+
+void testLatestKeepsUpWithSlowConsumer()
+{
+    FrameHub hub;
+    auto live = hub.subscribe(SubscriptionConfig{1, DropPolicy::Latest});
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> published{0};
+    std::atomic<uint32_t> maxLag{0};
+    std::thread consumer([&] {
+        while (!done) {
+            FramePtr frame = live->next(10);
+            if (frame) {
+                // The frame taken is the newest one, a queue would fall behind by ~10 frames per take
+                uint32_t lag = published - 1 - frame->info.frameNumber;
+                maxLag = std::max(maxLag.load(), lag);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    });
+    for (uint32_t i = 0; i < 200; i++) {
+        published = i + 1;
+        hub.publish(makeFrame(i));
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    done = true;
+    consumer.join();
+    CHECK(maxLag.load() <= 3);
+    CHECK(live->framesDropped() > 100);
+    CHECK_EQ(live->framesDelivered() + live->framesDropped() + live->queued(), 200u);
+}
+
+void testUnsubscribeWakesConsumer()
+{
+    FrameHub hub;
+    auto subscription = hub.subscribe();
+    std::thread consumer([&] { CHECK(subscription->next(5000) == nullptr); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    hub.unsubscribe(subscription);
+    consumer.join();
+    CHECK_EQ(hub.subscriberCount(), 0u);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testFanOutSharesFrames);
+    RUN_TEST(testDropPolicies);
+    RUN_TEST(testSlowConsumerDoesNotStallOthers);
+    RUN_TEST(testLatestMailbox);
+    RUN_TEST(testLatestKeepsUpWithSlowConsumer);
+    RUN_TEST(testUnsubscribeWakesConsumer);
+    return TEST_RESULT();
+}
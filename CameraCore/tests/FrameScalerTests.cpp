@@ -0,0 +1,192 @@
+//
+//  FrameScalerTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "CameraCore/Bitstream.h"
+#include "CameraCore/FrameScaler.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// An NV12 picture with padded rows and pseudo random content
+struct Nv12Buffer
+{
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> uv;
+    Nv12Picture picture;
+
+    Nv12Buffer(int width, int height, unsigned seed, bool fullRange = false)
+    {
+        picture.width = width;
+        picture.height = height;
+        picture.yStride = size_t(width) + 13;
+        picture.uvStride = size_t((width + 1) / 2) * 2 + 7;
+        picture.fullRange = fullRange;
+        y.resize(picture.yStride * size_t(height));
+        uv.resize(picture.uvStride * size_t((height + 1) / 2));
+        for (auto &b : y) {
+            seed = seed * 1103515245 + 12345;
+            b = uint8_t(seed >> 16);
+        }
+        for (auto &b : uv) {
+            seed = seed * 1103515245 + 12345;
+            b = uint8_t(seed >> 16);
+        }
+        picture.y = y.data();
+        picture.uv = uv.data();
+    }
+};
+
+double boxAverage(const uint8_t *plane, size_t stride, int step, int x0, int x1, int y0, int y1)
+{
+    double sum = 0;
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            sum += plane[size_t(y) * stride + size_t(x) * size_t(step)];
+        }
+    }
+    return sum / double((x1 - x0) * (y1 - y0));
+}
+
+/// Straightforward floating point reference: box average per plane, then BT.601
+Image reference(const Nv12Picture &src, int width, int height)
+{
+    Image out;
+    out.resize(width, height);
+    int cw = (src.width + 1) / 2;
+    int ch = (src.height + 1) / 2;
+    auto start = [](int i, int s, int d) { return int(int64_t(i) * s / d); };
+    auto end = [&](int i, int s, int d) { return std::max(start(i, s, d) + 1, start(i + 1, s, d)); };
+    for (int dy = 0; dy < height; dy++) {
+        for (int dx = 0; dx < width; dx++) {
+            double y = boxAverage(src.y, src.yStride, 1, start(dx, src.width, width), end(dx, src.width, width),
+                                  start(dy, src.height, height), end(dy, src.height, height));
+            int cx0 = start(dx, cw, width), cx1 = end(dx, cw, width);
+            int cy0 = start(dy, ch, height), cy1 = end(dy, ch, height);
+            double u = boxAverage(src.uv, src.uvStride, 2, cx0, cx1, cy0, cy1) - 128;
+            double v = boxAverage(src.uv + 1, src.uvStride, 2, cx0, cx1, cy0, cy1) - 128;
+            double c = src.fullRange ? y : (y - 16) * 255 / 219;
+            double scale = src.fullRange ? 1 : 255.0 / 224;
+            double rgb[3] = {c + 1.402 * scale * v, c - (0.344136 * u + 0.714136 * v) * scale, c + 1.772 * scale * u};
+            uint8_t *p = out.rgba.data() + (size_t(dy) * size_t(width) + size_t(dx)) * 4;
+            for (int i = 0; i < 3; i++) {
+                p[i] = uint8_t(std::lround(std::min(255.0, std::max(0.0, rgb[i]))));
+            }
+            p[3] = 255;
+        }
+    }
+    return out;
+}
+
+int maxDifference(const Image &a, const Image &b)
+{
+    if (a.width != b.width || a.height != b.height) {
+        return 256;
+    }
+    int difference = 0;
+    for (size_t i = 0; i < a.rgba.size(); i++) {
+        difference = std::max(difference, std::abs(int(a.rgba[i]) - int(b.rgba[i])));
+    }
+    return difference;
+}
+
+void testMatchesReference()
+{
+    FrameScaler scaler;
+    const int sizes[][4] = {
+        {64, 36, 64, 36},       // Full size, chroma is upsampled
+        {64, 36, 16, 9},        // Integer factor
+        {37, 23, 11, 7},        // Odd sizes, partial chroma column and row
+        {321, 241, 100, 75},    // Vector loops with tails
+        {1920, 1080, 480, 270},
+    };
+    for (auto &size : sizes) {
+        for (bool fullRange : {false, true}) {
+            Nv12Buffer src(size[0], size[1], unsigned(size[0] * 7 + size[2]), fullRange);
+            Image out;
+            scaler.convertTo(src.picture, size[2], size[3], out);
+            // Averages are rounded to integers before the conversion, the reference keeps the fraction
+            CHECK(maxDifference(out, reference(src.picture, size[2], size[3])) <= 2);
+        }
+    }
+}
+
+void testClamping()
+{
+    // Saturated colors over- and undershoot before clamping
+    Nv12Buffer src(16, 16, 1);
+    std::fill(src.y.begin(), src.y.end(), 235);
+    for (size_t i = 0; i < src.uv.size(); i++) {
+        src.uv[i] = i % 2 == 0 ? 16 : 240;
+    }
+    FrameScaler scaler;
+    Image out;
+    scaler.convert(src.picture, 8, 8, out);
+    CHECK_EQ(maxDifference(out, reference(src.picture, 8, 8)), 0);
+    CHECK_EQ(out.rgba[0], 255);
+    CHECK_EQ(out.rgba[3], 255);
+}
+
+void testFitAndReuse()
+{
+    Nv12Buffer src(1920, 1080, 3);
+    FrameScaler scaler;
+    Image out;
+    scaler.convert(src.picture, 320, 320, out);
+    CHECK_EQ(out.width, 320);
+    CHECK_EQ(out.height, 180);
+
+    // The next frame of the stream is converted into the same buffer
+    const uint8_t *buffer = out.rgba.data();
+    scaler.convert(src.picture, 320, 320, out);
+    CHECK(out.rgba.data() == buffer);
+    scaler.convert(src.picture, 160, 160, out);
+    CHECK(out.rgba.data() == buffer);
+
+    // Never larger than the source
+    scaler.convert(src.picture, 4000, 4000, out);
+    CHECK_EQ(out.width, 1920);
+    scaler.convert(src.picture, 0, 0, out);
+    CHECK_EQ(out.height, 1080);
+}
+
+void testSkipsFrame()
+{
+    std::vector<uint8_t> nonReference{0, 0, 0, 1, 0x01, 0x88, 0x84};
+    std::vector<uint8_t> reference{0, 0, 0, 1, 0x41, 0x88, 0x84};
+    ConstByteSpan n{nonReference.data(), nonReference.size()};
+    ConstByteSpan r{reference.data(), reference.size()};
+
+    OutputSize tile{320, 180, 480};
+    CHECK(tile.skipsFrame(kCodecH264, n, -1));
+    CHECK(!tile.skipsFrame(kCodecH264, r, -1));
+    OutputSize large{640, 360, 480};
+    CHECK(!large.skipsFrame(kCodecH264, n, -1));
+    OutputSize full;
+    full.skipNonReferenceBelowWidth = 480;
+    CHECK(!full.skipsFrame(kCodecH264, n, -1));
+    OutputSize never{320, 180, 0};
+    CHECK(!never.skipsFrame(kCodecH264, n, -1));
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testMatchesReference);
+    RUN_TEST(testClamping);
+    RUN_TEST(testFitAndReuse);
+    RUN_TEST(testSkipsFrame);
+    return TEST_RESULT();
+}
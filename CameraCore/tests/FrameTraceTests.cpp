@@ -0,0 +1,115 @@
+//
+//  FrameTraceTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/FrameTrace.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+size_t countOf(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+void testBuildFlag()
+{
+    CHECK_EQ(FrameTrace::enabled, frameTraceBuiltIn());
+
+    // Trace points compile to nothing without CAMCORE_FRAME_TRACE, their arguments are not evaluated
+    FrameTrace trace(4);
+    int evaluated = 0;
+    CAM_FRAME_TRACE(&trace, 0, uint32_t(++evaluated), TraceStage::Received);
+    CHECK_EQ(evaluated, FrameTrace::enabled ? 1 : 0);
+    CHECK_EQ(trace.events().size(), FrameTrace::enabled ? 1u : 0u);
+}
+
+void testRingBuffer()
+{
+    FrameTrace trace(5);        // Rounded up to 8
+    for (uint32_t i = 0; i < 10; i++) {
+        trace.record(-1, i, TraceStage::Received, 100 + i);
+    }
+    std::vector<TraceEvent> events = trace.events();
+    CHECK_EQ(events.size(), 8u);
+    CHECK_EQ(events.front().frameNumber, 2u);
+    CHECK_EQ(events.front().avIndex, -1);
+    CHECK_EQ(events.back().frameNumber, 9u);
+    CHECK_EQ(events.back().time, 109u);
+
+    trace.clear();
+    CHECK(trace.events().empty());
+    trace.record(3, 42, TraceStage::Decoded, 7);
+    CHECK_EQ(trace.events().size(), 1u);
+    CHECK(trace.events()[0].stage == TraceStage::Decoded);
+}
+
+void testChromeExport()
+{
+    FrameTrace trace(64);
+    trace.record(2, 10, TraceStage::Received, 1000);
+    trace.record(2, 11, TraceStage::Received, 1500);
+    trace.record(2, 10, TraceStage::DecodeStart, 2000);
+    trace.record(2, 10, TraceStage::Decoded, 6000);
+    trace.record(2, 10, TraceStage::Delivered, 6500);
+
+    std::string json = trace.exportChromeJson();
+    CHECK_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    CHECK_EQ(json.substr(json.size() - 2), std::string("]}"));
+    CHECK_EQ(countOf(json, "\"ph\":\"i\""), 2u);
+    CHECK_EQ(countOf(json, "\"ph\":\"X\""), 3u);
+    CHECK(json.find("{\"name\":\"Decode\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":2000,\"dur\":4000,\"args\":{\"frame\":10}}") !=
+          std::string::npos);
+    CHECK(json.find("\"name\":\"Deliver\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":6000,\"dur\":500") != std::string::npos);
+}
+
+void testConcurrentRecording()
+{
+    FrameTrace trace(1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&trace, t] {
+            for (uint32_t i = 0; i < 10000; i++) {
+                trace.record(t, i, TraceStage::Received, i);
+            }
+        });
+    }
+    std::thread reader([&trace] {
+        for (int i = 0; i < 100; i++) {
+            for (const TraceEvent &event : trace.events()) {
+                CHECK(event.avIndex >= 0 && event.avIndex < 4);
+                CHECK_EQ(uint64_t(event.frameNumber), event.time);
+            }
+        }
+    });
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    reader.join();
+    CHECK_EQ(trace.events().size(), 1024u);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testBuildFlag);
+    RUN_TEST(testRingBuffer);
+    RUN_TEST(testChromeExport);
+    RUN_TEST(testConcurrentRecording);
+    return TEST_RESULT();
+}
@@ -0,0 +1,188 @@
+//
+//  IoctrlChannelTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlChannel.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// IO controls pushed by the test, then the error of a broken session
+class QueueTransport : public Transport
+{
+public:
+    int openChannel(int, const std::string &, const std::string &) override { return 0; }
+    void closeChannel(int) override {}
+    int sendIOCtrl(int, uint32_t, ConstByteSpan) override { return kNoError; }
+
+    int recvIOCtrl(int, uint32_t *type, ByteSpan buffer, int timeoutMs) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!changed_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                               [&] { return !ioctrls_.empty() || error_ < 0; })) {
+            return kErrTimeout;
+        }
+        if (ioctrls_.empty()) {
+            return error_;
+        }
+        auto ioctrl = std::move(ioctrls_.front());
+        ioctrls_.pop_front();
+        *type = ioctrl.first;
+        std::memcpy(buffer.data, ioctrl.second.data(), ioctrl.second.size());
+        return int(ioctrl.second.size());
+    }
+
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return kErrTimeout; }
+    PathType pathType() const override { return PathType::LAN; }
+
+    void push(uint32_t type, uint8_t value, size_t size = 4)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ioctrls_.push_back({type, std::vector<uint8_t>(size, value)});
+        changed_.notify_all();
+    }
+
+    void fail(int error)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = error;
+        changed_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::pair<uint32_t, std::vector<uint8_t>>> ioctrls_;
+    int error_ = 0;
+};
+
+/// The type and the first byte of the next IO control, or the error
+int next(IoctrlQueue &queue, uint32_t *type)
+{
+    uint8_t data[kMaxIoctrlSize];
+    int size = queue.recv(type, ByteSpan{data, sizeof(data)}, 1000);
+    return size > 0 ? data[0] : size;
+}
+
+void testBroadcast()
+{
+    QueueTransport transport;
+    IoctrlChannel channel(transport, 2);
+    IoctrlQueue first(channel, {0x100});
+    IoctrlQueue second(channel, {0x100, 0x300});
+    IoctrlQueue other(channel, {0x200});
+    IoctrlQueue all(channel, {});
+
+    transport.push(0x100, 1);
+    transport.push(0x200, 2);
+    transport.push(0x300, 3);
+    transport.push(0x100, 4);
+
+    // Each queue gets every IO control of its types, in order
+    uint32_t type = 0;
+    CHECK_EQ(next(first, &type), 1);
+    CHECK_EQ(next(first, &type), 4);
+    CHECK_EQ(type, 0x100u);
+    CHECK_EQ(next(second, &type), 1);
+    CHECK_EQ(next(second, &type), 3);
+    CHECK_EQ(type, 0x300u);
+    CHECK_EQ(next(second, &type), 4);
+    CHECK_EQ(next(other, &type), 2);
+    for (int value = 1; value <= 4; value++) {
+        CHECK_EQ(next(all, &type), value);
+    }
+    uint8_t data[16];
+    CHECK_EQ(first.recv(&type, ByteSpan{data, sizeof(data)}, 20), kErrTimeout);
+
+    // A handler is called on the reader thread, not any more once unsubscribed
+    std::mutex mutex;
+    std::vector<uint32_t> handled;
+    int id = channel.subscribe({0x200}, [&](uint32_t type, ConstByteSpan) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handled.push_back(type);
+    });
+    transport.push(0x200, 5);
+    CHECK_EQ(next(other, &type), 5);
+    channel.unsubscribe(id);
+    transport.push(0x200, 6);
+    CHECK_EQ(next(other, &type), 6);
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK((handled == std::vector<uint32_t>{0x200}));
+}
+
+void testQueueBound()
+{
+    QueueTransport transport;
+    IoctrlChannel channel(transport, 2);
+    IoctrlQueue bounded(channel, {}, 2);
+    IoctrlQueue all(channel, {});
+    for (uint8_t value = 1; value <= 3; value++) {
+        transport.push(0x100, value);
+    }
+    uint32_t type = 0;
+    for (int value = 1; value <= 3; value++) {
+        CHECK_EQ(next(all, &type), value);
+    }
+    // The oldest was dropped
+    CHECK_EQ(next(bounded, &type), 2);
+    CHECK_EQ(next(bounded, &type), 3);
+
+    // An IO control larger than the buffer is dropped
+    transport.push(0x100, 4, 32);
+    transport.push(0x100, 5);
+    uint8_t data[16];
+    CHECK_EQ(bounded.recv(&type, ByteSpan{data, sizeof(data)}, 1000), kErrBufferTooSmall);
+    CHECK_EQ(next(bounded, &type), 5);
+
+    transport.push(0x100, 6);
+    CHECK_EQ(next(all, &type), 4);
+    CHECK_EQ(next(all, &type), 5);
+    CHECK_EQ(next(all, &type), 6);
+    bounded.clear();
+    CHECK_EQ(bounded.recv(&type, ByteSpan{data, sizeof(data)}, 20), kErrTimeout);
+}
+
+void testError()
+{
+    QueueTransport transport;
+    IoctrlChannel channel(transport, 2);
+    IoctrlQueue queue(channel, {});
+    CHECK_EQ(channel.error(), kNoError);
+
+    // The queued IO controls come before the error
+    transport.push(0x100, 1);
+    transport.fail(kErrClosed);
+    uint32_t type = 0;
+    CHECK_EQ(next(queue, &type), 1);
+    CHECK_EQ(next(queue, &type), kErrClosed);
+    CHECK_EQ(next(queue, &type), kErrClosed);
+    CHECK_EQ(channel.error(), kErrClosed);
+
+    // A queue of a stopped reader has the error at once
+    IoctrlQueue late(channel, {});
+    CHECK_EQ(next(late, &type), kErrClosed);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testBroadcast);
+    RUN_TEST(testQueueBound);
+    RUN_TEST(testError);
+    return TEST_RESULT();
+}
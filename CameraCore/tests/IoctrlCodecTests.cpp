@@ -0,0 +1,151 @@
+//
+//  IoctrlCodecTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <cstring>
+#include <vector>
+
+#include "CameraCore/IoctrlMessages.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+// Wire sizes of AVIOCTRLDEFs.h
+static_assert(StartStream::requestSize == 8, "SMsgAVIoctrlAVStream");
+static_assert(ListEvent::requestSize == 24, "SMsgAVIoctrlListEventReq");
+static_assert(ListEvent::responseSize == 12, "SMsgAVIoctrlListEventResp without events");
+static_assert(SAvEventCodec::size == 12, "SAvEvent");
+static_assert(PlayRecord::requestSize == 24, "SMsgAVIoctrlPlayRecord");
+static_assert(PlayRecord::responseSize == 12, "SMsgAVIoctrlPlayRecordResp");
+static_assert(SetStreamCtrl::requestSize == 8, "SMsgAVIoctrlSetStreamCtrlReq");
+static_assert(DeviceInfo::responseSize == 56, "SMsgAVIoctrlDeviceInfoResp");
+static_assert(SetPassword::requestSize == 64, "SMsgAVIoctrlSetPasswdReq");
+static_assert(SetWifi::requestSize == 76, "SMsgAVIoctrlSetWifiReq");
+static_assert(SWifiApCodec::size == 36, "SWifiAp");
+static_assert(SMsgAVIoctrlEventCodec::size == 24, "SMsgAVIoctrlEvent");
+static_assert(StartStream::responseType == 0 && StartStream::responseSize == 0, "Acknowledged only");
+
+namespace {
+
+enum class Mode : int16_t { A = -2, B = 7 };
+
+struct Sample
+{
+    uint32_t channel;
+    bool enable;
+    char name[4];
+    Mode mode;
+    int32_t value;
+};
+
+using SampleCodec = Codec<Sample,
+                          Member<&Sample::channel>,
+                          Member<&Sample::enable>,
+                          Reserved<Sample, 3>,
+                          Member<&Sample::name>,
+                          Member<&Sample::mode, Endian::Big>,
+                          Member<&Sample::value>>;
+
+void testByteOrder()
+{
+    Sample s{0x01020304, true, {'a', 'b', 'c', 'd'}, Mode::A, -5};
+    auto bytes = SampleCodec::encode(s);
+    const uint8_t expected[] = {0x04, 0x03, 0x02, 0x01, 0x01, 0, 0, 0, 'a', 'b', 'c', 'd', 0xFF, 0xFE, 0xFB, 0xFF, 0xFF, 0xFF};
+    CHECK_EQ(bytes.size(), sizeof(expected));
+    CHECK(std::memcmp(bytes.data(), expected, sizeof(expected)) == 0);
+
+    Sample d{};
+    CHECK(SampleCodec::decode(ConstByteSpan{bytes.data(), bytes.size()}, d));
+    CHECK_EQ(d.channel, 0x01020304u);
+    CHECK(d.enable);
+    CHECK(std::memcmp(d.name, "abcd", 4) == 0);
+    CHECK(d.mode == Mode::A);
+    CHECK_EQ(d.value, -5);
+}
+
+void testShortBuffers()
+{
+    Sample s{};
+    uint8_t small[SampleCodec::size - 1];
+    CHECK_EQ(SampleCodec::encode(s, ByteSpan{small, sizeof(small)}), 0u);
+    CHECK(!SampleCodec::decode(ConstByteSpan{small, sizeof(small)}, s));
+}
+
+void testPlayRecord()
+{
+    SMsgAVIoctrlPlayRecord request{};
+    request.channel = 0;
+    request.command = AVIOCTRL_RECORD_PLAY_SEEKTIME;
+    request.param = 90000;
+    request.time = STimeDay{2026, 10, 19, 1, 12, 30, 5};
+    auto bytes = PlayRecord::encodeRequest(request);
+
+    CHECK_EQ(bytes[4], AVIOCTRL_RECORD_PLAY_SEEKTIME);
+    CHECK_EQ(bytes[8] | bytes[9] << 8 | bytes[10] << 16, 90000);
+    CHECK_EQ(bytes[12] | bytes[13] << 8, 2026);
+    CHECK_EQ(bytes[14], 10);
+    CHECK_EQ(bytes[19], 5);
+    CHECK_EQ(bytes[20] | bytes[21] | bytes[22] | bytes[23], 0);
+
+    uint8_t reply[] = {0x10, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0};
+    SMsgAVIoctrlPlayRecordResp response{};
+    CHECK(PlayRecord::decodeResponse(ConstByteSpan{reply, sizeof(reply)}, response));
+    CHECK_EQ(response.command, AVIOCTRL_RECORD_PLAY_START);
+    CHECK_EQ(response.result, 3);
+}
+
+void testEventListElements()
+{
+    std::vector<uint8_t> reply(SMsgAVIoctrlListEventRespCodec::size + 2 * SAvEventCodec::size + 5);
+    SMsgAVIoctrlListEventResp header{0, 1, 0, 1, 3};
+    SMsgAVIoctrlListEventRespCodec::store(reply.data(), header);
+    SAvEvent first{STimeDay{2026, 1, 2, 5, 3, 4, 5}, 0x01, 0};
+    SAvEvent second{STimeDay{2026, 1, 2, 5, 6, 7, 8}, 0x04, 1};
+    SAvEventCodec::store(reply.data() + 12, first);
+    SAvEventCodec::store(reply.data() + 24, second);
+
+    SMsgAVIoctrlListEventResp decoded{};
+    CHECK(ListEvent::decodeResponse(ConstByteSpan{reply.data(), reply.size()}, decoded));
+    CHECK_EQ(decoded.count, 3);
+
+    // The reply claims 3 events but only holds 2 complete ones
+    std::vector<SAvEvent> events;
+    size_t count = decodeElements<SAvEventCodec>(ConstByteSpan{reply.data(), reply.size()}, SMsgAVIoctrlListEventRespCodec::size,
+                                                 decoded.count, [&](size_t, const SAvEvent &e) { events.push_back(e); });
+    CHECK_EQ(count, 2u);
+    CHECK_EQ(events[1].time.minute, 7);
+    CHECK_EQ(events[1].event, 0x04);
+    CHECK_EQ(events[1].status, 1);
+}
+
+void testDataPackage()
+{
+    uint8_t package[] = {10, 0, 0, 0, 2, 1, 4, 0, 'w', 'x', 'y', 'z'};
+    DataPackageHeader header{};
+    ConstByteSpan payload = packagePayload(ConstByteSpan{package, sizeof(package)}, header);
+    CHECK_EQ(header.total, 10u);
+    CHECK_EQ(header.index, 2);
+    CHECK_EQ(header.endflag, 1);
+    CHECK_EQ(payload.size, 4u);
+    CHECK(std::memcmp(payload.data, "wxyz", 4) == 0);
+
+    package[6] = 5;
+    CHECK_EQ(packagePayload(ConstByteSpan{package, sizeof(package)}, header).size, 0u);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testByteOrder);
+    RUN_TEST(testShortBuffers);
+    RUN_TEST(testPlayRecord);
+    RUN_TEST(testEventListElements);
+    RUN_TEST(testDataPackage);
+    return TEST_RESULT();
+}
@@ -0,0 +1,152 @@
+//
+//  IoctrlReassemblerTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlReassembler.h"
+#include "CameraCore/Transport.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+std::vector<uint8_t> makePackage(uint32_t total, uint8_t index, bool end, const std::string &payload)
+{
+    std::vector<uint8_t> p(IoctrlReassembler::kHeaderSize + payload.size());
+    p[0] = uint8_t(total);
+    p[1] = uint8_t(total >> 8);
+    p[2] = uint8_t(total >> 16);
+    p[3] = uint8_t(total >> 24);
+    p[4] = index;
+    p[5] = end ? 1 : 0;
+    p[6] = uint8_t(payload.size());
+    p[7] = uint8_t(payload.size() >> 8);
+    std::memcpy(p.data() + IoctrlReassembler::kHeaderSize, payload.data(), payload.size());
+    return p;
+}
+
+ConstByteSpan span(const std::vector<uint8_t> &v)
+{
+    return ConstByteSpan{v.data(), v.size()};
+}
+
+std::string text(ConstByteSpan s)
+{
+    return std::string(reinterpret_cast<const char *>(s.data), s.size);
+}
+
+class ScriptedTransport : public Transport
+{
+public:
+    std::deque<std::pair<uint32_t, std::vector<uint8_t>>> replies;
+
+    int openChannel(int, const std::string &, const std::string &) override { return 0; }
+    void closeChannel(int) override {}
+    int sendIOCtrl(int, uint32_t, ConstByteSpan) override { return kNoError; }
+    int recvIOCtrl(int, uint32_t *type, ByteSpan buffer, int) override
+    {
+        if (replies.empty()) {
+            return kErrTimeout;
+        }
+        auto reply = replies.front();
+        replies.pop_front();
+        *type = reply.first;
+        std::memcpy(buffer.data, reply.second.data(), reply.second.size());
+        return int(reply.second.size());
+    }
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return kErrTimeout; }
+    PathType pathType() const override { return PathType::LAN; }
+};
+
+void testSinglePackage()
+{
+    IoctrlReassembler r;
+    CHECK_EQ(r.add(span(makePackage(5, 0, true, "hello"))), 1);
+    CHECK_EQ(text(r.data()), "hello");
+}
+
+void testMultiplePackages()
+{
+    IoctrlReassembler r;
+    CHECK_EQ(r.add(span(makePackage(11, 0, false, "{\"a\":"))), 0);
+    CHECK_EQ(r.add(span(makePackage(11, 1, false, "12"))), 0);
+    CHECK_EQ(r.add(span(makePackage(11, 2, true, "345}"))), 1);
+    CHECK_EQ(text(r.data()), "{\"a\":12345}");
+
+    // The next reply starts over
+    CHECK_EQ(r.add(span(makePackage(2, 0, true, "ok"))), 1);
+    CHECK_EQ(text(r.data()), "ok");
+}
+
+void testBadPackages()
+{
+    IoctrlReassembler r;
+    CHECK_EQ(r.add(span(makePackage(6, 1, true, "abc"))), kErrBadPackage);     // does not start at 0
+
+    CHECK_EQ(r.add(span(makePackage(6, 0, false, "abc"))), 0);
+    CHECK_EQ(r.add(span(makePackage(7, 1, true, "def"))), kErrBadPackage);     // total changed
+
+    CHECK_EQ(r.add(span(makePackage(6, 0, false, "abc"))), 0);
+    CHECK_EQ(r.add(span(makePackage(6, 1, true, "de"))), kErrBadPackage);      // end before total
+
+    CHECK_EQ(r.add(span(makePackage(4, 0, false, "abc"))), 0);
+    CHECK_EQ(r.add(span(makePackage(4, 1, true, "de"))), kErrBadPackage);      // more than total
+
+    std::vector<uint8_t> truncated = makePackage(3, 0, true, "abc");
+    truncated.pop_back();
+    CHECK_EQ(r.add(span(truncated)), kErrBadPackage);
+
+    IoctrlReassembler small(4);
+    CHECK_EQ(small.add(span(makePackage(5, 0, true, "hello"))), kErrBadPackage);
+}
+
+void testMemoryBudget()
+{
+    auto memory = std::make_shared<SessionMemory>(1024, 1024);
+    IoctrlReassembler r(1024 * 1024, memory);
+    CHECK_EQ(r.add(span(makePackage(5, 0, true, "hello"))), 1);
+    CHECK_EQ(memory->stats().used, 64u);
+
+    // A reply larger than the budget is refused, the buffer is released
+    CHECK_EQ(r.add(span(makePackage(2000, 0, false, "abc"))), kErrMemoryBudget);
+    CHECK_EQ(memory->stats().used, 0u);
+    CHECK_EQ(r.add(span(makePackage(2, 0, true, "ok"))), 1);
+    CHECK_EQ(text(r.data()), "ok");
+    r.shrink();
+    CHECK_EQ(memory->stats().used, 0u);
+}
+
+void testReceiveSkipsOtherTypes()
+{
+    ScriptedTransport transport;
+    transport.replies.push_back({0x100, makePackage(2, 0, true, "xx")});
+    transport.replies.push_back({0x200, makePackage(6, 0, false, "abc")});
+    transport.replies.push_back({0x200, makePackage(6, 1, true, "def")});
+
+    IoctrlReassembler r;
+    CHECK_EQ(recvReassembled(transport, 0, 0x200, r, 1000), 6);
+    CHECK_EQ(text(r.data()), "abcdef");
+    CHECK_EQ(recvReassembled(transport, 0, 0x200, r, 1000), kErrTimeout);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testSinglePackage);
+    RUN_TEST(testMultiplePackages);
+    RUN_TEST(testBadPackages);
+    RUN_TEST(testMemoryBudget);
+    RUN_TEST(testReceiveSkipsOtherTypes);
+    return TEST_RESULT();
+}
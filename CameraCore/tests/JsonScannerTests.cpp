@@ -0,0 +1,155 @@
+//
+//  JsonScannerTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <cstring>
+#include <string>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/JsonScanner.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+ConstByteSpan span(const std::string &s)
+{
+    return ConstByteSpan{reinterpret_cast<const uint8_t *>(s.data()), s.size()};
+}
+
+JsonField field(const char *path, JsonType type)
+{
+    JsonField f;
+    f.path = path;
+    f.type = type;
+    return f;
+}
+
+const std::string kSettings =
+    "{\"result\":0,\"video\":{\"bitrate\":512,\"fps\":15.5,\"flip\":false,\"name\":\"Front \\\"door\\\"\"},"
+    "\"wifi\":{\"list\":[{\"ssid\":\"home\",\"signal\":-48},{\"ssid\":\"caf\\u00e9 \\ud83d\\ude00\",\"signal\":-70}]},"
+    "\"audio\":{\"enabled\":true}}";
+
+void testPaths()
+{
+    char name[32];
+    char ssid[32];
+    JsonField fields[] = {
+        field("video.bitrate", JsonType::Int), field("video.fps", JsonType::Double),
+        field("video.flip", JsonType::Bool),   field("video.name", JsonType::String),
+        field("wifi.list.1.ssid", JsonType::String), field("wifi.list.0.signal", JsonType::Int),
+        field("audio.enabled", JsonType::Bool),
+    };
+    fields[3].string = name;
+    fields[3].stringSize = sizeof(name);
+    fields[4].string = ssid;
+    fields[4].stringSize = sizeof(ssid);
+
+    CHECK_EQ(scanJson(span(kSettings), fields, 7), 7);
+    CHECK_EQ(fields[0].intValue, 512);
+    CHECK_EQ(fields[1].doubleValue, 15.5);
+    CHECK(!fields[2].boolValue);
+    CHECK_EQ(std::string(name), "Front \"door\"");
+    CHECK_EQ(std::string(ssid), "caf\xC3\xA9 \xF0\x9F\x98\x80");
+    CHECK_EQ(fields[5].intValue, -48);
+    CHECK(fields[6].boolValue);
+    for (const JsonField &f : fields) {
+        CHECK(f.found);
+    }
+}
+
+void testMissingAndMismatched()
+{
+    JsonField fields[] = {
+        field("video.bitrate", JsonType::String),   // No string storage and not a string
+        field("video.fps", JsonType::Int),          // Has a fraction
+        field("video", JsonType::Int),              // An object
+        field("wifi.list.2.ssid", JsonType::Int),   // Out of range
+        field("video.bitrate.x", JsonType::Int),    // Below a scalar
+        field("result", JsonType::Int),
+    };
+    CHECK_EQ(scanJson(span(kSettings), fields, 6), 1);
+    for (int i = 0; i < 5; i++) {
+        CHECK(!fields[i].found);
+    }
+    CHECK(fields[5].found);
+    CHECK_EQ(fields[5].intValue, 0);
+}
+
+void testTruncatedString()
+{
+    char ssid[5];
+    JsonField f = field("wifi.list.1.ssid", JsonType::String);
+    f.string = ssid;
+    f.stringSize = sizeof(ssid);
+    CHECK_EQ(scanJson(span(kSettings), &f, 1), 1);
+    // The two byte character does not fit, it is not cut
+    CHECK_EQ(std::string(ssid), "caf");
+}
+
+void testStopsWhenFound()
+{
+    // The rest of the document is not looked at once the field is found
+    std::string json = "{\"a\":1,\"b\":{\"c\":[1,2,\"}]{\"]},\"d\":7, this is not Json";
+    JsonField fields[] = {field("d", JsonType::Int)};
+    CHECK_EQ(scanJson(span(json), fields, 1), 1);
+    CHECK_EQ(fields[0].intValue, 7);
+
+    // Without the field the whole document is scanned
+    JsonField missing = field("e", JsonType::Int);
+    CHECK_EQ(scanJson(span(json), &missing, 1), kErrBadPackage);
+}
+
+void testTrailingNul()
+{
+    std::string json = "{\"x\": [ 1 , 2 ] }\n";
+    json.push_back('\0');
+    JsonField f = field("y", JsonType::Int);
+    CHECK_EQ(scanJson(span(json), &f, 1), 0);
+    f.path = "x.1";
+    CHECK_EQ(scanJson(span(json), &f, 1), 1);
+    CHECK_EQ(f.intValue, 2);
+}
+
+void testMalformed()
+{
+    JsonField f = field("a.b", JsonType::Int);
+    CHECK_EQ(scanJson(span("{\"a\":{\"b\" 1}}"), &f, 1), kErrBadPackage);
+    CHECK_EQ(scanJson(span("{\"a\":{\"b\":1"), &f, 1), 1);     // Found before the end
+    CHECK_EQ(scanJson(span("{\"a\":{\"c\":1"), &f, 1), kErrBadPackage);
+    CHECK_EQ(scanJson(span("{\"a\":\"x\\q\"}"), &f, 1), 0);    // Skipped strings are not unescaped
+    f.path = "a";
+    f.type = JsonType::String;
+    char out[8];
+    f.string = out;
+    f.stringSize = sizeof(out);
+    CHECK_EQ(scanJson(span("{\"a\":\"x\\q\"}"), &f, 1), kErrBadPackage);
+    CHECK_EQ(scanJson(span(""), &f, 1), kErrBadPackage);
+
+    std::string deep(kMaxJsonDepth + 1, '[');
+    deep += std::string(kMaxJsonDepth + 1, ']');
+    f.path = "0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0";
+    CHECK_EQ(scanJson(span(deep), &f, 1), kErrBadPackage);
+    // Skipped subtrees may be nested deeper
+    f.path = "x";
+    CHECK_EQ(scanJson(span("{\"a\":" + deep + ",\"x\":\"ok\"}"), &f, 1), 1);
+    CHECK_EQ(std::string(out), "ok");
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testPaths);
+    RUN_TEST(testMissingAndMismatched);
+    RUN_TEST(testTruncatedString);
+    RUN_TEST(testStopsWhenFound);
+    RUN_TEST(testTrailingNul);
+    RUN_TEST(testMalformed);
+    return TEST_RESULT();
+}
@@ -0,0 +1,256 @@
+//
+//  JsonSettingsTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlCodec.h"
+#include "CameraCore/JsonSettings.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+constexpr uint32_t kRequestType = 0x7001;
+constexpr uint32_t kResponseType = 0x7002;
+
+/// Answers each request in order with multi-package replies after kReplyDelayMs, counts the requests in flight
+class SettingsTransport : public Transport
+{
+public:
+    std::map<std::string, std::string> replies;
+    size_t packageSize = 100;
+    int failSendAt = -1;            // Index of the request whose send fails
+    int unansweredFrom = -1;        // Index of the first request that is not answered
+
+    std::atomic<size_t> sent{0};
+    std::atomic<size_t> maxInFlight{0};
+
+    int openChannel(int, const std::string &, const std::string &) override { return 0; }
+    void closeChannel(int) override {}
+
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) override
+    {
+        CHECK_EQ(avIndex, 3);
+        CHECK_EQ(type, kRequestType);
+        if (int(sent) == failSendAt) {
+            return kErrClosed;
+        }
+        CHECK(data.size > 0 && data.data[data.size - 1] == '\0');
+        std::string request(reinterpret_cast<const char *>(data.data), data.size - 1);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (unansweredFrom < 0 || int(sent) < unansweredFrom) {
+            // An event report in between is skipped
+            packages_.push_back({Clock::now() + kReplyDelay, {IOTYPE_EVENT, std::vector<uint8_t>(16)}});
+            queueReply(replies.at(request));
+        }
+        sent++;
+        maxInFlight = std::max(maxInFlight.load(), ++inFlight_);
+        return kNoError;
+    }
+
+    int recvIOCtrl(int, uint32_t *type, ByteSpan buffer, int timeoutMs) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            if (!packages_.empty() && packages_.front().first <= Clock::now()) {
+                break;
+            }
+            auto until = packages_.empty() ? deadline : std::min(deadline, packages_.front().first);
+            if (changed_.wait_until(lock, until) == std::cv_status::timeout && Clock::now() >= deadline) {
+                return kErrTimeout;
+            }
+        }
+        auto package = std::move(packages_.front().second);
+        packages_.pop_front();
+        *type = package.first;
+        if (package.first == kResponseType && package.second[5] != 0) {
+            inFlight_--;
+        }
+        std::memcpy(buffer.data, package.second.data(), package.second.size());
+        return int(package.second.size());
+    }
+
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return kErrTimeout; }
+    PathType pathType() const override { return PathType::LAN; }
+
+    /// Reply of a request that was not answered in time
+    void answerLate(const std::string &request)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queueReply(replies.at(request));
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Package = std::pair<uint32_t, std::vector<uint8_t>>;
+
+    static constexpr uint32_t IOTYPE_EVENT = 0x1FFF;
+    /// The requests of a pipeline are all in flight before the first reply is read
+    static constexpr std::chrono::milliseconds kReplyDelay{20};
+
+    void queueReply(const std::string &reply)
+    {
+        size_t offset = 0;
+        uint8_t index = 0;
+        do {
+            size_t count = std::min(packageSize, reply.size() - offset);
+            ioctrl::DataPackageHeader header{uint32_t(reply.size()), index++, uint8_t(offset + count == reply.size()),
+                                             uint16_t(count)};
+            std::vector<uint8_t> package(ioctrl::DataPackageHeaderCodec::size + count);
+            ioctrl::DataPackageHeaderCodec::store(package.data(), header);
+            std::memcpy(package.data() + ioctrl::DataPackageHeaderCodec::size, reply.data() + offset, count);
+            packages_.push_back({Clock::now() + kReplyDelay, {kResponseType, std::move(package)}});
+            offset += count;
+        } while (offset < reply.size());
+        changed_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::pair<Clock::time_point, Package>> packages_;
+    size_t inFlight_ = 0;
+};
+
+struct Poll
+{
+    int bitrate = 0;
+    char ssid[16] = {};
+    bool pir = false;
+    JsonField fields[3];
+    JsonCommand commands[3];
+
+    Poll()
+    {
+        fields[0].path = "video.bitrate";
+        fields[1].path = "wifi.ssid";
+        fields[1].type = JsonType::String;
+        fields[1].string = ssid;
+        fields[1].stringSize = sizeof(ssid);
+        fields[2].path = "sensor.pir";
+        fields[2].type = JsonType::Bool;
+        commands[0] = JsonCommand{"{\"cmd\":\"getVideo\"}", &fields[0], 1};
+        commands[1] = JsonCommand{"{\"cmd\":\"getWifi\"}", &fields[1], 1};
+        commands[2] = JsonCommand{"{\"cmd\":\"getSensor\"}", &fields[2], 1};
+    }
+};
+
+void addReplies(SettingsTransport &transport)
+{
+    std::string padding(300, 'x');
+    transport.replies["{\"cmd\":\"getVideo\"}"] = "{\"pad\":\"" + padding + "\",\"video\":{\"bitrate\":768}}";
+    transport.replies["{\"cmd\":\"getWifi\"}"] = "{\"wifi\":{\"ssid\":\"home\"}}";
+    transport.replies["{\"cmd\":\"getSensor\"}"] = "{\"sensor\":{\"pir\":true,\"md\":false}}";
+}
+
+void testPipelined()
+{
+    SettingsTransport transport;
+    addReplies(transport);
+    IoctrlChannel control(transport, 3);
+    JsonSettings settings(control, kRequestType, kResponseType, 2);
+    Poll poll;
+    CHECK_EQ(settings.exchange(poll.commands, 3, 1000), kNoError);
+    CHECK_EQ(poll.fields[0].intValue, 768);
+    CHECK_EQ(std::string(poll.ssid), "home");
+    CHECK(poll.fields[2].boolValue);
+    for (const JsonCommand &command : poll.commands) {
+        CHECK_EQ(command.result, 1);
+    }
+    CHECK_EQ(transport.sent, 3u);
+    CHECK_EQ(transport.maxInFlight, 2u);
+
+    // Repeated with the same buffers
+    CHECK_EQ(settings.exchange(poll.commands, 3, 1000), kNoError);
+    CHECK_EQ(transport.sent, 6u);
+}
+
+void testMissingField()
+{
+    SettingsTransport transport;
+    addReplies(transport);
+    transport.replies["{\"cmd\":\"getWifi\"}"] = "{\"result\":-1}";
+    IoctrlChannel control(transport, 3);
+    JsonSettings settings(control, kRequestType, kResponseType);
+    Poll poll;
+    CHECK_EQ(settings.exchange(poll.commands, 3, 1000), kNoError);
+    CHECK_EQ(poll.commands[1].result, 0);
+    CHECK(!poll.fields[1].found);
+    CHECK_EQ(transport.maxInFlight, 3u);
+
+    transport.replies["{\"cmd\":\"getWifi\"}"] = "{\"wifi\":";
+    CHECK_EQ(settings.exchange(poll.commands, 3, 1000), kErrBadPackage);
+    CHECK_EQ(poll.commands[0].result, 1);
+    CHECK_EQ(poll.commands[1].result, kErrBadPackage);
+    CHECK_EQ(poll.commands[2].result, 1);
+}
+
+void testErrors()
+{
+    SettingsTransport transport;
+    addReplies(transport);
+    IoctrlChannel control(transport, 3);
+    JsonSettings settings(control, kRequestType, kResponseType, 1);
+    Poll poll;
+
+    transport.failSendAt = 1;
+    CHECK_EQ(settings.exchange(poll.commands, 3, 1000), kErrClosed);
+    CHECK_EQ(poll.commands[0].result, 1);
+    CHECK_EQ(poll.commands[1].result, kErrClosed);
+    CHECK_EQ(poll.commands[2].result, kErrClosed);
+
+    // The second command times out, the third is not sent
+    transport.failSendAt = -1;
+    transport.sent = 0;
+    transport.unansweredFrom = 1;
+    CHECK_EQ(settings.exchange(poll.commands, 3, 100), kErrTimeout);
+    CHECK_EQ(poll.commands[0].result, 1);
+    CHECK_EQ(poll.commands[1].result, kErrTimeout);
+    CHECK_EQ(poll.commands[2].result, kErrTimeout);
+    CHECK_EQ(transport.sent, 2u);
+
+    // The next exchange sends nothing until the reply is in
+    transport.unansweredFrom = -1;
+    CHECK_EQ(settings.exchange(poll.commands, 1, 50), kErrTimeout);
+    CHECK_EQ(poll.commands[0].result, kErrTimeout);
+    CHECK_EQ(transport.sent, 2u);
+
+    // Its late reply is not taken for the reply of the next exchange
+    transport.answerLate("{\"cmd\":\"getWifi\"}");
+    poll.fields[0].intValue = 0;
+    CHECK_EQ(settings.exchange(poll.commands, 1, 1000), kNoError);
+    CHECK_EQ(poll.commands[0].result, 1);
+    CHECK_EQ(poll.fields[0].intValue, 768);
+
+    std::string tooLong(kMaxIoctrlSize, 'x');
+    JsonCommand command{tooLong.c_str(), nullptr, 0};
+    size_t sent = transport.sent;
+    CHECK_EQ(settings.exchange(&command, 1, 1000), kErrInvalidArg);
+    CHECK_EQ(transport.sent, sent);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testPipelined);
+    RUN_TEST(testMissingField);
+    RUN_TEST(testErrors);
+    return TEST_RESULT();
+}
@@ -0,0 +1,210 @@
+//
+//  KeyframeIndexTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/KeyframeIndex.h"
+#include "CameraCore/Thumbnails.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+/// 100 frames at 10 fps starting at camera time 5000 ms, a keyframe every 10 frames, frame i is i + 20 bytes of i
+std::vector<uint8_t> makeFrameFile()
+{
+    std::vector<uint8_t> file;
+    for (uint32_t i = 0; i < 100; i++) {
+        FrameInfo info;
+        info.codecId = 78;
+        info.flags = i % 10 == 0 ? kFrameFlagKeyframe : 0;
+        info.timestamp = 5000 + i * 100;
+        uint32_t size = i + 20;
+        auto header = FrameRecordHeaderCodec::encode(makeFrameRecordHeader(info, size));
+        file.insert(file.end(), header.begin(), header.end());
+        file.insert(file.end(), size, uint8_t(i));
+    }
+    return file;
+}
+
+std::string writeTemporary(const std::vector<uint8_t> &data)
+{
+    char path[] = "/tmp/camcore-kfi-XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = fdopen(fd, "wb");
+    std::fwrite(data.data(), data.size(), 1, file);
+    std::fclose(file);
+    return path;
+}
+
+void testBuildInChunks()
+{
+    std::vector<uint8_t> file = makeFrameFile();
+    // Chunk sizes that split headers and frames everywhere
+    for (size_t chunk : {size_t(1), size_t(7), size_t(16), size_t(1000), file.size()}) {
+        KeyframeIndexBuilder builder;
+        for (size_t offset = 0; offset < file.size(); offset += chunk) {
+            CHECK(builder.feed(ConstByteSpan{file.data() + offset, std::min(chunk, file.size() - offset)}));
+        }
+        const KeyframeIndex &index = builder.index();
+        CHECK_EQ(index.entries.size(), 10u);
+        CHECK_EQ(index.duration, 9900u);
+        CHECK_EQ(index.entries[3].timestamp, 3000u);
+        CHECK_EQ(index.entries[3].size, 50u);
+        // Record 30 starts after 30 headers and frames of 20..49 bytes
+        CHECK_EQ(index.entries[3].offset, 30u * 16 + (20 + 49) * 30 / 2);
+    }
+}
+
+void testTruncatedAndInvalid()
+{
+    std::vector<uint8_t> file = makeFrameFile();
+    KeyframeIndexBuilder full;
+    full.feed(ConstByteSpan{file.data(), file.size()});
+    uint64_t last = full.index().entries.back().offset;
+
+    // Cut off in the middle of the keyframe at 9000 ms
+    KeyframeIndexBuilder builder;
+    builder.feed(ConstByteSpan{file.data(), size_t(last) + 20});
+    CHECK_EQ(builder.index().entries.size(), 9u);
+
+    std::vector<uint8_t> garbage(64, 0x55);
+    KeyframeIndexBuilder invalid;
+    CHECK(!invalid.feed(ConstByteSpan{garbage.data(), garbage.size()}));
+    CHECK(!invalid.valid());
+}
+
+void testFindAtOrBefore()
+{
+    KeyframeIndex index;
+    CHECK(index.findAtOrBefore(0) == nullptr);
+    index.entries = {{0, 0, 1}, {10, 1000, 1}, {20, 2000, 1}};
+    CHECK_EQ(index.findAtOrBefore(0)->offset, 0u);
+    CHECK_EQ(index.findAtOrBefore(999)->offset, 0u);
+    CHECK_EQ(index.findAtOrBefore(1000)->offset, 10u);
+    CHECK_EQ(index.findAtOrBefore(50000)->offset, 20u);
+}
+
+void testPersist()
+{
+    std::string path = writeTemporary(makeFrameFile());
+    KeyframeIndex index;
+    bool scanned = false;
+    CHECK_EQ(loadKeyframeIndex(path, index, &scanned), kNoError);
+    CHECK(scanned);
+    CHECK_EQ(index.entries.size(), 10u);
+
+    // Re-opening the clip reads the saved index
+    KeyframeIndex reopened;
+    CHECK_EQ(loadKeyframeIndex(path, reopened, &scanned), kNoError);
+    CHECK(!scanned);
+    CHECK_EQ(reopened.entries.size(), 10u);
+    CHECK_EQ(reopened.duration, 9900u);
+    CHECK_EQ(reopened.entries[9].offset, index.entries[9].offset);
+
+    // Appending to the clip makes the index stale
+    FILE *file = std::fopen(path.c_str(), "ab");
+    auto header = FrameRecordHeaderCodec::encode(makeFrameRecordHeader(FrameInfo{78, kFrameFlagKeyframe, 0, 15000, 100}, 0));
+    std::fwrite(header.data(), header.size(), 1, file);
+    std::fclose(file);
+    CHECK_EQ(reopened.load(path), kErrNotFound);
+    CHECK_EQ(loadKeyframeIndex(path, reopened, &scanned), kNoError);
+    CHECK(scanned);
+    CHECK_EQ(reopened.entries.size(), 11u);
+
+    std::remove(KeyframeIndex::indexPath(path).c_str());
+    std::remove(path.c_str());
+}
+
+/// Decodes to a 64 x 48 picture filled with the first byte of the frame
+class FillDecoder : public KeyframeDecoder
+{
+public:
+    std::vector<uint8_t> decoded;
+
+    int decode(uint16_t codecId, ConstByteSpan frame, Image &picture) override
+    {
+        if (codecId != 78 || frame.size == 0) {
+            return kErrUnsupported;
+        }
+        decoded.push_back(frame.data[0]);
+        picture.resize(64, 48);
+        std::fill(picture.rgba.begin(), picture.rgba.end(), frame.data[0]);
+        return kNoError;
+    }
+};
+
+void testThumbnails()
+{
+    std::string path = writeTemporary(makeFrameFile());
+    KeyframeIndex index;
+    CHECK_EQ(loadKeyframeIndex(path, index), kNoError);
+
+    std::vector<size_t> selected = selectThumbnailKeyframes(index, 5);
+    CHECK_EQ(selected.size(), 5u);
+    CHECK_EQ(selected[1], 1u);
+    CHECK_EQ(selected[4], 7u);
+    // More thumbnails than keyframes use every keyframe once
+    CHECK_EQ(selectThumbnailKeyframes(index, 40).size(), 10u);
+
+    FillDecoder decoder;
+    std::vector<Image> thumbnails;
+    CHECK_EQ(generateThumbnails(path, index, 5, 16, 16, decoder, thumbnails), kNoError);
+    CHECK_EQ(thumbnails.size(), 5u);
+    CHECK_EQ(decoder.decoded.size(), 5u);
+    CHECK_EQ(decoder.decoded[4], 70);
+    CHECK_EQ(thumbnails[4].width, 16);
+    CHECK_EQ(thumbnails[4].height, 12);
+    CHECK_EQ(thumbnails[4].rgba[0], 70);
+
+    CHECK_EQ(generateThumbnails(path, KeyframeIndex(), 5, 16, 16, decoder, thumbnails), kErrNotFound);
+    std::remove(KeyframeIndex::indexPath(path).c_str());
+    std::remove(path.c_str());
+}
+
+void testDownscale()
+{
+    int w, h;
+    fitSize(1920, 1080, 160, 160, &w, &h);
+    CHECK(w == 160 && h == 90);
+    fitSize(1080, 1920, 160, 160, &w, &h);
+    CHECK(w == 90 && h == 160);
+    fitSize(100, 50, 400, 400, &w, &h);
+    CHECK(w == 100 && h == 50);
+
+    Image src;
+    src.resize(4, 2);
+    for (int i = 0; i < 8; i++) {
+        std::fill(src.rgba.begin() + i * 4, src.rgba.begin() + i * 4 + 4, uint8_t(i * 10));
+    }
+    Image dst;
+    downscaleBox(src, 2, 1, dst);
+    // Average of pixels 0, 1, 4, 5 and of 2, 3, 6, 7
+    CHECK_EQ(dst.rgba[0], 25);
+    CHECK_EQ(dst.rgba[4], 45);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testBuildInChunks);
+    RUN_TEST(testTruncatedAndInvalid);
+    RUN_TEST(testFindAtOrBefore);
+    RUN_TEST(testPersist);
+    RUN_TEST(testThumbnails);
+    RUN_TEST(testDownscale);
+    return TEST_RESULT();
+}
@@ -0,0 +1,237 @@
+//
+//  MetricsTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/MeteredTransport.h"
+#include "CameraCore/Metrics.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+void testHistogram()
+{
+    LatencyHistogram histogram;
+    CHECK_EQ(histogram.snapshot().valueAtPercentile(50), 0.0);
+
+    for (int i = 0; i < 90; i++) {
+        histogram.record(3);            // 5 ms bucket
+    }
+    for (int i = 0; i < 9; i++) {
+        histogram.record(150);          // 200 ms bucket
+    }
+    histogram.record(60000);            // Above the last bound
+
+    HistogramSnapshot s = histogram.snapshot();
+    CHECK_EQ(s.count, 100u);
+    CHECK_EQ(s.counts[2], 90u);
+    CHECK_EQ(s.counts[7], 9u);
+    CHECK_EQ(s.counts[13], 1u);
+    CHECK_EQ(s.min, 3.0);
+    CHECK_EQ(s.max, 60000.0);
+    CHECK(s.mean > 616 && s.mean < 617);
+    CHECK_EQ(s.valueAtPercentile(50), 5.0);
+    CHECK_EQ(s.valueAtPercentile(95), 200.0);
+    CHECK_EQ(s.valueAtPercentile(100), 60000.0);
+
+    // Bucket bounds are inclusive
+    LatencyHistogram bounds;
+    bounds.recordMicros(1000);
+    bounds.recordMicros(1001);
+    CHECK_EQ(bounds.snapshot().counts[0], 1u);
+    CHECK_EQ(bounds.snapshot().counts[1], 1u);
+
+    histogram.reset();
+    CHECK_EQ(histogram.snapshot().count, 0u);
+}
+
+void testConcurrentRecording()
+{
+    SessionMetrics metrics;
+    ChannelMetrics &channel = metrics.addChannel(3);
+    std::atomic<bool> stop{false};
+    std::thread reader([&] {
+        while (!stop.load()) {
+            SessionSnapshot s = metrics.snapshot();
+            CHECK(s.channels.size() <= 1);
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&channel, t] {
+            for (uint64_t i = 1; i <= 10000; i++) {
+                channel.frameReceived(100, i * 1000 + uint64_t(t));
+                channel.frameInterval.recordMicros(i);
+            }
+        });
+    }
+    for (auto &w : writers) {
+        w.join();
+    }
+    stop.store(true);
+    reader.join();
+
+    ChannelSnapshot s = metrics.snapshot().channels.at(0);
+    CHECK_EQ(s.avIndex, 3);
+    CHECK_EQ(s.framesReceived, 40000u);
+    CHECK_EQ(s.bytesReceived, 4000000u);
+    CHECK_EQ(s.frameInterval.count, 40000u + 39999u);
+}
+
+void testSessionAndChannels()
+{
+    SessionMetrics metrics;
+    metrics.connected(PathType::Relay, 250000, false);
+    metrics.connected(PathType::P2P, 80000, true);
+    metrics.ioctrlAcknowledged(40000);
+
+    ChannelMetrics &first = metrics.addChannel(0);
+    first.streamStarted(1000000);
+    first.frameReceived(5000, 1300000);
+    first.frameReceived(1000, 1366000);
+    first.frameDropped(2);
+    metrics.addChannel(1).frameReceived(10, 5);
+    // Out of range IDs are accepted and not reported
+    metrics.addChannel(SessionMetrics::kMaxChannels).frameReceived(10, 5);
+    CHECK(metrics.channel(SessionMetrics::kMaxChannels) == nullptr);
+
+    SessionSnapshot s = metrics.snapshot();
+    CHECK(s.pathType == PathType::P2P);
+    CHECK_EQ(s.reconnectCount, 1u);
+    CHECK_EQ(s.ioctrlCount, 1u);
+    CHECK_EQ(s.connectLatency.count, 2u);
+    CHECK_EQ(s.ioctrlAckLatency.max, 40.0);
+    CHECK_EQ(s.channels.size(), 2u);
+    CHECK_EQ(s.channels[0].framesReceived, 2u);
+    CHECK_EQ(s.channels[0].framesDropped, 2u);
+    CHECK_EQ(s.channels[0].firstFrameLatency.count, 1u);
+    CHECK_EQ(s.channels[0].firstFrameLatency.max, 300.0);
+    CHECK_EQ(s.channels[0].frameInterval.max, 66.0);
+
+    metrics.removeChannel(1);
+    CHECK_EQ(metrics.snapshot().channels.size(), 1u);
+    CHECK(metrics.channel(1) == nullptr);
+    CHECK(metrics.channel(2) == nullptr);
+    CHECK_EQ(metrics.addChannel(1).snapshot().framesReceived, 0u);
+
+    // A reset forgets the stream start, the next frame is no first frame
+    first.streamStarted(2000000);
+    first.reset();
+    first.frameReceived(100, 2500000);
+    CHECK_EQ(first.snapshot().firstFrameLatency.count, 0u);
+}
+
+void testRates()
+{
+    SessionSnapshot previous;
+    ChannelSnapshot before;
+    before.avIndex = 0;
+    before.time = 1000000;
+    before.framesReceived = 100;
+    before.bytesReceived = 1000000;
+    previous.channels.push_back(before);
+
+    SessionSnapshot current;
+    ChannelSnapshot after = before;
+    after.time = 3000000;
+    after.framesReceived = 130;
+    after.bytesReceived = 1500000;
+    current.channels.push_back(after);
+
+    MetricsReporter::computeRates(previous, current);
+    CHECK_EQ(current.channels[0].fps, 15.0);
+    CHECK_EQ(current.channels[0].bitrate, 2000.0);
+}
+
+class CountingTransport : public Transport
+{
+public:
+    int openChannel(int channel, const std::string &, const std::string &) override { return channel; }
+    void closeChannel(int) override {}
+    int sendIOCtrl(int, uint32_t, ConstByteSpan) override { return kNoError; }
+    int recvIOCtrl(int, uint32_t *, ByteSpan, int) override { return kErrTimeout; }
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return 1200; }
+    PathType pathType() const override { return PathType::LAN; }
+};
+
+class CountingConnector : public Connector
+{
+public:
+    std::unique_ptr<Transport> connect(const std::string &, int, int *) override
+    {
+        return std::unique_ptr<Transport>(new CountingTransport);
+    }
+};
+
+void testMeteredTransport()
+{
+    SessionMetrics metrics;
+    CountingConnector connector;
+    MeteredConnector metered(connector, [&](const std::string &) -> SessionMetrics & { return metrics; });
+    int error = 0;
+    metered.connect("UID1", 1000, &error);
+    std::unique_ptr<Transport> transport = metered.connect("UID1", 1000, &error);
+
+    int avIndex = transport->openChannel(2, "admin", "admin");
+    uint8_t byte = 0;
+    transport->sendIOCtrl(avIndex, 0x1FF, ConstByteSpan{&byte, 1});
+    FrameInfo info;
+    for (int i = 0; i < 3; i++) {
+        transport->recvFrame(avIndex, ByteSpan{&byte, 1}, &info, 100);
+    }
+
+    SessionSnapshot s = metrics.snapshot();
+    CHECK(s.pathType == PathType::LAN);
+    CHECK_EQ(s.connectLatency.count, 2u);
+    CHECK_EQ(s.reconnectCount, 1u);
+    CHECK_EQ(s.ioctrlCount, 1u);
+    CHECK_EQ(s.channels.size(), 1u);
+    CHECK_EQ(s.channels[0].avIndex, 2);
+    CHECK_EQ(s.channels[0].framesReceived, 3u);
+    CHECK_EQ(s.channels[0].bytesReceived, 3600u);
+    CHECK_EQ(s.channels[0].firstFrameLatency.count, 1u);
+
+    transport->closeChannel(avIndex);
+    CHECK_EQ(metrics.snapshot().channels.size(), 0u);
+}
+
+void testReporter()
+{
+    SessionMetrics metrics;
+    metrics.addChannel(0).frameReceived(100, 1);
+    std::atomic<int> reports{0};
+    {
+        MetricsReporter reporter(metrics, 100, [&](const SessionSnapshot &s) {
+            CHECK_EQ(s.channels.size(), 1u);
+            reports++;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    }
+    int count = reports.load();
+    CHECK(count >= 1 && count <= 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK_EQ(reports.load(), count);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testHistogram);
+    RUN_TEST(testConcurrentRecording);
+    RUN_TEST(testSessionAndChannels);
+    RUN_TEST(testRates);
+    RUN_TEST(testMeteredTransport);
+    RUN_TEST(testReporter);
+    return TEST_RESULT();
+}
@@ -0,0 +1,274 @@
+//
+//  PlaybackControlTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/PlaybackControl.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+constexpr int kControlAvIndex = 0;
+constexpr uint32_t kGop = 4;
+
+/// Answers RECORD_PLAYCONTROL on the control channel and sends an endless GOP on each playback channel
+class PlaybackTransport : public Transport
+{
+public:
+    std::mutex mutex;
+    std::condition_variable replied;
+    std::vector<SMsgAVIoctrlPlayRecord> commands;
+    std::deque<std::pair<uint32_t, std::vector<uint8_t>>> replies;
+    std::map<int, uint32_t> nextFrame;
+    std::set<int> closed;
+    int nextChannel = 1;
+    int32_t rejectCommand = -1;
+    bool silent = false;
+
+    int openChannel(int channel, const std::string &account, const std::string &) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (account != "admin") {
+            return -20009;
+        }
+        nextFrame[channel + 10] = 0;
+        return channel + 10;
+    }
+
+    void closeChannel(int avIndex) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed.insert(avIndex);
+    }
+
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        SMsgAVIoctrlPlayRecord request;
+        if (avIndex != kControlAvIndex || type != PlayRecord::requestType || !SMsgAVIoctrlPlayRecordCodec::decode(data, request)) {
+            return kErrInvalidArg;
+        }
+        commands.push_back(request);
+        if (silent) {
+            return kNoError;
+        }
+        SMsgAVIoctrlPlayRecordResp response{request.command, 0};
+        if (int32_t(request.command) == rejectCommand) {
+            response.result = -1;
+        } else if (request.command == AVIOCTRL_RECORD_PLAY_START) {
+            response.result = nextChannel++;
+        }
+        queue(response);
+        return kNoError;
+    }
+
+    int recvIOCtrl(int, uint32_t *type, ByteSpan buffer, int timeoutMs) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!replied.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return !replies.empty(); })) {
+            return kErrTimeout;
+        }
+        auto reply = replies.front();
+        replies.pop_front();
+        *type = reply.first;
+        std::copy(reply.second.begin(), reply.second.end(), buffer.data);
+        return int(reply.second.size());
+    }
+
+    int recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed.count(avIndex) || !nextFrame.count(avIndex)) {
+            return kErrClosed;
+        }
+        uint32_t number = nextFrame[avIndex]++;
+        info->frameNumber = number;
+        info->flags = number % kGop == 0 ? kFrameFlagKeyframe : 0;
+        info->timestamp = number * 66;
+        buffer.data[0] = uint8_t(avIndex);
+        return 100;
+    }
+
+    PathType pathType() const override { return PathType::Relay; }
+
+    void skipFrames(int avIndex, uint32_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nextFrame[avIndex] += count;
+    }
+
+    SMsgAVIoctrlPlayRecord lastCommand()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return commands.back();
+    }
+
+    /// A response the camera sends by itself
+    void push(const SMsgAVIoctrlPlayRecordResp &response)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue(response);
+    }
+
+private:
+    void queue(const SMsgAVIoctrlPlayRecordResp &response)
+    {
+        auto bytes = SMsgAVIoctrlPlayRecordRespCodec::encode(response);
+        replies.emplace_back(PlayRecord::responseType, std::vector<uint8_t>(bytes.begin(), bytes.end()));
+        replied.notify_all();
+    }
+};
+
+const STimeDay kFirst{2026, 10, 19, 1, 8, 0, 0};
+const STimeDay kSecond{2026, 10, 19, 1, 8, 5, 0};
+
+void testStartAndSpeed()
+{
+    PlaybackTransport transport;
+    IoctrlChannel control(transport, kControlAvIndex);
+    PlaybackControl playback(control, 0, "admin", "admin");
+    CHECK_EQ(playback.setSpeed(2, 100), kErrInvalidArg);
+
+    CHECK_EQ(playback.start(kFirst, 100), 11);
+    CHECK_EQ(transport.lastCommand().command, AVIOCTRL_RECORD_PLAY_START);
+    CHECK_EQ(transport.lastCommand().time.hour, 8);
+
+    uint8_t frame[256];
+    FrameInfo info;
+    CHECK_EQ(playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100), 100);
+    CHECK_EQ(playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100), 100);
+    CHECK_EQ(info.frameNumber, 1u);
+
+    CHECK_EQ(playback.setSpeed(3, 100), kErrInvalidArg);
+    CHECK_EQ(playback.setSpeed(4, 100), kNoError);
+    CHECK_EQ(transport.lastCommand().command, AVIOCTRL_RECORD_PLAY_FORWARD);
+    CHECK_EQ(transport.lastCommand().param, 4u);
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100), 100);
+        CHECK(info.isKeyframe());
+    }
+    CHECK_EQ(info.frameNumber, 12u);
+
+    CHECK_EQ(playback.setSpeed(1, 100), kNoError);
+    playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100);
+    CHECK_EQ(info.frameNumber, 13u);
+}
+
+void testSeek()
+{
+    PlaybackTransport transport;
+    IoctrlChannel control(transport, kControlAvIndex);
+    PlaybackControl playback(control, 0, "admin", "admin");
+    CHECK_EQ(playback.seek(1000, 100), kErrInvalidArg);
+    int avIndex = playback.start(kFirst, 100);
+    transport.skipFrames(avIndex, 1);
+
+    CHECK_EQ(playback.seek(90000, 100), kNoError);
+    CHECK_EQ(transport.lastCommand().command, AVIOCTRL_RECORD_PLAY_SEEKTIME);
+    CHECK_EQ(transport.lastCommand().param, 90000u);
+
+    uint8_t frame[256];
+    FrameInfo info;
+    CHECK_EQ(playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100), 100);
+    CHECK(info.isKeyframe());
+    CHECK_EQ(info.frameNumber, 4u);
+    playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100);
+    CHECK_EQ(info.frameNumber, 5u);
+
+    // Frames received while the seek waits for its reply are dropped up to the next keyframe
+    transport.silent = true;
+    int result = kErrTimeout;
+    std::thread seek([&] { result = playback.seek(1000, 1000); });
+    while (transport.lastCommand().command != AVIOCTRL_RECORD_PLAY_SEEKTIME || transport.lastCommand().param != 1000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK_EQ(playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100), 100);
+    CHECK_EQ(info.frameNumber, 8u);
+    transport.push(SMsgAVIoctrlPlayRecordResp{AVIOCTRL_RECORD_PLAY_SEEKTIME, 0});
+    seek.join();
+    CHECK_EQ(result, kNoError);
+}
+
+void testPrefetchHandoff()
+{
+    PlaybackTransport transport;
+    {
+        IoctrlChannel control(transport, kControlAvIndex);
+        PlaybackControl playback(control, 0, "admin", "admin");
+        CHECK_EQ(playback.playPrefetched(100), kErrNotFound);
+        CHECK_EQ(playback.start(kFirst, 100), 11);
+        CHECK_EQ(playback.prefetch(kSecond, 1000, 100), 12);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (playback.prefetchedBytes() < 1000 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK_EQ(playback.prefetchedBytes(), 1000u);
+
+        // The prefetch thread stopped at the budget, the rest is still in the AV channel
+        CHECK_EQ(playback.playPrefetched(100), 12);
+        CHECK_EQ(playback.playbackAvIndex(), 12);
+        CHECK(transport.closed.count(11) == 1);
+        CHECK_EQ(transport.lastCommand().command, AVIOCTRL_RECORD_PLAY_STOP);
+        CHECK_EQ(transport.lastCommand().time.minute, 0);
+
+        uint8_t frame[256];
+        FrameInfo info;
+        for (uint32_t i = 0; i < 12; i++) {
+            CHECK_EQ(playback.recvFrame(ByteSpan{frame, sizeof(frame)}, &info, 100), 100);
+            CHECK_EQ(info.frameNumber, i);
+            CHECK_EQ(frame[0], 12);
+        }
+    }
+    CHECK(transport.closed.count(12) == 1);
+}
+
+void testCommandResults()
+{
+    PlaybackTransport transport;
+    IoctrlChannel control(transport, kControlAvIndex);
+    PlaybackControl playback(control, 0, "admin", "admin");
+    playback.start(kFirst, 100);
+
+    transport.rejectCommand = AVIOCTRL_RECORD_PLAY_SEEKTIME;
+    CHECK_EQ(playback.seek(5000, 100), kErrRejected);
+
+    // PLAY_END is recorded while no command waits, and is not mistaken for a reply
+    transport.push(SMsgAVIoctrlPlayRecordResp{AVIOCTRL_RECORD_PLAY_END, 0});
+    for (int i = 0; i < 100 && !playback.ended(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(playback.ended());
+    transport.push(SMsgAVIoctrlPlayRecordResp{AVIOCTRL_RECORD_PLAY_END, 0});
+    CHECK_EQ(playback.pause(100), kNoError);
+
+    transport.silent = true;
+    CHECK_EQ(playback.pause(50), kErrTimeout);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testStartAndSpeed);
+    RUN_TEST(testSeek);
+    RUN_TEST(testPrefetchHandoff);
+    RUN_TEST(testCommandResults);
+    return TEST_RESULT();
+}
@@ -0,0 +1,218 @@
+//
+//  QualityControlTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/QualityControl.h"
+#include "CameraCore/SimulatedDevice.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+QualityControlConfig threeLevels()
+{
+    QualityControlConfig config;
+    config.levels = {{336, AVIOCTRL_QUALITY_LOW, ""}, {560, AVIOCTRL_QUALITY_MIDDLE, ""}, {1120, AVIOCTRL_QUALITY_MAX, ""}};
+    return config;
+}
+
+/// A 25 fps stream of the level bitrate over a link of capacity kbit per second, evaluated every intervalMs
+struct Link
+{
+    explicit Link(uint32_t capacity) : capacity(capacity) {}
+
+    uint32_t capacity;
+    double clockRate = 1;           // Camera clock against the local clock
+    std::vector<QualitySwitch> switches;
+
+    void run(QualityEstimator &estimator, const QualityControlConfig &config, int seconds)
+    {
+        struct Pending { uint64_t arrival; uint32_t bytes; uint32_t timestamp; };
+        std::deque<Pending> pending;
+        const uint64_t start = 1000000;
+        uint64_t linkFree = start;
+        uint64_t nextUpdate = start + uint64_t(config.intervalMs) * 1000;
+        for (uint64_t now = start; now < start + uint64_t(seconds) * 1000000; now += 1000) {
+            if ((now - start) % 40000 == 0) {
+                uint32_t bytes = config.levels[size_t(estimator.level())].bitrate * 1000 / 8 / 25;
+                linkFree = std::max(linkFree, now) + uint64_t(bytes) * 8000 / capacity;
+                pending.push_back(Pending{linkFree, bytes, uint32_t(double(now - start) * clockRate / 1000)});
+            }
+            while (!pending.empty() && pending.front().arrival <= now) {
+                estimator.frameReceived(pending.front().bytes, pending.front().timestamp, pending.front().arrival);
+                pending.pop_front();
+            }
+            if (now >= nextUpdate) {
+                nextUpdate += uint64_t(config.intervalMs) * 1000;
+                int from = estimator.level();
+                int to = estimator.update(now);
+                if (to != from) {
+                    switches.push_back(QualitySwitch{now - start, from, to, estimator.goodput(), estimator.queueDelayMs(), 0});
+                    estimator.switched(to, now);
+                }
+            }
+        }
+    }
+};
+
+void testDownSwitch()
+{
+    QualityControlConfig config = threeLevels();
+    QualityEstimator estimator(config);
+    CHECK_EQ(estimator.level(), 2);
+
+    // 1120 kbit per second over 600, the queue grows until the level fits in 80% of the goodput
+    Link link(600);
+    link.run(estimator, config, 10);
+    CHECK_EQ(link.switches.size(), 1u);
+    const QualitySwitch &down = link.switches[0];
+    CHECK_EQ(down.fromLevel, 2);
+    CHECK_EQ(down.toLevel, 0);
+    CHECK(down.time >= 3000000 && down.time < 5000000);
+    CHECK(down.goodput > 500 && down.goodput < 700);
+    CHECK(down.queueDelayMs > 500);
+}
+
+void testHysteresis()
+{
+    QualityControlConfig config = threeLevels();
+    QualityEstimator estimator(config);
+    Link link(600);
+    link.run(estimator, config, 150);
+
+    // Down to the lowest level, up one level at a time after 15 s without queueing, the level over the
+    // capacity is undone and tried again after twice the time
+    CHECK(link.switches.size() >= 5);
+    CHECK_EQ(link.switches[0].toLevel, 0);
+    CHECK_EQ(link.switches[1].toLevel, 1);
+    CHECK(link.switches[1].time - link.switches[0].time >= 15000000);
+    CHECK_EQ(link.switches[2].toLevel, 2);
+    CHECK(link.switches[3].toLevel < 2);
+    CHECK(link.switches[3].time - link.switches[2].time < 15000000);
+    for (size_t i = 1; i < link.switches.size(); i++) {
+        CHECK(link.switches[i].time - link.switches[i - 1].time >= 10000000);
+    }
+    for (size_t i = 4; i < link.switches.size(); i++) {
+        if (link.switches[i].toLevel == 2) {
+            CHECK(link.switches[i].time - link.switches[i - 1].time >= 30000000);
+        }
+    }
+
+    // A link with room for every level is left alone
+    QualityEstimator fast(config);
+    Link wide(2000);
+    wide.run(fast, config, 60);
+    CHECK(wide.switches.empty());
+    CHECK(fast.queueDelayMs() < 100);
+}
+
+void testClockDrift()
+{
+    // A camera clock 100 ppm slow makes every frame 360 ms later for its timestamp after an hour
+    QualityControlConfig config = threeLevels();
+    QualityEstimator estimator(config);
+    Link link(2000);
+    link.clockRate = 1 - 100e-6;
+    link.run(estimator, config, 3 * 3600);
+    CHECK(link.switches.empty());
+    CHECK(estimator.queueDelayMs() < 100);
+}
+
+void testStall()
+{
+    QualityControlConfig config = threeLevels();
+    QualityEstimator estimator(config);
+    uint64_t now = 1000000;
+    for (int i = 0; i < 25; i++, now += 40000) {
+        estimator.frameReceived(5600, uint32_t(i * 40), now);
+    }
+    CHECK_EQ(estimator.update(now), 2);
+
+    // No frame for 4 s is a queue of 4 s
+    int level = 2;
+    for (int i = 0; i < 8 && level == 2; i++) {
+        now += 500000;
+        level = estimator.update(now);
+    }
+    CHECK_EQ(level, 0);
+    CHECK(estimator.queueDelayMs() >= 3000);
+}
+
+void testController()
+{
+    SimulatorConfig simulatorConfig;
+    simulatorConfig.fps = 25;
+    simulatorConfig.gop = 25;
+    simulatorConfig.keyframeSize = 20000;
+    simulatorConfig.frameSize = 5000;
+    simulatorConfig.bandwidth = 600;
+    SimulatedDevice device(simulatorConfig);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(device.config().uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+    auto start = StartStream::encodeRequest(SMsgAVIoctrlAVStream{0});
+    CHECK_EQ(transport->sendIOCtrl(avIndex, StartStream::requestType, ConstByteSpan{start.data(), start.size()}), kNoError);
+
+    QualityControlConfig config = threeLevels();
+    config.downDelayMs = 300;
+    config.downHoldMs = 500;
+    config.upHoldMs = 60000;
+    config.holdOffMs = 60000;
+    config.intervalMs = 100;
+    ChannelMetrics metrics(avIndex);
+    std::vector<QualitySwitch> switches;
+    std::mutex mutex;
+    {
+        QualityController controller(*transport, avIndex, 0, config, nullptr, &metrics, [&](const QualitySwitch &change) {
+            std::lock_guard<std::mutex> lock(mutex);
+            switches.push_back(change);
+        });
+        std::vector<uint8_t> buffer(64 * 1024);
+        auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (controller.level() == 2 && std::chrono::steady_clock::now() < end) {
+            FrameInfo info;
+            int size = transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 100);
+            if (size > 0) {
+                controller.frameReceived(uint32_t(size), info);
+            }
+        }
+        CHECK_EQ(controller.level(), 0);
+    }
+
+    // The camera got SETSTREAMCTRL on the stream's own AV channel, the session was not reopened
+    CHECK_EQ(device.quality(0), uint8_t(AVIOCTRL_QUALITY_LOW));
+    CHECK_EQ(device.sessionCount(), 1u);
+    CHECK_EQ(switches.size(), 1u);
+    CHECK_EQ(switches[0].fromLevel, 2);
+    CHECK_EQ(switches[0].toLevel, 0);
+    CHECK_EQ(switches[0].result, kNoError);
+    ChannelSnapshot snapshot = metrics.snapshot();
+    CHECK_EQ(snapshot.qualitySwitches, 1u);
+    CHECK_EQ(snapshot.qualityLevel, 0);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testDownSwitch);
+    RUN_TEST(testHysteresis);
+    RUN_TEST(testClockDrift);
+    RUN_TEST(testStall);
+    RUN_TEST(testController);
+    return TEST_RESULT();
+}
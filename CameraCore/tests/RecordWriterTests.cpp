@@ -0,0 +1,253 @@
+//
+//  RecordWriterTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/FrameFile.h"
+#include "CameraCore/KeyframeIndex.h"
+#include "CameraCore/RecordWriter.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+std::string temporaryPath(const char *name)
+{
+    return std::string("/tmp/camcore-writer-") + std::to_string(getpid()) + "-" + name;
+}
+
+void removeRecording(const std::string &path)
+{
+    unlink(path.c_str());
+    unlink(KeyframeIndex::indexPath(path).c_str());
+}
+
+FrameInfo frameInfo(uint32_t i, uint32_t gop)
+{
+    FrameInfo info;
+    info.codecId = 78;
+    info.flags = i % gop == 0 ? kFrameFlagKeyframe : 0;
+    info.timestamp = 1000 + i * 40;
+    info.frameNumber = i;
+    return info;
+}
+
+/// Frame i of a stream is 500 + (i * 37) % 3000 bytes of (seed + i)
+std::vector<uint8_t> frameData(uint32_t i, uint8_t seed)
+{
+    return std::vector<uint8_t>(500 + (i * 37) % 3000, uint8_t(seed + i));
+}
+
+/// Check that a file holds the records of frames 0..count-1 of frameData(seed) and nothing else
+bool verifyFile(const std::string &path, uint32_t count, uint8_t seed)
+{
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        uint8_t bytes[FrameRecordHeaderCodec::size];
+        FrameRecordHeader header;
+        ok = std::fread(bytes, sizeof(bytes), 1, file) == 1 && FrameRecordHeaderCodec::decode(ConstByteSpan{bytes, sizeof(bytes)}, header) &&
+             header.magic == kFrameRecordMagic && header.timestamp == 1000 + i * 40;
+        std::vector<uint8_t> expected = frameData(i, seed);
+        std::vector<uint8_t> data(header.size);
+        ok = ok && header.size == expected.size() && std::fread(data.data(), data.size(), 1, file) == 1 && data == expected;
+    }
+    ok = ok && std::fgetc(file) == EOF;
+    std::fclose(file);
+    return ok;
+}
+
+void testInterleavedRecordings()
+{
+    RecordWriterConfig config;
+    config.blockSize = 8192;
+    RecordWriter writer(config);
+    std::vector<std::string> paths;
+    std::vector<int> ids;
+    for (int r = 0; r < 3; r++) {
+        paths.push_back(temporaryPath(std::to_string(r).c_str()));
+        ids.push_back(writer.open(paths.back()));
+        CHECK(ids.back() >= 0);
+    }
+    for (uint32_t i = 0; i < 200; i++) {
+        for (int r = 0; r < 3; r++) {
+            std::vector<uint8_t> data = frameData(i, uint8_t(r * 50));
+            CHECK_EQ(writer.write(ids[size_t(r)], frameInfo(i, 25), ConstByteSpan{data.data(), data.size()}), kNoError);
+        }
+    }
+    for (int r = 0; r < 3; r++) {
+        CHECK_EQ(writer.close(ids[size_t(r)]), kNoError);
+        CHECK(verifyFile(paths[size_t(r)], 200, uint8_t(r * 50)));
+
+        // The index was saved on close and matches the file
+        KeyframeIndex index;
+        bool scanned = true;
+        CHECK_EQ(loadKeyframeIndex(paths[size_t(r)], index, &scanned), kNoError);
+        CHECK(!scanned);
+        CHECK_EQ(index.entries.size(), 8u);
+        CHECK_EQ(index.entries[1].timestamp, 1000u);
+        CHECK_EQ(index.duration, 199u * 40);
+        removeRecording(paths[size_t(r)]);
+    }
+
+    RecordWriterStats stats = writer.stats();
+    CHECK_EQ(stats.framesQueued, 600u);
+    CHECK_EQ(stats.framesDropped, 0u);
+    CHECK_EQ(stats.bytesInFlight, 0u);
+    // One write per block, plus the last partial block of each file
+    CHECK(stats.writes <= stats.bytesWritten / 8192 + 3);
+    CHECK_EQ(writer.write(ids[0], frameInfo(0, 25), ConstByteSpan{nullptr, 0}), kErrNotFound);
+}
+
+void testMemoryBudget()
+{
+    RecordWriterConfig config;
+    config.blockSize = 4096;
+    config.maxBytesInFlight = 5000;
+    config.flushInterval = 0;
+    RecordWriter writer(config);
+    std::string path = temporaryPath("budget");
+    int id = writer.open(path);
+    std::vector<uint8_t> data(1000, 7);
+    ConstByteSpan frame{data.data(), data.size()};
+
+    // 4 records of 1016 bytes stay in the partial block, the 5th does not fit
+    for (uint32_t i = 0; i < 4; i++) {
+        CHECK_EQ(writer.write(id, frameInfo(i, 10), frame), kNoError);
+    }
+    CHECK_EQ(writer.stats().bytesInFlight, 4064u);
+    CHECK_EQ(writer.write(id, frameInfo(4, 10), frame), kErrMemoryBudget);
+
+    // The refusal writes the partial block, then there is room but the recording waits for the next keyframe
+    for (int i = 0; i < 100 && writer.stats().bytesInFlight > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK_EQ(writer.stats().bytesInFlight, 0u);
+    CHECK_EQ(writer.write(id, frameInfo(5, 10), frame), kErrMemoryBudget);
+    CHECK_EQ(writer.write(id, frameInfo(10, 10), frame), kNoError);
+    CHECK_EQ(writer.write(id, frameInfo(11, 10), frame), kNoError);
+
+    RecordWriterStats stats = writer.stats();
+    CHECK_EQ(stats.framesDropped, 2u);
+    CHECK_EQ(stats.framesQueued, 6u);
+    CHECK(stats.peakBytesInFlight <= config.maxBytesInFlight);
+    CHECK_EQ(writer.close(id), kNoError);
+
+    struct stat status;
+    CHECK_EQ(stat(path.c_str(), &status), 0);
+    CHECK_EQ(status.st_size, 6 * 1016);
+    removeRecording(path);
+}
+
+void testBudgetOfPartialBlocks()
+{
+    // The partial blocks of 8 recordings are larger than the budget, nothing but the budget writes them
+    RecordWriterConfig config;
+    config.maxBytesInFlight = 1024 * 1024;
+    config.flushInterval = 0;
+    RecordWriter writer(config);
+    std::vector<std::string> paths;
+    std::vector<int> ids;
+    for (int r = 0; r < 8; r++) {
+        paths.push_back(temporaryPath(("partial" + std::to_string(r)).c_str()));
+        ids.push_back(writer.open(paths.back()));
+    }
+    std::vector<uint8_t> data(60000, 5);
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < 200; i++) {
+        for (int id : ids) {
+            written += writer.write(id, frameInfo(i, 10), ConstByteSpan{data.data(), data.size()}) == kNoError;
+        }
+        // A camera sends a frame every 40 ms, the disk has the time to catch up
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(written > 0);
+
+    // However far the disk is behind, every refusal makes room and each recording gets its next keyframe in
+    for (int id : ids) {
+        int ret = kErrMemoryBudget;
+        for (int i = 0; i < 500 && ret == kErrMemoryBudget; i++) {
+            ret = writer.write(id, frameInfo(200, 10), ConstByteSpan{data.data(), data.size()});
+            if (ret == kErrMemoryBudget) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        CHECK_EQ(ret, kNoError);
+    }
+    RecordWriterStats stats = writer.stats();
+    CHECK(stats.bytesWritten > 0);
+    CHECK(stats.peakBytesInFlight <= config.maxBytesInFlight);
+    for (size_t r = 0; r < ids.size(); r++) {
+        CHECK_EQ(writer.close(ids[r]), kNoError);
+        removeRecording(paths[r]);
+    }
+}
+
+void testFlushInterval()
+{
+    RecordWriterConfig config;
+    config.flushInterval = 50;
+    RecordWriter writer(config);
+    std::string path = temporaryPath("interval");
+    int id = writer.open(path);
+    std::vector<uint8_t> data(100, 1);
+    writer.write(id, frameInfo(0, 10), ConstByteSpan{data.data(), data.size()});
+
+    // A partial block reaches the file without flush or close
+    struct stat status{};
+    for (int i = 0; i < 100 && status.st_size == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        stat(path.c_str(), &status);
+    }
+    CHECK_EQ(status.st_size, 116);
+    CHECK_EQ(writer.close(id), kNoError);
+    removeRecording(path);
+}
+
+void testPwriteFallback()
+{
+    RecordWriterConfig config;
+    config.useIoUring = false;
+    config.blockSize = 4096;
+    RecordWriter writer(config);
+    CHECK(!writer.stats().ioUring);
+    std::string path = temporaryPath("pwrite");
+    int id = writer.open(path);
+    for (uint32_t i = 0; i < 50; i++) {
+        std::vector<uint8_t> data = frameData(i, 3);
+        writer.write(id, frameInfo(i, 10), ConstByteSpan{data.data(), data.size()});
+    }
+    CHECK_EQ(writer.close(id), kNoError);
+    CHECK(verifyFile(path, 50, 3));
+    removeRecording(path);
+
+    CHECK_EQ(writer.open("/nonexistent/directory/file"), kErrIO);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testInterleavedRecordings);
+    RUN_TEST(testMemoryBudget);
+    RUN_TEST(testBudgetOfPartialBlocks);
+    RUN_TEST(testFlushInterval);
+    RUN_TEST(testPwriteFallback);
+    return TEST_RESULT();
+}
@@ -0,0 +1,151 @@
+//
+//  SessionMemoryTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "CameraCore/SessionMemory.h"
+#include "TestSupport.h"
+
+using namespace cam;
+
+namespace {
+
+// 1 KiB chunks hold four blocks of 256 bytes, header included
+constexpr size_t kChunk = 1024;
+constexpr size_t kBlock = 256 - 16;
+
+void testReuse()
+{
+    SessionMemory memory(0, kChunk);
+    void *first = memory.allocate(kBlock);
+    CHECK(first != nullptr);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(first) % 16, 0u);
+    std::memset(first, 0xAB, kBlock);
+    memory.deallocate(first, kBlock);
+    // A released block is the next one of its size class
+    void *second = memory.allocate(kBlock - 100);
+    CHECK(second == first);
+
+    SessionMemoryStats stats = memory.stats();
+    CHECK_EQ(stats.reserved, kChunk);
+    CHECK_EQ(stats.used, 256u);
+    CHECK_EQ(stats.allocations, 2u);
+    memory.deallocate(second, kBlock - 100);
+    CHECK_EQ(memory.stats().used, 0u);
+}
+
+void testBudget()
+{
+    SessionMemory memory(2 * kChunk, kChunk);
+    std::vector<void *> blocks;
+    for (int i = 0; i < 8; i++) {
+        blocks.push_back(memory.allocate(kBlock));
+        CHECK(blocks.back() != nullptr);
+    }
+    // A third chunk exceeds the budget
+    CHECK(memory.allocate(kBlock) == nullptr);
+    CHECK(memory.allocate(64) == nullptr);
+    CHECK(memory.allocate(1000) == nullptr);
+    SessionMemoryStats stats = memory.stats();
+    CHECK_EQ(stats.refused, 3u);
+    CHECK_EQ(stats.reserved, 2 * kChunk);
+
+    // A large block needs the chunks released first, the unused ones are trimmed for it
+    for (void *block : blocks) {
+        memory.deallocate(block, kBlock);
+    }
+    void *large = memory.allocate(1500);
+    CHECK(large != nullptr);
+    stats = memory.stats();
+    CHECK_EQ(stats.trims, 2u);
+    CHECK_EQ(stats.reserved, 1500u + 16u);
+    CHECK_EQ(stats.peakReserved, 2 * kChunk);
+    memory.deallocate(large, 1500);
+    CHECK_EQ(memory.stats().reserved, 0u);
+
+    // A lower budget trims at once and refuses until enough is released
+    void *block = memory.allocate(kBlock);
+    memory.setBudget(kChunk / 2);
+    CHECK(memory.allocate(1000) == nullptr);
+    memory.deallocate(block, kBlock);
+    CHECK_EQ(memory.trim(), kChunk);
+    memory.setBudget(0);
+    large = memory.allocate(1000);
+    CHECK(large != nullptr);
+    memory.deallocate(large, 1000);
+}
+
+void testTrim()
+{
+    SessionMemory memory(0, kChunk);
+    std::vector<void *> blocks;
+    for (int i = 0; i < 8; i++) {
+        blocks.push_back(memory.allocate(kBlock));
+    }
+    CHECK_EQ(memory.stats().reserved, 2 * kChunk);
+    CHECK_EQ(memory.trim(), 0u);
+
+    // The first chunk is unused, its blocks leave the free list with it
+    for (int i = 0; i < 4; i++) {
+        memory.deallocate(blocks[i], kBlock);
+    }
+    memory.deallocate(blocks[4], kBlock);
+    CHECK_EQ(memory.trim(), kChunk);
+    CHECK_EQ(memory.stats().reserved, kChunk);
+    void *reused = memory.allocate(kBlock);
+    CHECK(reused == blocks[4]);
+    // The second chunk is full, the next block comes from a new one
+    void *next = memory.allocate(kBlock);
+    CHECK(next != nullptr);
+    CHECK_EQ(memory.stats().reserved, 2 * kChunk);
+    std::memset(next, 0, kBlock);
+}
+
+void testContainers()
+{
+    auto memory = std::make_shared<SessionMemory>(kChunk, kChunk);
+    std::weak_ptr<SessionMemory> weak = memory;
+    SessionBytes bytes{SessionAllocator<uint8_t>(memory)};
+    std::vector<uint8_t> data(200, 7);
+    CHECK(assignSessionBytes(bytes, data.data(), data.size()));
+    CHECK(bytes.size() == 200 && bytes[199] == 7);
+    CHECK_EQ(memory->stats().used, 256u);
+
+    // Over the budget the buffer is left empty
+    std::vector<uint8_t> large(2000, 1);
+    CHECK(!assignSessionBytes(bytes, large.data(), large.size()));
+    CHECK(bytes.empty());
+    CHECK_EQ(memory->stats().used, 0u);
+
+    // The buffers keep the memory alive, it goes with the last of them
+    CHECK(assignSessionBytes(bytes, data.data(), data.size()));
+    memory.reset();
+    CHECK(!weak.expired());
+    SessionBytes moved = std::move(bytes);
+    CHECK(moved.size() == 200);
+    moved = SessionBytes();
+    CHECK(weak.expired());
+
+    // Without memory the heap is used
+    SessionBytes heap;
+    CHECK(assignSessionBytes(heap, large.data(), large.size()));
+    CHECK(heap.size() == 2000);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testReuse);
+    RUN_TEST(testBudget);
+    RUN_TEST(testTrim);
+    RUN_TEST(testContainers);
+    return TEST_RESULT();
+}
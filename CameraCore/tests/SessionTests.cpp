@@ -0,0 +1,317 @@
+//
+//  SessionTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/Session.h"
+#include "CameraCore/SimulatedDevice.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+/// Decodes every frame to a gray 64 x 36 picture
+class GrayDecoder : public VideoDecoder
+{
+public:
+    int decode(uint16_t, ConstByteSpan, Nv12Picture &picture) override
+    {
+        picture = Nv12Picture{64, 36, y_.data(), 64, uv_.data(), 64, true};
+        return kNoError;
+    }
+
+private:
+    std::vector<uint8_t> y_ = std::vector<uint8_t>(64 * 36, 100);
+    std::vector<uint8_t> uv_ = std::vector<uint8_t>(64 * 18, 128);
+};
+
+SimulatorConfig nvrConfig()
+{
+    SimulatorConfig config;
+    config.channels = 4;
+    config.fps = 100;
+    config.gop = 5;
+    config.keyframeSize = 2000;
+    config.frameSize = 200;
+    return config;
+}
+
+int startStream(Session &session, int avIndex)
+{
+    auto request = StartStream::encodeRequest(SMsgAVIoctrlAVStream{uint32_t(session.cameraChannel(avIndex))});
+    return session.transport().sendIOCtrl(avIndex, StartStream::requestType, ConstByteSpan{request.data(), request.size()});
+}
+
+void testChannels()
+{
+    // The pool outlives the channels decoded on it
+    DecodePoolConfig poolConfig;
+    poolConfig.threads = 1;
+    DecodePool pool(poolConfig);
+    SimulatedDevice device(nvrConfig());
+    int error = 0;
+    std::unique_ptr<Session> session = Session::connect(device, device.config().uid, SessionConfig(), 1000, &error);
+    CHECK(session != nullptr);
+
+    // Four channels, one connect
+    std::vector<int> avIndexes;
+    std::vector<std::shared_ptr<FrameSubscription>> subscriptions;
+    for (int channel = 0; channel < 4; channel++) {
+        ChannelConfig config;
+        if (channel == 3) {
+            config.pool = &pool;
+            config.decoder = std::make_unique<GrayDecoder>();
+        }
+        int avIndex = session->openChannel(channel, std::move(config));
+        CHECK(avIndex >= 0);
+        avIndexes.push_back(avIndex);
+        subscriptions.push_back(session->hub(avIndex)->subscribe(SubscriptionConfig{64, DropPolicy::Newest}));
+        CHECK_EQ(startStream(*session, avIndex), kNoError);
+    }
+    CHECK_EQ(device.sessionCount(), 1u);
+    CHECK(session->openChannels() == avIndexes);
+    CHECK_EQ(session->openChannel(2), kErrInvalidArg);
+    CHECK_EQ(session->openChannel(0, ChannelConfig{&pool, nullptr}), kErrInvalidArg);
+
+    // Every channel receives its own stream at the same time, the readers keep up with all of them.
+    // The pool may skip frames, the frame numbers only go up
+    std::vector<std::vector<FramePtr>> received(4);
+    std::vector<std::thread> readers;
+    for (size_t channel = 0; channel < 4; channel++) {
+        readers.emplace_back([&, channel] {
+            for (int i = 0; i < 10; i++) {
+                FramePtr frame = subscriptions[channel]->next(2000);
+                if (!frame) {
+                    return;
+                }
+                received[channel].push_back(frame);
+            }
+        });
+    }
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    for (int channel = 0; channel < 4; channel++) {
+        const std::vector<FramePtr> &frames = received[size_t(channel)];
+        CHECK_EQ(frames.size(), 10u);
+        for (size_t i = 0; i < frames.size(); i++) {
+            CHECK_EQ(frames[i]->avIndex, avIndexes[size_t(channel)]);
+            CHECK_EQ(int(frames[i]->info.channel), channel);
+            CHECK(i == 0 ? frames[i]->info.isKeyframe() : frames[i]->info.frameNumber > frames[i - 1]->info.frameNumber);
+            CHECK_EQ(frames[i]->picture != nullptr, channel == 3);
+        }
+    }
+    SessionSnapshot snapshot = session->metrics().snapshot();
+    CHECK_EQ(snapshot.channels.size(), 4u);
+    for (const ChannelSnapshot &channel : snapshot.channels) {
+        CHECK(channel.framesReceived >= 10);
+    }
+    CHECK(session->memory()->stats().used > 0);
+
+    // The IO control reader of a channel is started once, closing the channel stops it
+    IoctrlChannel *control = session->ioctrl(avIndexes[1]);
+    CHECK(control != nullptr && control == session->ioctrl(avIndexes[1]));
+    CHECK_EQ(control->avIndex(), avIndexes[1]);
+
+    // Closing one channel leaves the others running
+    CHECK_EQ(session->closeChannel(avIndexes[1]), kNoError);
+    CHECK_EQ(session->closeChannel(avIndexes[1]), kErrNotFound);
+    CHECK(session->hub(avIndexes[1]) == nullptr);
+    CHECK(session->ioctrl(avIndexes[1]) == nullptr);
+    CHECK_EQ(session->openChannels().size(), 3u);
+    CHECK_EQ(session->metrics().snapshot().channels.size(), 3u);
+    FramePtr next = subscriptions[2]->next(2000);
+    CHECK(next != nullptr && next->info.frameNumber >= 10);
+    CHECK_EQ(session->channelError(avIndexes[2]), kNoError);
+}
+
+void testMemoryBudget()
+{
+    SimulatorConfig simulatorConfig = nvrConfig();
+    simulatorConfig.keyframeSize = 60000;
+    simulatorConfig.frameSize = 20000;
+    SimulatedDevice device(simulatorConfig);
+    int error = 0;
+    SessionConfig config;
+    config.memoryBudget = 1536 * 1024;
+    std::unique_ptr<Session> session = Session::connect(device, device.config().uid, config, 1000, &error);
+
+    // The receive buffer of the second channel does not fit
+    ChannelConfig first;
+    first.maxFrameSize = 200 * 1024;
+    int avIndex = session->openChannel(0, std::move(first));
+    ChannelConfig second;
+    second.maxFrameSize = 2 * 1024 * 1024;
+    int other = session->openChannel(1, std::move(second));
+    CHECK(avIndex >= 0 && other >= 0);
+    for (int i = 0; i < 100 && session->channelError(other) == kNoError; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK_EQ(session->channelError(other), kErrMemoryBudget);
+    CHECK_EQ(session->channelError(avIndex), kNoError);
+
+    // The frames a consumer keeps fill one chunk, the budget has no room for a second one
+    auto subscription = session->hub(avIndex)->subscribe(SubscriptionConfig{1000, DropPolicy::Oldest});
+    CHECK_EQ(startStream(*session, avIndex), kNoError);
+    ChannelMetrics &metrics = *session->metrics().channel(avIndex);
+    for (int i = 0; i < 300 && metrics.snapshot().framesDropped == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(metrics.snapshot().framesDropped > 0);
+    CHECK(session->memory()->stats().reserved <= config.memoryBudget);
+    CHECK(session->memory()->stats().refused > 0);
+}
+
+/// Sends frames 0 to 6 on a channel after any IO control on it, a keyframe every 5 frames and frame 2
+/// larger than any receive buffer
+class ScriptedTransport : public Transport
+{
+public:
+    std::atomic<int> opened{0};
+
+    int openChannel(int, const std::string &, const std::string &) override
+    {
+        // As slow as a real AV client start
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return opened++;
+    }
+    void closeChannel(int) override {}
+    int sendIOCtrl(int avIndex, uint32_t, ConstByteSpan) override
+    {
+        started_[size_t(avIndex)] = true;
+        return kNoError;
+    }
+    int recvIOCtrl(int, uint32_t *, ByteSpan, int) override { return kErrTimeout; }
+
+    int recvFrame(int avIndex, ByteSpan buffer, FrameInfo *info, int timeoutMs) override
+    {
+        uint32_t &frameNumber = next_[size_t(avIndex)];
+        if (!started_[size_t(avIndex)] || frameNumber > 6) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            return kErrTimeout;
+        }
+        *info = FrameInfo();
+        info->codecId = kCodecH264;
+        info->flags = frameNumber % 5 == 0 ? kFrameFlagKeyframe : 0;
+        info->frameNumber = frameNumber++;
+        if (info->frameNumber == 2) {
+            return kErrBufferTooSmall;
+        }
+        std::memset(buffer.data, 0, 100);
+        return 100;
+    }
+
+    PathType pathType() const override { return PathType::LAN; }
+
+private:
+    std::array<std::atomic<bool>, 8> started_{};
+    std::array<uint32_t, 8> next_{};
+};
+
+void testKeyframeAfterDrop()
+{
+    DecodePool pool;
+    SessionConfig config;
+    Session session(std::unique_ptr<Transport>(new ScriptedTransport), config);
+
+    // The frames that reference the dropped one wait for the next keyframe, decoded or not
+    ChannelConfig decoded;
+    decoded.pool = &pool;
+    decoded.decoder = std::make_unique<GrayDecoder>();
+    std::vector<int> avIndexes = {session.openChannel(0, std::move(decoded)), session.openChannel(1)};
+    for (int avIndex : avIndexes) {
+        std::vector<uint32_t> frameNumbers;
+        auto subscription = session.hub(avIndex)->subscribe(SubscriptionConfig{64, DropPolicy::Newest});
+        CHECK_EQ(startStream(session, avIndex), kNoError);
+        while (FramePtr frame = subscription->next(500)) {
+            frameNumbers.push_back(frame->info.frameNumber);
+        }
+        CHECK(frameNumbers == std::vector<uint32_t>({0, 1, 5, 6}));
+        CHECK_EQ(session.metrics().channel(avIndex)->snapshot().framesDropped, 3u);
+    }
+}
+
+void testConcurrentOpen()
+{
+    auto transport = std::make_unique<ScriptedTransport>();
+    ScriptedTransport &scripted = *transport;
+    Session session(std::move(transport), SessionConfig());
+    std::atomic<int> opened{0};
+    std::atomic<int> refused{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2; i++) {
+        threads.emplace_back([&] {
+            int avIndex = session.openChannel(0);
+            (avIndex >= 0 ? opened : refused)++;
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    // The camera channel was opened once
+    CHECK_EQ(opened.load(), 1);
+    CHECK_EQ(refused.load(), 1);
+    CHECK_EQ(scripted.opened.load(), 1);
+}
+
+void testFrameTrace()
+{
+    DecodePoolConfig poolConfig;
+    poolConfig.threads = 1;
+    DecodePool pool(poolConfig);
+    SimulatedDevice device(nvrConfig());
+    FrameTrace trace(4096);
+    SessionConfig config;
+    config.trace = &trace;
+    int error = 0;
+    std::unique_ptr<Session> session = Session::connect(device, device.config().uid, config, 1000, &error);
+
+    // One channel decoded on the pool, one publishing the encoded frames
+    ChannelConfig decoded;
+    decoded.pool = &pool;
+    decoded.decoder = std::make_unique<GrayDecoder>();
+    std::vector<int> avIndexes = {session->openChannel(0, std::move(decoded)), session->openChannel(1)};
+    for (int avIndex : avIndexes) {
+        auto subscription = session->hub(avIndex)->subscribe(SubscriptionConfig{64, DropPolicy::Oldest});
+        CHECK_EQ(startStream(*session, avIndex), kNoError);
+        CHECK(subscription->next(2000) != nullptr);
+        CHECK_EQ(session->closeChannel(avIndex), kNoError);
+    }
+
+    // Both paths trace their frames up to the publish
+    std::vector<TraceEvent> events = trace.events();
+    for (int avIndex : avIndexes) {
+        bool received = false, delivered = false;
+        for (const TraceEvent &event : events) {
+            received = received || (event.avIndex == avIndex && event.stage == TraceStage::Received);
+            delivered = delivered || (event.avIndex == avIndex && event.stage == TraceStage::Delivered);
+        }
+        CHECK_EQ(received, FrameTrace::enabled);
+        CHECK_EQ(delivered, FrameTrace::enabled);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testChannels);
+    RUN_TEST(testMemoryBudget);
+    RUN_TEST(testKeyframeAfterDrop);
+    RUN_TEST(testConcurrentOpen);
+    RUN_TEST(testFrameTrace);
+    return TEST_RESULT();
+}
@@ -0,0 +1,291 @@
+//
+//  SimulatedDeviceTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Clock.h"
+#include "CameraCore/Error.h"
+#include "CameraCore/FrameFile.h"
+#include "CameraCore/KeyframeIndex.h"
+#include "CameraCore/PlaybackControl.h"
+#include "CameraCore/SimulatedDevice.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+const STimeDay kRecordTime{2026, 10, 19, 1, 8, 0, 0};
+
+int startStream(Transport &transport, int avIndex, uint32_t type = IOTYPE_USER_IPCAM_START)
+{
+    auto bytes = SMsgAVIoctrlAVStreamCodec::encode(SMsgAVIoctrlAVStream{0});
+    return transport.sendIOCtrl(avIndex, type, ConstByteSpan{bytes.data(), bytes.size()});
+}
+
+void testConnect()
+{
+    SimulatorConfig config;
+    config.delay = 5;
+    SimulatedDevice device(config);
+
+    int error = 0;
+    CHECK(!device.connect("OTHER", 1000, &error));
+    CHECK_EQ(error, kErrNotFound);
+    CHECK(!device.connect(config.uid, 5, &error));
+    CHECK_EQ(error, kErrTimeout);
+
+    uint64_t start = monotonicMicros();
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 1000, &error);
+    CHECK(transport != nullptr);
+    CHECK(monotonicMicros() - start >= 10000);
+    CHECK(transport->pathType() == PathType::LAN);
+    CHECK_EQ(transport->openChannel(0, "admin", "wrong"), kErrRejected);
+    CHECK_EQ(transport->openChannel(1, "admin", "admin"), kErrInvalidArg);
+    CHECK_EQ(device.sessionCount(), 1u);
+}
+
+void testLiveView()
+{
+    SimulatorConfig config;
+    config.fps = 100;
+    config.gop = 5;
+    config.keyframeSize = 1000;
+    config.frameSize = 100;
+    SimulatedDevice device(config);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+    CHECK(avIndex >= 0);
+
+    std::vector<uint8_t> buffer(2000);
+    FrameInfo info;
+    CHECK_EQ(transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 20), kErrTimeout);
+
+    CHECK_EQ(startStream(*transport, avIndex), kNoError);
+    for (uint32_t i = 0; i < 10; i++) {
+        int size = transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 1000);
+        CHECK_EQ(info.frameNumber, i);
+        CHECK_EQ(info.isKeyframe(), i % 5 == 0);
+        CHECK_EQ(size, i % 5 == 0 ? 1000 : 100);
+        CHECK_EQ(info.codecId, kCodecH264);
+        // Annex B with the NAL type of an IDR or a reference P frame
+        CHECK(buffer[0] == 0 && buffer[1] == 0 && buffer[2] == 0 && buffer[3] == 1);
+        CHECK_EQ(buffer[4], info.isKeyframe() ? 0x65 : 0x41);
+    }
+    // A frame too large for the buffer is dropped, the next call gets the next frame
+    CHECK_EQ(transport->recvFrame(avIndex, ByteSpan{buffer.data(), 10}, &info, 1000), kErrBufferTooSmall);
+    CHECK_EQ(info.frameNumber, 10u);
+    CHECK(transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 1000) > 0);
+    CHECK_EQ(info.frameNumber, 11u);
+
+    // Quality changes the size of the following frames
+    auto quality = SetStreamCtrl::encodeRequest(SMsgAVIoctrlStreamCtrl{0, AVIOCTRL_QUALITY_MIDDLE});
+    CHECK_EQ(transport->sendIOCtrl(avIndex, SetStreamCtrl::requestType, ConstByteSpan{quality.data(), quality.size()}), kNoError);
+    uint8_t reply[kMaxIoctrlSize];
+    uint32_t type = 0;
+    CHECK_EQ(transport->recvIOCtrl(avIndex, &type, ByteSpan{reply, sizeof(reply)}, 1000), 8);
+    CHECK_EQ(type, SetStreamCtrl::responseType);
+    CHECK_EQ(device.quality(0), AVIOCTRL_QUALITY_MIDDLE);
+    transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 1000);
+    int size = transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 1000);
+    CHECK_EQ(size, info.isKeyframe() ? 500 : 50);
+
+    CHECK_EQ(startStream(*transport, avIndex, IOTYPE_USER_IPCAM_STOP), kNoError);
+    CHECK_EQ(transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 30), kErrTimeout);
+
+    transport->closeChannel(avIndex);
+    CHECK_EQ(transport->recvFrame(avIndex, ByteSpan{buffer.data(), buffer.size()}, &info, 30), kErrClosed);
+}
+
+void testLoss()
+{
+    SimulatorConfig config;
+    config.fps = 1000;
+    config.keyframeSize = 100;
+    config.frameSize = 100;
+    config.lossRate = 0.2;
+    SimulatedDevice device(config);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+    startStream(*transport, avIndex);
+
+    uint8_t buffer[100];
+    FrameInfo info;
+    uint32_t gaps = 0;
+    uint32_t next = 0;
+    for (int i = 0; i < 200; i++) {
+        CHECK_EQ(transport->recvFrame(avIndex, ByteSpan{buffer, sizeof(buffer)}, &info, 1000), 100);
+        gaps += info.frameNumber - next;
+        next = info.frameNumber + 1;
+    }
+    CHECK_EQ(uint64_t(gaps), device.framesLost());
+    CHECK_EQ(device.framesSent(), 200u);
+    CHECK(gaps > 10 && gaps < 100);
+}
+
+void testEventListAndReport()
+{
+    SimulatorConfig config;
+    for (int i = 0; i < 100; i++) {
+        SimulatedRecording recording;
+        recording.time = STimeDay{2026, 10, 19, 1, uint8_t(i / 60), uint8_t(i % 60), 0};
+        recording.event = i % 2 ? 1 : 2;
+        config.recordings.push_back(recording);
+    }
+    SimulatedDevice device(config);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+
+    SMsgAVIoctrlListEventReq request{0, STimeDay{2026, 10, 19, 0, 0, 0, 0}, STimeDay{2026, 10, 20, 0, 0, 0, 0}, 0, 0};
+    auto bytes = ListEvent::encodeRequest(request);
+    CHECK_EQ(transport->sendIOCtrl(avIndex, ListEvent::requestType, ConstByteSpan{bytes.data(), bytes.size()}), kNoError);
+    size_t events = 0;
+    for (int reply = 0; reply < 2; reply++) {
+        uint8_t data[kMaxIoctrlSize];
+        uint32_t type = 0;
+        int size = transport->recvIOCtrl(avIndex, &type, ByteSpan{data, sizeof(data)}, 1000);
+        SMsgAVIoctrlListEventResp header;
+        CHECK(type == ListEvent::responseType && ListEvent::decodeResponse(ConstByteSpan{data, size_t(size)}, header));
+        CHECK_EQ(header.total, 2u);
+        CHECK_EQ(header.index, reply);
+        CHECK_EQ(header.endflag, reply == 1 ? 1 : 0);
+        events += header.count;
+    }
+    CHECK_EQ(events, 100u);
+
+    device.reportEvent(0, 1);
+    uint8_t data[kMaxIoctrlSize];
+    uint32_t type = 0;
+    int size = transport->recvIOCtrl(avIndex, &type, ByteSpan{data, sizeof(data)}, 1000);
+    SMsgAVIoctrlEvent event;
+    CHECK(type == IOTYPE_USER_IPCAM_EVENT_REPORT && SMsgAVIoctrlEventCodec::decode(ConstByteSpan{data, size_t(size)}, event));
+    CHECK_EQ(event.event, 1u);
+}
+
+std::string writeRecording()
+{
+    // 40 frames at 20 fps, a keyframe every 10 frames
+    char path[] = "/tmp/camcore-sim-XXXXXX";
+    int fd = mkstemp(path);
+    FILE *file = fdopen(fd, "wb");
+    for (uint32_t i = 0; i < 40; i++) {
+        FrameInfo info;
+        info.codecId = kCodecH264;
+        info.flags = i % 10 == 0 ? kFrameFlagKeyframe : 0;
+        info.timestamp = 7000 + i * 50;
+        auto header = FrameRecordHeaderCodec::encode(makeFrameRecordHeader(info, 64));
+        std::fwrite(header.data(), header.size(), 1, file);
+        std::vector<uint8_t> body(64, uint8_t(i));
+        std::fwrite(body.data(), body.size(), 1, file);
+    }
+    std::fclose(file);
+    return path;
+}
+
+void testPlayback()
+{
+    std::string path = writeRecording();
+    SimulatorConfig config;
+    SimulatedRecording recording;
+    recording.time = kRecordTime;
+    recording.path = path;
+    config.recordings.push_back(recording);
+    config.pacedPlayback = false;
+    SimulatedDevice device(config);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+
+    IoctrlChannel control(*transport, avIndex);
+    PlaybackControl playback(control, 0, "admin", "admin");
+    CHECK_EQ(playback.start(STimeDay{2026, 1, 1, 1, 0, 0, 0}, 1000), kErrRejected);
+    CHECK(playback.start(kRecordTime, 1000) >= 0);
+
+    uint8_t buffer[256];
+    FrameInfo info;
+    CHECK_EQ(playback.recvFrame(ByteSpan{buffer, sizeof(buffer)}, &info, 1000), 64);
+    CHECK_EQ(info.timestamp, 7000u);
+    CHECK_EQ(buffer[0], 0);
+
+    // Seek to 1.2 s continues with the keyframe at 1 s
+    CHECK_EQ(playback.seek(1200, 1000), kNoError);
+    CHECK_EQ(playback.recvFrame(ByteSpan{buffer, sizeof(buffer)}, &info, 1000), 64);
+    CHECK(info.isKeyframe());
+    CHECK_EQ(info.timestamp, 8000u);
+    CHECK_EQ(buffer[0], 20);
+
+    int frames = 1;
+    while (playback.recvFrame(ByteSpan{buffer, sizeof(buffer)}, &info, 100) >= 0) {
+        frames++;
+    }
+    CHECK_EQ(frames, 20);
+    // PLAY_END was sent on the control channel when the recording ran out, no command waits for it
+    for (int i = 0; i < 100 && !playback.ended(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(playback.ended());
+    CHECK_EQ(playback.stop(1000), kNoError);
+    unlink(path.c_str());
+    unlink(KeyframeIndex::indexPath(path).c_str());
+}
+
+void testPacedPlayback()
+{
+    SimulatorConfig config;
+    config.fps = 50;
+    config.gop = 10;
+    config.keyframeSize = 100;
+    config.frameSize = 100;
+    SimulatedRecording recording;
+    recording.time = kRecordTime;
+    recording.duration = 400;
+    config.recordings.push_back(recording);
+    SimulatedDevice device(config);
+    int error = 0;
+    std::unique_ptr<Transport> transport = device.connect(config.uid, 1000, &error);
+    int avIndex = transport->openChannel(0, "admin", "admin");
+
+    IoctrlChannel control(*transport, avIndex);
+    PlaybackControl playback(control, 0, "admin", "admin");
+    CHECK(playback.start(kRecordTime, 1000) >= 0);
+    CHECK_EQ(playback.setSpeed(4, 1000), kNoError);
+    uint64_t start = monotonicMicros();
+    uint8_t buffer[128];
+    FrameInfo info;
+    int keyframes = 0;
+    while (playback.recvFrame(ByteSpan{buffer, sizeof(buffer)}, &info, 200) >= 0) {
+        keyframes++;
+    }
+    uint64_t elapsed = monotonicMicros() - start;
+    // 400 ms at 4x is about 100 ms, only keyframes are delivered above 1x
+    CHECK(keyframes >= 2 && keyframes <= 3);
+    CHECK(elapsed >= 60000 && elapsed < 600000);
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testConnect);
+    RUN_TEST(testLiveView);
+    RUN_TEST(testLoss);
+    RUN_TEST(testEventListAndReport);
+    RUN_TEST(testPlayback);
+    RUN_TEST(testPacedPlayback);
+    return TEST_RESULT();
+}
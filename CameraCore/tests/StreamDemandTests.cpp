@@ -0,0 +1,158 @@
+//
+//  StreamDemandTests.cpp
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CameraCore/Error.h"
+#include "CameraCore/IoctrlMessages.h"
+#include "CameraCore/StreamDemand.h"
+#include "TestSupport.h"
+
+using namespace cam;
+using namespace cam::ioctrl;
+
+namespace {
+
+/// Logs the IO controls sent, fails them while failing is set
+class CommandTransport : public Transport
+{
+public:
+    int openChannel(int channel, const std::string &, const std::string &) override { return channel; }
+    void closeChannel(int) override {}
+
+    int sendIOCtrl(int avIndex, uint32_t type, ConstByteSpan data) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failing) {
+            return kErrTimeout;
+        }
+        SMsgAVIoctrlAVStream request;
+        CHECK(SMsgAVIoctrlAVStreamCodec::decode(data, request));
+        CHECK_EQ(request.channel, 2u);
+        CHECK_EQ(avIndex, 5);
+        commands_.push_back(type);
+        return kNoError;
+    }
+
+    int recvIOCtrl(int, uint32_t *, ByteSpan, int) override { return kErrTimeout; }
+    int recvFrame(int, ByteSpan, FrameInfo *, int) override { return kErrTimeout; }
+    PathType pathType() const override { return PathType::LAN; }
+
+    std::vector<uint32_t> commands() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return commands_;
+    }
+
+    std::atomic<bool> failing{false};
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<uint32_t> commands_;
+};
+
+void sleepMs(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void testReferenceCount()
+{
+    CommandTransport transport;
+    StreamDemand demand(transport, 5, 2, 100);
+    StreamDemand::Token preview, recorder;
+    CHECK_EQ(demand.acquire(StreamKind::Video, preview), kNoError);
+    CHECK_EQ(demand.acquire(StreamKind::Video, recorder), kNoError);
+    CHECK(preview.valid() && recorder.valid());
+    CHECK_EQ(demand.consumerCount(StreamKind::Video), 2);
+    // One START for both consumers
+    CHECK(transport.commands() == std::vector<uint32_t>{IOTYPE_USER_IPCAM_START});
+
+    preview.release();
+    sleepMs(200);
+    CHECK(demand.isStreaming(StreamKind::Video));
+    CHECK_EQ(transport.commands().size(), 1u);
+
+    {
+        StreamDemand::Token moved = std::move(recorder);
+        CHECK(!recorder.valid());
+        CHECK_EQ(demand.consumerCount(StreamKind::Video), 1);
+    }
+    CHECK_EQ(demand.consumerCount(StreamKind::Video), 0);
+    CHECK(demand.isStreaming(StreamKind::Video));
+    sleepMs(250);
+    CHECK(!demand.isStreaming(StreamKind::Video));
+    CHECK((transport.commands() == std::vector<uint32_t>{IOTYPE_USER_IPCAM_START, IOTYPE_USER_IPCAM_STOP}));
+}
+
+void testGracePeriod()
+{
+    CommandTransport transport;
+    StreamDemand demand(transport, 5, 2, 300);
+    StreamDemand::Token token;
+    demand.acquire(StreamKind::Video, token);
+    demand.acquire(StreamKind::Audio, token);       // Releases the video token
+    CHECK_EQ(demand.consumerCount(StreamKind::Video), 0);
+
+    // Back within the grace period, nothing is sent
+    sleepMs(100);
+    StreamDemand::Token video;
+    demand.acquire(StreamKind::Video, video);
+    sleepMs(400);
+    CHECK(demand.isStreaming(StreamKind::Video));
+    CHECK((transport.commands() == std::vector<uint32_t>{IOTYPE_USER_IPCAM_START, IOTYPE_USER_IPCAM_AUDIOSTART}));
+
+    // Audio stopped after its grace period, video keeps running
+    token.release();
+    sleepMs(500);
+    CHECK(!demand.isStreaming(StreamKind::Audio));
+    CHECK(demand.isStreaming(StreamKind::Video));
+    CHECK_EQ(transport.commands().back(), uint32_t(IOTYPE_USER_IPCAM_AUDIOSTOP));
+
+    // Starting again after the stop sends START again
+    video.release();
+    sleepMs(500);
+    demand.acquire(StreamKind::Video, video);
+    CHECK((transport.commands() == std::vector<uint32_t>{IOTYPE_USER_IPCAM_START, IOTYPE_USER_IPCAM_AUDIOSTART,
+                                                         IOTYPE_USER_IPCAM_AUDIOSTOP, IOTYPE_USER_IPCAM_STOP,
+                                                         IOTYPE_USER_IPCAM_START}));
+    video.release();
+}
+
+void testStartFailureAndDestruction()
+{
+    CommandTransport transport;
+    {
+        StreamDemand demand(transport, 5, 2, 60000);
+        transport.failing = true;
+        StreamDemand::Token token;
+        CHECK_EQ(demand.acquire(StreamKind::Video, token), kErrTimeout);
+        CHECK(!token.valid());
+        CHECK_EQ(demand.consumerCount(StreamKind::Video), 0);
+        CHECK(!demand.isStreaming(StreamKind::Video));
+
+        transport.failing = false;
+        CHECK_EQ(demand.acquire(StreamKind::Video, token), kNoError);
+        token.release();
+    }
+    // Destroyed during the grace period, the stream is stopped right away
+    CHECK((transport.commands() == std::vector<uint32_t>{IOTYPE_USER_IPCAM_START, IOTYPE_USER_IPCAM_STOP}));
+}
+
+} // namespace
+
+int main()
+{
+    RUN_TEST(testReferenceCount);
+    RUN_TEST(testGracePeriod);
+    RUN_TEST(testStartFailureAndDestruction);
+    return TEST_RESULT();
+}
@@ -0,0 +1,35 @@
+//
+//  TestSupport.h
+//  CameraCore
+//
+//  Created by agent on 2026/10/19.
+//  Copyright © 2019 Askey. All rights reserved.
+//
+
+#ifndef CameraCore_TestSupport_h
+#define CameraCore_TestSupport_h
+
+#include <cstdio>
+#include <cstdlib>
+
+static int gTestFailures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            gTestFailures++;                                                              \
+        }                                                                                 \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+#define RUN_TEST(test)                          \
+    do {                                        \
+        std::printf("[ RUN  ] %s\n", #test);    \
+        test();                                 \
+    } while (0)
+
+#define TEST_RESULT() (gTestFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif /* CameraCore_TestSupport_h */